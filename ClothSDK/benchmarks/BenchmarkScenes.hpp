@@ -0,0 +1,66 @@
+#pragma once
+
+#include "engine/ClothMesh.hpp"
+#include "io/OBJLoader.hpp"
+#include "physics/Solver.hpp"
+#include <string>
+#include <vector>
+#include <omp.h>
+
+// Scenes shared by the cloth_benchmarks suites. Benchmarks taking a thread count
+// run their timed loop inside a BenchmarkThreads scope.
+
+namespace ClothSDK {
+namespace Bench {
+
+/** @brief Sets the OpenMP thread count for the lifetime of the scope. */
+class BenchmarkThreads {
+public:
+    explicit BenchmarkThreads(int threads) : m_previous(omp_get_max_threads()) {
+        omp_set_num_threads(threads);
+    }
+    ~BenchmarkThreads() { omp_set_num_threads(m_previous); }
+
+    BenchmarkThreads(const BenchmarkThreads&) = delete;
+    BenchmarkThreads& operator=(const BenchmarkThreads&) = delete;
+
+private:
+    int m_previous;
+};
+
+/** @brief side x side grid hanging from its top row, stepped `warmupFrames` times so it folds. */
+inline void buildGridScene(Solver& solver, ClothMesh& mesh, int side, int warmupFrames = 0) {
+    mesh.initGrid(side, side, 0.1, solver);
+    for (int c = 0; c < side; ++c)
+        solver.setParticleInverseMass(mesh.getParticleID(side - 1, c), 0.0);
+    solver.addPlaneCollider(Vector3r(0, -0.05 * side, 0), Vector3r(0, 1, 0), 0.5);
+    solver.addSphereCollider(Vector3r(0.05 * side, 0.0, 0.05 * side), 0.02 * side, 0.2);
+    for (int frame = 0; frame < warmupFrames; ++frame)
+        solver.update(1.0 / 60.0);
+}
+
+/**
+ * @brief The Stanford bunny from data/models as a silk-like cloth pinned at its ears.
+ *
+ * @return False if the model cannot be loaded.
+ */
+inline bool buildBunnyScene(Solver& solver, ClothMesh& mesh) {
+    std::vector<Vector3r> positions;
+    std::vector<int> indices;
+    if (!OBJLoader::load(std::string(CLOTHSDK_DATA_DIR) + "/models/bunny.obj", positions, indices))
+        return false;
+
+    solver.setSubsteps(5);
+    solver.setIterations(2);
+    solver.setThickness(0.02);
+    mesh.setMaterial(0.1, 1e-9, 1e-8, 0.1);
+    mesh.buildFromMesh(positions, indices, solver);
+    for (size_t v = 0; v < positions.size(); ++v) {
+        if (positions[v].y() >= 0.15)
+            solver.setParticleInverseMass(mesh.getParticleIndices()[v], 0.0);
+    }
+    return true;
+}
+
+}
+}
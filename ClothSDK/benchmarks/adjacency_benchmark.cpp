@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+#include "physics/AdjacencyList.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+// Edges a grid cloth registers for self-collision filtering: structural and shear
+// distance constraints plus the wing pairs of every bending quad.
+std::vector<std::pair<int, int>> gridEdges(int side) {
+    std::vector<std::pair<int, int>> edges;
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int a = r * side + c;
+            if (c + 1 < side) edges.emplace_back(a, a + 1);
+            if (r + 1 < side) edges.emplace_back(a, a + side);
+            if (r + 1 < side && c + 1 < side) {
+                edges.emplace_back(a, a + side + 1);
+                edges.emplace_back(a + 1, a + side);
+                edges.emplace_back(a, a + 1);
+                edges.emplace_back(a + side + 1, a + 1);
+                edges.emplace_back(a, a + side);
+                edges.emplace_back(a + side + 1, a + side);
+            }
+        }
+    }
+    return edges;
+}
+
+// Candidate pairs shaped like spatial hash results: nearby particles in a 5x5
+// window, roughly a third of them topologically adjacent.
+std::vector<std::pair<int, int>> candidatePairs(int side, int count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> cell(0, side - 1);
+    std::uniform_int_distribution<int> offset(-2, 2);
+    std::vector<std::pair<int, int>> pairs;
+    pairs.reserve(count);
+    while (static_cast<int>(pairs.size()) < count) {
+        int r = cell(rng), c = cell(rng);
+        int r2 = std::clamp(r + offset(rng), 0, side - 1);
+        int c2 = std::clamp(c + offset(rng), 0, side - 1);
+        pairs.emplace_back(r * side + c, r2 * side + c2);
+    }
+    return pairs;
+}
+
+uint64_t pairKey(int a, int b) {
+    uint64_t low = static_cast<uint32_t>(std::min(a, b));
+    uint64_t high = static_cast<uint32_t>(std::max(a, b));
+    return (high << 32) | low;
+}
+
+void BM_AdjacencyHashSet(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    std::unordered_set<uint64_t> adjacency;
+    for (const auto& [a, b] : gridEdges(side))
+        adjacency.insert(pairKey(a, b));
+    auto queries = candidatePairs(side, 1 << 16);
+
+    for (auto _ : state) {
+        int hits = 0;
+        for (const auto& [a, b] : queries)
+            hits += static_cast<int>(adjacency.count(pairKey(a, b)));
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+void BM_AdjacencyCSR(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    AdjacencyList adjacency;
+    adjacency.build(side * side, gridEdges(side));
+    auto queries = candidatePairs(side, 1 << 16);
+
+    for (auto _ : state) {
+        int hits = 0;
+        for (const auto& [a, b] : queries)
+            hits += static_cast<int>(adjacency.contains(a, b));
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+void BM_AdjacencyCSRBuild(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    auto edges = gridEdges(side);
+    AdjacencyList adjacency;
+
+    for (auto _ : state) {
+        adjacency.build(side * side, edges);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+}
+
+BENCHMARK(BM_AdjacencyHashSet)->Arg(100)->Arg(316)->Arg(448);
+BENCHMARK(BM_AdjacencyCSR)->Arg(100)->Arg(316)->Arg(448);
+BENCHMARK(BM_AdjacencyCSRBuild)->Arg(100)->Arg(316)->Arg(448);
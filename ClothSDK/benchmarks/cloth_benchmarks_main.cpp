@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+#include "math/Precision.hpp"
+#include "physics/SolverStats.hpp"
+#include "utils/CpuFeatures.hpp"
+#include <string>
+#include <omp.h>
+
+using namespace ClothSDK;
+
+// Records the build configuration in the "context" block of every report, so JSON
+// results from different releases, precisions and machines can be told apart.
+
+namespace {
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512: return "avx512";
+        case SimdLevel::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::AddCustomContext("clothsdk_version", CLOTHSDK_VERSION);
+    benchmark::AddCustomContext("precision", sizeof(Real) == sizeof(float) ? "float" : "double");
+    benchmark::AddCustomContext("simd_level", simdLevelName(detectSimdLevel()));
+    benchmark::AddCustomContext("omp_max_threads", std::to_string(omp_get_max_threads()));
+    benchmark::AddCustomContext("solver_profiling", SolverStats::kCompiledIn ? "on" : "off");
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
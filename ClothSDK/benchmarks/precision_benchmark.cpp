@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include "BenchmarkScenes.hpp"
+
+using namespace ClothSDK;
+using namespace ClothSDK::Bench;
+
+// Compiled into both cloth_benchmarks (double) and cloth_benchmarks_float; run the
+// two binaries with the same filter to compare throughput per precision.
+
+namespace {
+
+const char* precisionLabel() {
+    return sizeof(Real) == sizeof(float) ? "float" : "double";
+}
+
+}
+
+static void BM_PrecisionSolverUpdate(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    buildGridScene(solver, mesh, side, 1);
+
+    for (auto _ : state)
+        solver.update(1.0 / 60.0);
+
+    state.SetLabel(precisionLabel());
+    state.SetItemsProcessed(state.iterations() * side * side);
+}
+
+static void BM_PrecisionDistanceSolve(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    buildGridScene(solver, mesh, side, 1);
+
+    ParticleBuffer particles = solver.getParticles();
+    DistanceBatch batch = solver.getDistanceBatch();
+
+    for (auto _ : state) {
+        batch.solve(particles, 1.0 / 900.0);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(precisionLabel());
+    state.SetItemsProcessed(state.iterations() * batch.size());
+}
+
+BENCHMARK(BM_PrecisionSolverUpdate)->Arg(64)->Arg(128)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PrecisionDistanceSolve)->Arg(64)->Arg(256)->Arg(512)->Unit(benchmark::kMicrosecond);
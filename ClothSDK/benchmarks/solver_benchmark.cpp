@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+#include "BenchmarkScenes.hpp"
+#include "physics/PlaneCollider.hpp"
+#include "physics/SphereCollider.hpp"
+
+using namespace ClothSDK;
+using namespace ClothSDK::Bench;
+
+namespace {
+
+constexpr Real kSubstepDt = Real(1.0 / 900.0);
+
+void BM_DistanceBatchSolve(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    buildGridScene(solver, mesh, side, 1);
+
+    ParticleBuffer particles = solver.getParticles();
+    DistanceBatch batch = solver.getDistanceBatch();
+    BenchmarkThreads threads(static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        batch.solve(particles, kSubstepDt);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch.size());
+}
+
+void BM_BendingBatchSolve(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    buildGridScene(solver, mesh, side, 1);
+
+    ParticleBuffer particles = solver.getParticles();
+    BendingBatch batch = solver.getBendingBatch();
+    BenchmarkThreads threads(static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        batch.solve(particles, kSubstepDt);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch.size());
+}
+
+void BM_Colliders(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    buildGridScene(solver, mesh, side, 10);
+
+    ParticleBuffer particles = solver.getParticles();
+    PlaneCollider plane(Vector3r(0, -0.05 * side, 0), Vector3r(0, 1, 0), 0.5);
+    SphereCollider sphere(Vector3r(0.05 * side, 0.0, 0.05 * side), 0.02 * side, 0.2);
+
+    for (auto _ : state) {
+        plane.resolve(particles, kSubstepDt);
+        sphere.resolve(particles, kSubstepDt);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * particles.size());
+}
+
+// Phases that only run inside Solver::update() are timed through the solver's own
+// profiling (see SolverStats); each iteration reports the phase time of one frame.
+template <SolverPhase Phase>
+void BM_SolverPhase(benchmark::State& state) {
+    if (!SolverStats::kCompiledIn) {
+        state.SkipWithError("built without CLOTHSDK_ENABLE_PROFILING");
+        return;
+    }
+
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    buildGridScene(solver, mesh, side, 10);
+    solver.setProfilingEnabled(true);
+    BenchmarkThreads threads(static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        solver.update(1.0 / 60.0);
+        state.SetIterationTime(1e-3 * solver.getStats().frameMs(Phase));
+    }
+    state.SetItemsProcessed(state.iterations() * solver.getSubsteps() * solver.getParticles().size());
+}
+
+void BM_SolverUpdateGrid(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    buildGridScene(solver, mesh, side, 1);
+    BenchmarkThreads threads(static_cast<int>(state.range(1)));
+
+    for (auto _ : state)
+        solver.update(1.0 / 60.0);
+    state.SetItemsProcessed(state.iterations() * side * side);
+}
+
+void BM_SolverUpdateBunny(benchmark::State& state) {
+    Solver solver;
+    ClothMesh mesh;
+    if (!buildBunnyScene(solver, mesh)) {
+        state.SkipWithError("cannot load data/models/bunny.obj");
+        return;
+    }
+    solver.update(1.0 / 60.0);
+    BenchmarkThreads threads(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+        solver.update(1.0 / 60.0);
+    state.SetItemsProcessed(state.iterations() * solver.getParticles().size());
+}
+
+}
+
+BENCHMARK(BM_DistanceBatchSolve)->ArgNames({"side", "threads"})->ArgsProduct({{64, 256}, {1, 2, 4}})
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BendingBatchSolve)->ArgNames({"side", "threads"})->ArgsProduct({{64, 256}, {1, 2, 4}})
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Colliders)->ArgName("side")->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(BM_SolverPhase, SolverPhase::SelfCollision)->ArgNames({"side", "threads"})
+    ->ArgsProduct({{64, 128}, {1, 4}})->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SolverPhase, SolverPhase::Aerodynamics)->ArgNames({"side", "threads"})
+    ->ArgsProduct({{64, 128}, {1, 4}})->UseManualTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_SolverUpdateGrid)->ArgNames({"side", "threads"})->ArgsProduct({{32, 64, 128}, {1, 2, 4}})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SolverUpdateBunny)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
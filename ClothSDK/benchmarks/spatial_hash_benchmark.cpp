@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include "BenchmarkScenes.hpp"
+#include "physics/SpatialHash.hpp"
+#include <vector>
+
+using namespace ClothSDK;
+using namespace ClothSDK::Bench;
+
+namespace {
+
+// A folded grid: particles spread over neighboring cells the way a draped cloth does.
+const ParticleBuffer& foldedParticles(Solver& solver, ClothMesh& mesh, int side) {
+    buildGridScene(solver, mesh, side, 10);
+    return solver.getParticles();
+}
+
+void BM_SpatialHashBuild(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    const ParticleBuffer& particles = foldedParticles(solver, mesh, side);
+
+    SpatialHash hash(solver.getThickness());
+    hash.setStoreSortedPositions(true);
+    BenchmarkThreads threads(static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        hash.build(particles);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * particles.size());
+}
+
+void BM_SpatialHashQuery(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    const ParticleBuffer& particles = foldedParticles(solver, mesh, side);
+
+    SpatialHash hash(solver.getThickness());
+    hash.setStoreSortedPositions(true);
+    hash.build(particles);
+
+    std::vector<int> neighbors;
+    for (auto _ : state) {
+        size_t found = 0;
+        for (size_t i = 0; i < particles.size(); ++i) {
+            neighbors.clear();
+            hash.query(particles, particles.getPosition(static_cast<int>(i)), solver.getThickness(), neighbors);
+            found += neighbors.size();
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * particles.size());
+}
+
+void BM_SpatialHashQueryRange(benchmark::State& state) {
+    const int side = static_cast<int>(state.range(0));
+    Solver solver;
+    ClothMesh mesh;
+    const ParticleBuffer& particles = foldedParticles(solver, mesh, side);
+
+    SpatialHash hash(solver.getThickness());
+    hash.setStoreSortedPositions(true);
+    hash.build(particles);
+
+    std::vector<int> offsets;
+    std::vector<int> neighbors;
+    for (auto _ : state) {
+        hash.queryRangeSorted(particles, 0, static_cast<int>(particles.size()), solver.getThickness(), offsets, neighbors);
+        benchmark::DoNotOptimize(neighbors.data());
+    }
+    state.SetItemsProcessed(state.iterations() * particles.size());
+}
+
+}
+
+BENCHMARK(BM_SpatialHashBuild)->ArgNames({"side", "threads"})->ArgsProduct({{64, 128, 256}, {1, 2, 4}})
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SpatialHashQuery)->ArgName("side")->Arg(64)->Arg(128)->Arg(256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SpatialHashQueryRange)->ArgName("side")->Arg(64)->Arg(128)->Arg(256)->Unit(benchmark::kMicrosecond);
@@ -1,14 +1,15 @@
 #pragma once
 
 #include "math/Types.hpp"
+#include "engine/MeshReordering.hpp"
 
+#include "math/Precision.hpp"
 #include <Eigen/Dense>
 #include <cmath>
 #include <fstream>
 #include <string>
 #include <utility>
 #include <vector>
-#include <map>
 
 namespace ClothSDK {
 
@@ -18,42 +19,49 @@ class ClothMesh {
 public:
     ClothMesh();
 
-    void initGrid(int rows, int cols, double spacing, Solver& solver);
-    void buildFromMesh(const std::vector<Eigen::Vector3d>& positions, const std::vector<int>& indices, Solver& solver);
+    void initGrid(int rows, int cols, Real spacing, Solver& solver);
+    void buildFromMesh(const std::vector<Vector3r>& positions, const std::vector<int>& indices, Solver& solver);
 
-    void setMaterial(double density, double stretch, double shear, double bend);
+    void setMaterial(Real density, Real stretch, Real shear, Real bend);
+
+    /**
+     * @brief Vertex ordering applied by buildFromMesh().
+     *
+     * With an ordering other than None, particles are created in the permuted order,
+     * and triangles and constraints are sorted by their first particle.
+     * getParticleID() and exportToOBJ() keep using the file's vertex indices.
+     */
+    void setOrdering(MeshOrdering ordering) { m_ordering = ordering; }
+    MeshOrdering getOrdering() const { return m_ordering; }
 
     void exportToOBJ(const std::string& filename, const Solver& solver) const;
 
     int getParticleID(int row, int col) const;
 
-    inline double getDensity() const { return m_density; }
-    inline double getStructuralCompliance() const { return m_structuralCompliance; }
-    inline double getShearCompliance() const { return m_shearCompliance; }
-    inline double getBendingCompliance() const { return m_bendingCompliance; }
+    inline Real getDensity() const { return m_density; }
+    inline Real getStructuralCompliance() const { return m_structuralCompliance; }
+    inline Real getShearCompliance() const { return m_shearCompliance; }
+    inline Real getBendingCompliance() const { return m_bendingCompliance; }
     inline std::vector<unsigned int> getVisualEdges() const { return m_visualEdges; }
 
+    /** @return Solver particle id of every mesh vertex, indexed by file vertex (row-major for grids). */
+    inline const std::vector<int>& getParticleIndices() const { return m_particlesIndices; }
+
+    /** @return Triangles in solver particle ids. */
+    inline const std::vector<Triangle>& getTriangles() const { return m_triangles; }
+
 private:
-    struct Edge {
-        int v1, v2;
-        Edge(int a, int b) : v1(std::min(a, b)), v2(std::max(a, b)) {}
-        
-        bool operator<(const Edge& other) const {
-            return v1 < other.v1 || (v1 == other.v1 && v2 < other.v2);
-        }
-    };
-
-    int getOppositeVertex(const Triangle& tri, int v1, int v2) const;
-    double calculateInitialAngle(int v1,int v2,int v3,int v4, const Solver& solver) const;
+    Real calculateInitialAngle(int v1,int v2,int v3,int v4, const Solver& solver) const;
 
     std::vector<int> m_particlesIndices;
     std::vector<Triangle> m_triangles;
     std::vector<unsigned int> m_visualEdges;
 
-    double m_density;
-    double m_structuralCompliance;
-    double m_shearCompliance;
-    double m_bendingCompliance;
+    Real m_density;
+    Real m_structuralCompliance;
+    Real m_shearCompliance;
+    Real m_bendingCompliance;
+    MeshOrdering m_ordering = MeshOrdering::None;
 
     int m_rows, m_cols;
 };
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "math/Precision.hpp"
+#include <vector>
+
+namespace ClothSDK {
+
+/**
+ * @brief Vertex orderings applied by ClothMesh::buildFromMesh before particles are created.
+ */
+enum class MeshOrdering {
+    None,                ///< Keep the file's vertex order.
+    Morton,              ///< Sort vertices along a Z-order curve of their rest positions.
+    ReverseCuthillMcKee  ///< Breadth-first order over the triangle graph, reversed to reduce bandwidth.
+};
+
+/**
+ * @class MeshReordering
+ * @brief Computes cache-friendly vertex permutations for imported meshes.
+ *
+ * Every function returns `order`, where `order[k]` is the original index of the
+ * vertex that becomes the k-th particle.
+ */
+class MeshReordering {
+public:
+    /** @brief Orders vertices by the 63-bit Morton code of their position in the mesh bounds. */
+    static std::vector<int> morton(const std::vector<Vector3r>& positions);
+
+    /**
+     * @brief Reverse Cuthill-McKee ordering of the vertex graph spanned by the triangles.
+     *
+     * Each connected component starts from a vertex of minimum degree; neighbors are
+     * visited by increasing degree. Vertices not referenced by any triangle keep their
+     * relative order at the end.
+     */
+    static std::vector<int> reverseCuthillMcKee(int vertexCount, const std::vector<int>& indices);
+
+    /** @brief Dispatches to the ordering selected by `ordering`; None yields the identity. */
+    static std::vector<int> compute(MeshOrdering ordering, const std::vector<Vector3r>& positions,
+                                    const std::vector<int>& indices);
+
+    /** @return Largest index distance between two vertices sharing a triangle. */
+    static int bandwidth(const std::vector<int>& indices);
+};
+
+}
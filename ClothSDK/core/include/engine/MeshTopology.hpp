@@ -0,0 +1,39 @@
+#pragma once
+
+#include "math/Types.hpp"
+#include <vector>
+
+namespace ClothSDK {
+
+/**
+ * @struct MeshTopology
+ * @brief Edge connectivity of a triangle mesh in flat arrays.
+ *
+ * Edges are unique, stored with the smaller vertex first and sorted by (v1, v2).
+ * The triangles touching edge `e` are `edgeTriangles[edgeTriangleOffsets[e] ..
+ * edgeTriangleOffsets[e + 1])`, in increasing triangle order.
+ */
+struct MeshTopology {
+    std::vector<int> edges;                 ///< Two vertices per edge.
+    std::vector<int> edgeTriangleOffsets;   ///< edgeCount() + 1 entries.
+    std::vector<int> edgeTriangles;
+    std::vector<int> discoveryOrder;        ///< Edge ids in the order the triangles first reference them.
+    std::vector<int> dihedrals;             ///< (v1, v2, v3, v4) per edge shared by exactly two triangles.
+
+    int edgeCount() const { return static_cast<int>(edges.size() / 2); }
+    int dihedralCount() const { return static_cast<int>(dihedrals.size() / 4); }
+
+    /**
+     * @brief Builds the topology in linear time.
+     *
+     * Half-edges are bucketed by their smaller vertex with a counting sort; each
+     * bucket holds only the vertex's incident edges, so buckets are sorted and
+     * deduplicated independently, in parallel. For a dihedral, v3 is the opposite
+     * vertex in the lower-numbered triangle and v4 the one in the other triangle.
+     *
+     * @param vertexCount One past the largest vertex index used by `triangles`.
+     */
+    static MeshTopology build(int vertexCount, const std::vector<Triangle>& triangles);
+};
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "io/FrameCache.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ClothSDK {
+
+class Solver;
+class ClothMesh;
+
+/**
+ * @class ExportSink
+ * @brief Destination of the frames published to an AsyncExporter.
+ *
+ * Sinks run on the exporter's writer thread and only see gathered positions,
+ * never the Solver, so they may serialize and write while the next frame is
+ * being simulated.
+ */
+class ExportSink {
+public:
+    virtual ~ExportSink() = default;
+
+    /**
+     * @brief Serializes and writes one frame.
+     *
+     * @param positions 3 * vertexCount floats, xyz per vertex in the mesh's file-vertex order.
+     * @param frame Sequence number of the frame, starting at 0.
+     * @param time Simulation time passed to AsyncExporter::publish().
+     * @return False on I/O failure; the exporter then drops the remaining frames.
+     */
+    virtual bool write(const float* positions, int frame, double time) = 0;
+
+    /** @brief Flushes and releases the output once all frames are written. */
+    virtual bool close() { return true; }
+};
+
+/**
+ * @class FrameCacheSink
+ * @brief Appends the published frames to a binary frame cache.
+ */
+class FrameCacheSink : public ExportSink {
+public:
+    /** @copydoc FrameCacheWriter::open */
+    bool open(const std::string& filepath, const ClothMesh& mesh, const Solver& solver,
+              FrameEncoding encoding = FrameEncoding::Float32);
+
+    bool write(const float* positions, int frame, double time) override;
+    bool close() override;
+
+private:
+    FrameCacheWriter m_writer;
+};
+
+/**
+ * @class ObjSequenceSink
+ * @brief Writes every published frame to its own OBJ file, `<prefix><frame>.obj`.
+ *
+ * The frame number is zero-padded to four digits. Vertex order and faces match
+ * ClothMesh::exportToOBJ().
+ */
+class ObjSequenceSink : public ExportSink {
+public:
+    ObjSequenceSink(const std::string& prefix, const ClothMesh& mesh);
+
+    bool write(const float* positions, int frame, double time) override;
+
+private:
+    std::string m_prefix;
+    int m_vertexCount = 0;
+    std::string m_faces;        ///< Face lines, formatted once since the topology never changes.
+    std::string m_text;         ///< Formatted file, reused between frames.
+};
+
+/**
+ * @class AsyncExporter
+ * @brief Overlaps frame export with simulation through a background writer thread.
+ *
+ * publish() copies the current positions into one of `queueDepth` reusable
+ * buffers and returns immediately; the writer thread hands the buffers to the
+ * sink in publication order and returns them to the pool. When every buffer is
+ * still waiting to be written, publish() blocks until one is free, so memory
+ * stays bounded and a slow disk throttles the simulation instead of queuing
+ * without limit. The time spent blocked is reported by getStallSeconds().
+ *
+ * publish() must be called from the thread that steps the solver, between updates.
+ */
+class AsyncExporter {
+public:
+    AsyncExporter() = default;
+
+    /** @brief Writes the pending frames and stops the writer thread. */
+    ~AsyncExporter();
+
+    AsyncExporter(const AsyncExporter&) = delete;
+    AsyncExporter& operator=(const AsyncExporter&) = delete;
+
+    /**
+     * @brief Starts the writer thread for the vertices of `mesh`.
+     *
+     * A running export is finished first.
+     *
+     * @param queueDepth Number of frame buffers, at least 1.
+     * @return False if `sink` is null, the mesh is empty or `queueDepth` is invalid.
+     */
+    bool start(const ClothMesh& mesh, std::unique_ptr<ExportSink> sink, int queueDepth = 3);
+
+    /** @brief Starts exporting to a frame cache, see FrameCacheWriter. */
+    bool startFrameCache(const std::string& filepath, const ClothMesh& mesh, const Solver& solver,
+                         FrameEncoding encoding = FrameEncoding::Float32, int queueDepth = 3);
+
+    /** @brief Starts exporting one OBJ file per frame, see ObjSequenceSink. */
+    bool startObjSequence(const std::string& prefix, const ClothMesh& mesh, int queueDepth = 3);
+
+    /**
+     * @brief Queues the current particle positions of `solver` for writing.
+     *
+     * Blocks while all buffers are in flight.
+     *
+     * @return False if the exporter is not running or the sink has failed.
+     */
+    bool publish(const Solver& solver, double time);
+
+    /**
+     * @brief Waits for the queued frames to be written, stops the thread and closes the sink.
+     *
+     * @return False if any write or the close failed.
+     */
+    bool finish();
+
+    inline bool isRunning() const { return m_worker.joinable(); }
+    inline bool hasFailed() const { return m_failed; }
+    inline int getPublishedCount() const { return m_published; }
+    inline int getWrittenCount() const { return m_written; }
+
+    /** @return Total time publish() spent waiting for a free buffer, in seconds. */
+    inline double getStallSeconds() const { return m_stallSeconds; }
+
+private:
+    struct Slot {
+        std::vector<float> positions;
+        int frame = 0;
+        double time = 0.0;
+    };
+
+    void run();
+
+    std::unique_ptr<ExportSink> m_sink;
+    std::vector<int> m_particleIds;     ///< Solver id of every exported vertex.
+    std::vector<Slot> m_slots;
+    std::deque<int> m_free;             ///< Slots the solver thread may fill.
+    std::deque<int> m_ready;            ///< Filled slots in publication order.
+
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_frameReady;
+    std::condition_variable m_slotFreed;
+    bool m_stopping = false;
+
+    std::atomic<bool> m_failed{false};
+    std::atomic<int> m_written{0};
+    int m_published = 0;
+    double m_stallSeconds = 0.0;
+};
+
+}
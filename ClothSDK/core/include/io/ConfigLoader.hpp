@@ -2,6 +2,7 @@
 
 #include <string>
 #include <nlohmann/json.hpp>
+#include "math/Precision.hpp"
 #include <Eigen/Dense>
 #include <fstream>
 
@@ -19,9 +20,9 @@ public:
 
 private:
 
-    static Eigen::Vector3d jsonToVector(const nlohmann::json& json);
+    static Vector3r jsonToVector(const nlohmann::json& json);
 
-    static nlohmann::json vectorToJson(const Eigen::Vector3d& vector);
+    static nlohmann::json vectorToJson(const Vector3r& vector);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "math/Precision.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ClothSDK {
+
+class Solver;
+class ClothMesh;
+
+/**
+ * @brief Storage of the per-frame positions in a frame cache.
+ */
+enum class FrameEncoding : uint32_t {
+    Float32 = 0,   ///< Exact single-precision positions, 12 bytes per vertex.
+    Float16 = 1,   ///< Half floats relative to the frame's bounding-box center, 6 bytes per vertex.
+    Delta16 = 2    ///< Displacement from the rest pose quantized to int16 with a per-frame scale, 6 bytes per vertex.
+};
+
+/**
+ * @brief File header of a frame cache. All offsets are relative to the start of the file.
+ *
+ * Layout: header, triangles (int32 triples), rest positions (float32 xyz), then
+ * `frameCount` blocks of exactly `frameStride` bytes starting at `frameOffset`.
+ * Every block is a FrameCacheBlock followed by 3 * vertexCount encoded values
+ * in x, y, z order per vertex.
+ */
+struct FrameCacheHeader {
+    char magic[8];             ///< "CLTHCACH"
+    uint32_t version;
+    uint32_t encoding;         ///< A FrameEncoding value.
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+    uint64_t frameStride;      ///< Bytes per frame block, a multiple of 8.
+    uint64_t frameOffset;      ///< Start of the first frame, 64-byte aligned.
+    uint64_t frameCount;       ///< Written on close; readers fall back to the file size.
+    uint8_t reserved[16];
+};
+
+/** @brief Per-frame prefix of a frame block. */
+struct FrameCacheBlock {
+    double time;               ///< Simulation time of the frame.
+    float origin[3];           ///< Float16: bounding-box center. Unused otherwise.
+    float scale;               ///< Delta16: meters per quantization step. Unused otherwise.
+};
+
+/**
+ * @class FrameCacheWriter
+ * @brief Appends simulated frames of a ClothMesh to a binary cache.
+ *
+ * Topology and rest pose are written once by open(); each writeFrame() gathers
+ * the positions in the mesh's file-vertex order, encodes them into a reusable
+ * buffer and appends them with one write. Vertex order and faces match
+ * ClothMesh::exportToOBJ().
+ */
+class FrameCacheWriter {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    FrameCacheWriter() = default;
+    ~FrameCacheWriter();
+
+    FrameCacheWriter(const FrameCacheWriter&) = delete;
+    FrameCacheWriter& operator=(const FrameCacheWriter&) = delete;
+
+    /**
+     * @brief Creates `filepath` and writes the header, topology and rest pose.
+     *
+     * The current particle positions are taken as the rest pose.
+     *
+     * @return False if the file cannot be created or the mesh is empty.
+     */
+    bool open(const std::string& filepath, const ClothMesh& mesh, const Solver& solver,
+              FrameEncoding encoding = FrameEncoding::Float32);
+
+    /**
+     * @brief Appends the current particle positions as a new frame.
+     *
+     * @param time Simulation time stored with the frame.
+     */
+    bool writeFrame(const Solver& solver, double time);
+
+    /**
+     * @brief Appends a frame that was already gathered in file-vertex order.
+     *
+     * Does not touch the solver, so it can run on a thread other than the one
+     * stepping the simulation (see AsyncExporter).
+     *
+     * @param positions 3 * getVertexCount() floats, xyz per vertex.
+     */
+    bool writePositions(const float* positions, double time);
+
+    /** @brief Finalizes the frame count in the header and closes the file. */
+    bool close();
+
+    inline bool isOpen() const { return m_file.is_open(); }
+    inline uint64_t getFrameCount() const { return m_frameCount; }
+    inline int getVertexCount() const { return static_cast<int>(m_particleIds.size()); }
+    inline FrameEncoding getEncoding() const { return m_encoding; }
+
+private:
+    std::ofstream m_file;
+    FrameEncoding m_encoding = FrameEncoding::Float32;
+    std::vector<int> m_particleIds;     ///< Solver id of every cached vertex.
+    std::vector<float> m_rest;          ///< Rest pose, xyz per vertex.
+    std::vector<float> m_frame;         ///< Gathered positions of writeFrame(), reused between frames.
+    std::vector<uint8_t> m_block;       ///< Encoded frame, reused between frames.
+    uint64_t m_frameCount = 0;
+};
+
+/**
+ * @class FrameCacheReader
+ * @brief Random access to the frames of a cache written by FrameCacheWriter.
+ *
+ * The file is memory-mapped where the platform allows it (read into memory
+ * otherwise). Frames have a fixed stride, so readFrame() seeks in O(1).
+ */
+class FrameCacheReader {
+public:
+    FrameCacheReader() = default;
+    ~FrameCacheReader();
+
+    FrameCacheReader(const FrameCacheReader&) = delete;
+    FrameCacheReader& operator=(const FrameCacheReader&) = delete;
+
+    /** @return False if the file is missing, truncated or not a frame cache of a supported version. */
+    bool open(const std::string& filepath);
+    void close();
+
+    inline bool isOpen() const { return m_data != nullptr; }
+    inline int getVertexCount() const { return static_cast<int>(m_header.vertexCount); }
+    inline int getTriangleCount() const { return static_cast<int>(m_header.triangleCount); }
+    inline int getFrameCount() const { return static_cast<int>(m_frameCount); }
+    inline FrameEncoding getEncoding() const { return static_cast<FrameEncoding>(m_header.encoding); }
+
+    /** @return Vertex indices of the triangles, three per triangle. */
+    const int32_t* getTriangles() const;
+
+    /** @return Rest pose, xyz per vertex. */
+    const float* getRestPositions() const;
+
+    /** @return Simulation time of `frame`. */
+    double getFrameTime(int frame) const;
+
+    /**
+     * @brief Decodes `frame` into `out` as xyz per vertex.
+     *
+     * @param out Resized to 3 * getVertexCount() values.
+     * @return False if `frame` is out of range.
+     */
+    bool readFrame(int frame, std::vector<float>& out) const;
+
+private:
+    const uint8_t* frameBlock(int frame) const;
+
+    const uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<uint64_t> m_buffer;     ///< Backing storage when the file could not be mapped.
+    FrameCacheHeader m_header{};
+    uint64_t m_frameCount = 0;
+};
+
+}
@@ -1,13 +1,14 @@
 #pragma once
 #include <string>
 #include <vector>
+#include "math/Precision.hpp"
 #include <Eigen/Dense>
 
 namespace ClothSDK {
 
 class OBJLoader {
 public:
-    static bool load(const std::string& path, std::vector<Eigen::Vector3d>& outPos, std::vector<int>& outIndices);
+    static bool load(const std::string& path, std::vector<Vector3r>& outPos, std::vector<int>& outIndices);
 };
 
 }
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "math/Precision.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ClothSDK {
+
+class Solver;
+
+/**
+ * @brief Identifies a data block inside a solver snapshot.
+ *
+ * Particle arrays are stored component-major (all x, then all y, then all z),
+ * constraint ids id-major (all idA, then all idB, ...), matching the solver's
+ * structure-of-arrays layout.
+ */
+enum class SnapshotSection : uint32_t {
+    Settings = 1,              ///< One SnapshotSettings record.
+    Position = 2,              ///< 3 * particles Real.
+    OldPosition = 3,           ///< 3 * particles Real.
+    Acceleration = 4,          ///< 3 * particles Real.
+    InverseMass = 5,           ///< particles Real.
+    DistanceIds = 6,           ///< 2 * constraints int32.
+    DistanceRestLength = 7,
+    DistanceCompliance = 8,
+    DistanceLambda = 9,
+    DistanceColorOffsets = 10, ///< colors + 1 int32.
+    BendingIds = 11,           ///< 4 * constraints int32.
+    BendingRestAngle = 12,
+    BendingCompliance = 13,
+    BendingLambda = 14,
+    BendingColorOffsets = 15,
+    AdjacencyEdges = 16,       ///< Interleaved int32 pairs.
+    AeroFaces = 17,            ///< Interleaved int32 triples.
+    Colliders = 18,            ///< 8 Real per collider, see SolverSnapshot.
+    Substepping = 19,          ///< One SnapshotSubstepping record; optional, absent means fixed substeps.
+    Sleeping = 20,             ///< One SnapshotSleeping record; optional, absent means sleeping disabled.
+    SleepState = 21,           ///< particles int32, see Solver sleep state; optional, absent means all awake.
+    Tethers = 22               ///< One SnapshotTethers record; optional, absent means tethers disabled.
+};
+
+/** @brief Fixed-size file header; every section offset is relative to the start of the file. */
+struct SnapshotHeader {
+    char magic[8];             ///< "CLTHSNAP"
+    uint32_t version;
+    uint32_t realSize;         ///< sizeof(Real) of the writer: 4 or 8.
+    uint32_t byteOrder;        ///< 0x01020304 as written by the producing machine.
+    uint32_t sectionCount;
+    uint64_t fileSize;
+    uint8_t reserved[32];
+};
+
+/** @brief Entry of the section table that follows the header. */
+struct SnapshotSectionEntry {
+    uint32_t id;               ///< A SnapshotSection value.
+    uint32_t elementSize;      ///< Bytes per element.
+    uint64_t count;            ///< Number of elements.
+    uint64_t offset;           ///< 64-byte aligned start of the data.
+};
+
+/** @brief Scalar solver parameters, stored in double whatever the precision of the writer. */
+struct SnapshotSettings {
+    double gravity[3];
+    double wind[3];
+    double airDensity;
+    double time;
+    double thickness;
+    double collisionCompliance;
+    double hashCellSize;
+    int32_t substeps;
+    int32_t iterations;
+    int32_t hashTableSize;     ///< Informational; adaptive tables are resized by the next build.
+    uint8_t adaptiveHashTable;
+    uint8_t storeSortedPositions;
+    uint8_t distanceColoringDirty;
+    uint8_t bendingColoringDirty;
+};
+
+/** @brief Adaptive substepping settings and controller state, stored in double like SnapshotSettings. */
+struct SnapshotSubstepping {
+    double maxDisplacement;
+    double maxResidual;
+    double relaxRatio;
+    double lastSubstepDt;
+    int32_t minSubsteps;
+    int32_t maxSubsteps;
+    int32_t currentSubsteps;   ///< Substeps the next adaptive frame starts with.
+    uint8_t enabled;
+    uint8_t padding[3];
+};
+
+/** @brief Island sleeping settings, stored in double like SnapshotSettings. */
+struct SnapshotSleeping {
+    double velocityThreshold;
+    int32_t substeps;
+    uint8_t enabled;
+    uint8_t padding[3];
+};
+
+/** @brief Long-range attachment settings; the tethers themselves are regenerated on restore. */
+struct SnapshotTethers {
+    double stretchLimit;
+    uint8_t enabled;
+    uint8_t padding[7];
+};
+
+/**
+ * @class SolverSnapshot
+ * @brief Versioned binary checkpoint of the complete simulation state of a Solver.
+ *
+ * A snapshot holds particles (positions, previous positions, accelerations and
+ * inverse masses), the distance and bending batches in their colored order with
+ * their Lagrange multipliers, the adjacency edges, aerodynamic faces, colliders,
+ * the scalar parameters, the adaptive substepping, sleeping and tether settings
+ * and the spatial-hash configuration. Restoring it and stepping continues bit-identically to the run
+ * that wrote it.
+ *
+ * Each section is a raw array aligned to 64 bytes, so the file can be
+ * memory-mapped and handed to restore() as is; load() reads the whole file with
+ * a single read and does the same. Snapshots are tied to the precision and byte
+ * order of the writer.
+ *
+ * The sleep state holds, per particle, the resting substeps of its island or -1
+ * while the island sleeps; it is written only once the solver has built its islands.
+ *
+ * Colliders are stored as (type, friction, p0, p1, p2, p3, p4, p5) with type 0
+ * for a plane (origin, normal) and 1 for a sphere (center, radius, 0, 0).
+ * Constraints added through Solver::addConstraint() are polymorphic and are not
+ * serializable; save() refuses solvers that hold any.
+ */
+class SolverSnapshot {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    /**
+     * @brief Writes the state of `solver` to `filepath`.
+     *
+     * @return False if the file cannot be written or the solver holds custom constraints.
+     */
+    static bool save(const std::string& filepath, const Solver& solver);
+
+    /**
+     * @brief Replaces the state of `solver` with the snapshot stored in `filepath`.
+     *
+     * The solver is left untouched if the file is missing, truncated, from another
+     * version, precision or byte order.
+     */
+    static bool load(const std::string& filepath, Solver& solver);
+
+    /**
+     * @brief Restores `solver` from a snapshot already in memory, e.g. a mapped file.
+     *
+     * @param data Start of the snapshot; must be at least 8-byte aligned.
+     * @param size Number of readable bytes at `data`.
+     */
+    static bool restore(const void* data, std::size_t size, Solver& solver);
+};
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+namespace ClothSDK {
+
+/**
+ * @brief Floating-point type of the simulation state.
+ *
+ * The core library is compiled once per precision: `ClothCore` uses double and
+ * `ClothCoreFloat` defines CLOTHSDK_SINGLE_PRECISION to switch particles,
+ * constraints, colliders and the spatial hash to float. The definition is public
+ * on the float target, so consumers always see the type their library was built with.
+ */
+#ifdef CLOTHSDK_SINGLE_PRECISION
+using Real = float;
+#else
+using Real = double;
+#endif
+
+using Vector3r = Eigen::Matrix<Real, 3, 1>;
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace ClothSDK {
+
+/**
+ * @class ActiveRanges
+ * @brief The parts of a colored constraint batch that touch awake particles.
+ *
+ * When some particles sleep, a batch projects only the constraints whose first
+ * particle is awake. Sleeping is decided per island, so either all or none of a
+ * constraint's particles are awake and checking one of them is enough. The
+ * active constraints of every color are stored as runs of consecutive indices,
+ * split into chunks for the thread team; runs never cross a color boundary.
+ * Constraints inside a color are independent, so projecting only some of them
+ * gives the same result for those as projecting the whole color.
+ */
+class ActiveRanges {
+public:
+    /**
+     * @brief Collects the active runs of every color.
+     *
+     * @param colorOffsets Start of every color in the batch, plus its end.
+     * @param firstParticle First particle id of every constraint.
+     * @param awake One flag per particle, nonzero when awake.
+     * @param chunk Longest run handed to one thread.
+     */
+    void build(const std::vector<int>& colorOffsets, const int* firstParticle, const uint8_t* awake, int chunk);
+
+    /** @brief Marks every constraint active again. */
+    void clear();
+
+    /** @return False while the whole batch is active. */
+    inline bool isEnabled() const { return m_enabled; }
+
+    /** @return Index of the first run of `color`. */
+    inline int colorBegin(int color) const { return m_colorOffsets[color]; }
+
+    /** @return Index past the last run of `color`. */
+    inline int colorEnd(int color) const { return m_colorOffsets[color + 1]; }
+
+    /** @return Number of runs over all colors. */
+    inline int runCount() const { return static_cast<int>(m_runs.size()) / 2; }
+
+    inline int runBegin(int run) const { return m_runs[2 * run]; }
+    inline int runEnd(int run) const { return m_runs[2 * run + 1]; }
+
+    /** @return Number of active constraints. */
+    inline int activeCount() const { return m_activeCount; }
+
+private:
+    bool m_enabled = false;
+    std::vector<int> m_colorOffsets;    ///< First run of every color, plus the run count.
+    std::vector<int> m_runs;            ///< Interleaved [begin, end) constraint ranges.
+    int m_activeCount = 0;
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "math/Precision.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ClothSDK {
+
+/**
+ * @brief Bounds and error targets of adaptive substepping, see Solver::setAdaptiveSubstepping().
+ *
+ * After every substep the solver measures the largest particle displacement and
+ * the largest XPBD residual left in the distance constraints (see
+ * DistanceBatch::maxRelativeResidual()). Each is divided by its target; the
+ * larger ratio drives the substep count of the frame.
+ */
+struct AdaptiveSubstepping {
+    bool enabled = false;
+    int minSubsteps = 2;
+    int maxSubsteps = 60;
+    Real maxDisplacement = Real(0.25);  ///< Largest move of a particle in one substep, as a fraction of the thickness.
+    Real maxResidual = Real(0.01);      ///< Largest constraint residual after the solve, relative to the rest length.
+    Real relaxRatio = Real(0.5);        ///< Below this error ratio the next frame uses fewer substeps.
+
+    /**
+     * @brief Substep count for the next frame.
+     *
+     * The count grows with the error ratio, at most doubling per frame, and
+     * shrinks by a quarter once the ratio falls below relaxRatio. The gap between
+     * the two thresholds keeps the count from oscillating.
+     *
+     * @param current Substeps of the frame that produced `errorRatio`.
+     * @param errorRatio Largest measured error over its target.
+     */
+    int nextSubsteps(int current, Real errorRatio) const {
+        int next = current;
+        if (errorRatio > Real(1))
+            next = static_cast<int>(std::ceil(current * std::min(errorRatio, Real(2))));
+        else if (errorRatio < relaxRatio)
+            next = current - std::max(1, current / 4);
+        return clamp(next);
+    }
+
+    int clamp(int substeps) const {
+        return std::max(minSubsteps, std::min(substeps, maxSubsteps));
+    }
+};
+
+/** @brief What the last Solver::update() measured and how many substeps it took. */
+struct SubstepMetrics {
+    int substeps = 0;
+    Real maxDisplacement = 0;           ///< Largest per-substep particle displacement; 0 unless adaptive.
+    Real maxResidual = 0;               ///< Largest relative constraint residual after a substep; 0 unless adaptive.
+};
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace ClothSDK {
+
+/**
+ * @class AdjacencyList
+ * @brief Compressed sparse row (CSR) neighbor lists of the particle topology.
+ *
+ * Stores, for every particle, the sorted ids of the particles it is connected to by
+ * a constraint. Self-collision uses it to skip pairs that the constraints already
+ * keep apart. Lookups read one short contiguous row instead of probing a
+ * node-based hash table.
+ */
+class AdjacencyList {
+public:
+    /**
+     * @brief Rebuilds the lists from an unordered set of undirected edges.
+     *
+     * Duplicate and reversed edges are merged. Runs in O(E log d) where d is the
+     * largest particle degree.
+     *
+     * @param particleCount Number of particles in the solver buffer.
+     * @param edges Pairs of connected particle ids.
+     */
+    void build(int particleCount, const std::vector<std::pair<int, int>>& edges);
+
+    /** @brief Removes every list. */
+    void clear();
+
+    /**
+     * @brief Checks whether two particles are connected.
+     *
+     * Short rows are scanned linearly, long rows are binary searched.
+     *
+     * @param a First particle id.
+     * @param b Second particle id.
+     * @return True if an edge (a, b) was part of the last build.
+     */
+    bool contains(int a, int b) const;
+
+    /** @return Pointer to the first neighbor of `id`. */
+    inline const int* neighborsBegin(int id) const { return m_neighbors.data() + m_offsets[id]; }
+
+    /** @return Pointer past the last neighbor of `id`. */
+    inline const int* neighborsEnd(int id) const { return m_neighbors.data() + m_offsets[id + 1]; }
+
+    /** @return Number of neighbors of `id`. */
+    inline int degree(int id) const { return m_offsets[id + 1] - m_offsets[id]; }
+
+    /** @return Number of particles covered by the lists. */
+    inline int getParticleCount() const { return static_cast<int>(m_offsets.size()) - 1; }
+
+private:
+    std::vector<int> m_offsets = {0};   ///< Row start per particle, size = particleCount + 1.
+    std::vector<int> m_neighbors;       ///< Sorted neighbor ids, row after row.
+};
+
+}
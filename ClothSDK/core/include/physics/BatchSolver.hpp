@@ -0,0 +1,78 @@
+#pragma once
+
+#include "math/Precision.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ClothSDK {
+
+class Solver;
+
+/**
+ * @class BatchSolver
+ * @brief Steps many independent solvers concurrently on a shared pool of threads.
+ *
+ * Each pool thread takes the next scene, runs all of its frames and moves on,
+ * so up to `threadCount` scenes are simulated at once. Scenes are started
+ * largest first to keep the last ones from running alone. A scene's OpenMP
+ * budget is its own Solver::setThreadCount() when set, otherwise the pool is
+ * split evenly between the scenes in flight: with at least as many scenes as
+ * threads every scene runs single-threaded, with fewer the spare threads go to
+ * each scene's OpenMP loops.
+ *
+ * The solvers are not owned and must outlive the batch. They must not be
+ * touched by other threads while update() runs.
+ */
+class BatchSolver {
+public:
+    /** @param threadCount Size of the pool, including the calling thread; 0 uses omp_get_max_threads(). */
+    explicit BatchSolver(int threadCount = 0);
+
+    /** @brief Stops the pool threads. */
+    ~BatchSolver();
+
+    BatchSolver(const BatchSolver&) = delete;
+    BatchSolver& operator=(const BatchSolver&) = delete;
+
+    void add(Solver& solver);
+    void clear();
+
+    inline size_t size() const { return m_solvers.size(); }
+    inline int getThreadCount() const { return m_threadCount; }
+
+    /**
+     * @brief Advances every solver by `frames` calls to Solver::update(deltaTime).
+     *
+     * Blocks until all scenes are done. The calling thread works on scenes too.
+     */
+    void update(Real deltaTime, int frames = 1);
+
+private:
+    void startWorkers(int count);
+    void workerLoop(std::uint64_t seen);
+    void runScenes();
+
+    int m_threadCount;
+    std::vector<Solver*> m_solvers;
+    std::vector<int> m_order;           ///< Scene indices, most expensive first.
+
+    // The batch being run; written by update() before the pool is woken.
+    Real m_deltaTime = 0;
+    int m_frames = 0;
+    int m_sceneThreads = 1;             ///< Budget of scenes without their own thread count.
+    std::atomic<int> m_nextScene{0};
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_batchReady;
+    std::condition_variable m_batchDone;
+    std::uint64_t m_generation = 0;
+    int m_busyWorkers = 0;
+    bool m_stopping = false;
+};
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "ParticleBuffer.hpp"
+#include "ActiveRanges.hpp"
+#include "utils/AlignedAllocator.hpp"
+#include <vector>
+
+namespace ClothSDK {
+
+/**
+ * @class BendingBatch
+ * @brief Contiguous storage and non-virtual XPBD kernel for dihedral bending constraints.
+ *
+ * Mirrors DistanceBatch for the four-particle bending constraint: the hinge edge
+ * (A, B), the two wing vertices (C, D), the rest angle, compliance and Lagrange
+ * multiplier are kept as parallel arrays, reordered into independent sets by color.
+ */
+class BendingBatch {
+public:
+    /**
+     * @brief XPBD projection of a single dihedral bending constraint.
+     *
+     * Shared by the batch kernel and BendingConstraint so both paths produce
+     * identical results.
+     *
+     * @param particles Solver particle buffer.
+     * @param a,b Indices of the hinge edge particles.
+     * @param c,d Indices of the opposite wing particles.
+     * @param restAngle Target dihedral angle in radians.
+     * @param alphaHat Time-step-corrected compliance @f$ \alpha / \Delta t^2 @f$.
+     * @param lambda Accumulated Lagrange multiplier, updated in place.
+     */
+    static void project(ParticleBuffer& particles, int a, int b, int c, int d,
+                        Real restAngle, Real alphaHat, Real& lambda);
+
+    /**
+     * @brief Appends a constraint. Invalidates the current coloring.
+     *
+     * The next buildColoring() reorders the constraints, so no stable index is returned.
+     */
+    void add(int idA, int idB, int idC, int idD, Real restAngle, Real compliance);
+
+    /** @brief Reserves storage for `count` constraints in every array. */
+    void reserve(std::size_t count);
+
+    /** @brief Removes every constraint. */
+    void clear();
+
+    /** @brief Resets all accumulated Lagrange multipliers to zero. */
+    void resetLambda();
+
+    /**
+     * @brief Partitions the batch into independent sets and reorders the arrays by color.
+     *
+     * @param particleCount Number of particles in the solver buffer.
+     */
+    void buildColoring(int particleCount);
+
+    /**
+     * @brief Projects every constraint once, color by color.
+     *
+     * @param particles Solver particle buffer.
+     * @param dt Current substep time delta.
+     */
+    void solve(ParticleBuffer& particles, Real dt);
+
+    /**
+     * @brief Projects the constraints in `[begin, end)` serially.
+     *
+     * @param particles Solver particle buffer.
+     * @param dt Current substep time delta.
+     * @param begin First constraint index.
+     * @param end One past the last constraint index.
+     */
+    void solveRange(ParticleBuffer& particles, Real dt, int begin, int end);
+
+    /**
+     * @brief Restricts solve() to the constraints of awake particles, see ActiveRanges.
+     *
+     * Kept until the next call, buildColoring() or clear().
+     *
+     * @param awake One flag per particle, nonzero when awake; nullptr makes every constraint active.
+     */
+    void setActiveParticles(const uint8_t* awake);
+
+    /** @return Number of constraints solve() projects. */
+    inline int activeSize() const { return m_active.isEnabled() ? m_active.activeCount() : size(); }
+
+    inline int size() const { return static_cast<int>(m_idA.size()); }
+    inline bool isColoringDirty() const { return m_coloringDirty; }
+    inline const std::vector<int>& getColorOffsets() const { return m_colorOffsets; }
+
+    inline const int* idA() const { return m_idA.data(); }
+    inline const int* idB() const { return m_idB.data(); }
+    inline const int* idC() const { return m_idC.data(); }
+    inline const int* idD() const { return m_idD.data(); }
+    inline const Real* restAngle() const { return m_restAngle.data(); }
+    inline const Real* compliance() const { return m_compliance.data(); }
+    inline Real* lambda() { return m_lambda.data(); }
+    inline const Real* lambda() const { return m_lambda.data(); }
+
+private:
+    friend class SolverSnapshot;
+
+    AlignedVector<int> m_idA;
+    AlignedVector<int> m_idB;
+    AlignedVector<int> m_idC;
+    AlignedVector<int> m_idD;
+    AlignedVector<Real> m_restAngle;
+    AlignedVector<Real> m_compliance;
+    AlignedVector<Real> m_lambda;
+    std::vector<int> m_colorOffsets = {0};
+    bool m_coloringDirty = false;
+    ActiveRanges m_active;
+};
+
+}
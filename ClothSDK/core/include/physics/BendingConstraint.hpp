@@ -2,21 +2,20 @@
 
 #include "Constraint.hpp"
 
-#include "Particle.hpp"
-#include <vector>
-
 namespace ClothSDK {
 
 class BendingConstraint : public Constraint {
 public:
-    BendingConstraint(int idA, int idB, int idc, int idD, double restAngle, double compliance);
+    BendingConstraint(int idA, int idB, int idc, int idD, Real restAngle, Real compliance);
+
+    void solve(ParticleBuffer& particles, Real dt) override;
 
-    void solve(std::vector<Particle>& particles, double dt) override;
+    void getParticleIds(std::vector<int>& outIds) const override;
 
 private:
     int m_idA, m_idB, m_idC, m_idD;
-    double m_restAngle;
-    double m_compliance;
+    Real m_restAngle;
+    Real m_compliance;
 };
 
 }
\ No newline at end of file
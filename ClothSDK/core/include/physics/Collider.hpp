@@ -1,10 +1,10 @@
 #pragma once
 
-#include <vector>
+#include "math/Precision.hpp"
 
 namespace ClothSDK {
 
-class Particle;
+class ParticleBuffer;
 
 /**
  * @class Collider
@@ -31,24 +31,24 @@ public:
      * @param particles Reference to the global particle buffer.
      * @param dt Current substep time delta. Required for kinematic friction calculations.
      */
-    virtual void resolve(std::vector<Particle>& particles, double dt) = 0;
+    virtual void resolve(ParticleBuffer& particles, Real dt) = 0;
 
     /**
      * @brief Configures the surface friction coefficient.
      * 
      * @param friction Friction value in the range [0.0, 1.0]
      */
-    void setFriction(double friction) { m_friction = friction; }
+    void setFriction(Real friction) { m_friction = friction; }
 
     /** @return The current surface friction coefficient. */
-    inline double getFriction() const { return m_friction; }
+    inline Real getFriction() const { return m_friction; }
 
 protected:
     /**
      * @brief Tangential friction coefficient used during collision response.
      * 
      */
-    double m_friction = 0.5;
+    Real m_friction = 0.5;
 };
 
 }
\ No newline at end of file
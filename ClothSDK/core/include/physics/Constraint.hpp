@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Particle.hpp"
+#include "ParticleBuffer.hpp"
 #include <vector>
 
 namespace ClothSDK {
@@ -36,7 +36,7 @@ public:
      * @param particles Reference to the global particle buffer.
      * @param dt The current substep time delta.
      */
-    virtual void solve(std::vector<Particle>& particles, double dt) = 0;
+    virtual void solve(ParticleBuffer& particles, Real dt) = 0;
 
     /**
      * @brief Resets the accumulated Lagrange multiplier.
@@ -44,18 +44,29 @@ public:
      */
     virtual void resetLambda() { m_lambda = 0.0; }
 
+    /**
+     * @brief Reports the particles this constraint reads and writes.
+     *
+     * The solver uses these indices to place the constraint into an independent set
+     * that is projected in parallel. Constraints that leave the list empty are solved
+     * serially after all colored sets.
+     *
+     * @param outIds Receives the particle indices. Implementations append to it.
+     */
+    virtual void getParticleIds(std::vector<int>& /*outIds*/) const {}
+
 protected:
     /**
      * @brief Accumulated Lagrange multiplier for the current substep.
      * 
      */
-    double m_lambda;  
+    Real m_lambda;  
     
     /**
      * @brief Physical compliance of the constraint.
      * 
      */
-    double m_compliance;    
+    Real m_compliance;    
 };
 
 }
\ No newline at end of file
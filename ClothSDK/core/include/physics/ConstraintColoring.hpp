@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ClothSDK {
+
+/**
+ * @class ConstraintColoring
+ * @brief Greedy graph coloring that partitions constraints into independent sets.
+ *
+ * Two constraints conflict when they share a particle. Constraints that receive the
+ * same color touch disjoint particles and can therefore be projected concurrently.
+ * Solving the colors one after another is a Gauss-Seidel sweep in color order; the
+ * order inside a color does not affect the result.
+ */
+class ConstraintColoring {
+public:
+    /**
+     * @brief Colors a set of constraints described in compressed row form.
+     *
+     * Constraint `c` touches the particles `particleIds[offsets[c] .. offsets[c + 1])`.
+     * Inside every color the constraints keep their original relative order.
+     *
+     * @param offsets Per-constraint offsets into `particleIds`, size = constraintCount + 1.
+     * @param particleIds Concatenated particle indices of all constraints.
+     * @param particleCount Number of particles in the solver buffer.
+     */
+    void build(const std::vector<int>& offsets, const std::vector<int>& particleIds, int particleCount);
+
+    /** @brief Drops the current partition. */
+    void clear();
+
+    /**
+     * @brief Reorders a per-constraint array into color order.
+     *
+     * @param values Array indexed by original constraint index.
+     * @param order Result of getOrder().
+     */
+    template <typename Array>
+    static void permute(Array& values, const std::vector<int>& order) {
+        Array sorted(values.size());
+        for (std::size_t k = 0; k < order.size(); ++k)
+            sorted[k] = values[order[k]];
+        values.swap(sorted);
+    }
+
+    /** @return Constraint indices grouped by color. */
+    inline const std::vector<int>& getOrder() const { return m_order; }
+
+    /** @return Start of every color inside getOrder(), size = getColorCount() + 1. */
+    inline const std::vector<int>& getColorOffsets() const { return m_colorOffsets; }
+
+    /** @return Color assigned to each constraint. */
+    inline const std::vector<int>& getColors() const { return m_colors; }
+
+    /** @return Number of independent sets. */
+    inline int getColorCount() const { return static_cast<int>(m_colorOffsets.size()) - 1; }
+
+private:
+    std::vector<int> m_colors;
+    std::vector<int> m_order;
+    std::vector<int> m_colorOffsets = {0};
+};
+
+}
@@ -1,8 +1,6 @@
 #pragma once
 
 #include "Constraint.hpp"
-#include "Particle.hpp"
-#include <vector>
 
 namespace ClothSDK {
 
@@ -26,7 +24,7 @@ public:
      * @param restLength The target distance the constraint tries to maintain.
      * @param compliance Physical compliance (inverse of the stiffness), measured in m/N.
      */
-    DistanceConstraint(int idA, int idB, double restLength, double compliance);
+    DistanceConstraint(int idA, int idB, Real restLength, Real compliance);
 
     /**
      * @brief Solves the constraint by updating particle positions and the Lagrange multiplier.
@@ -39,13 +37,15 @@ public:
      * @param particles Reference to the solver's particle buffer.
      * @param dt Current substep time delta.
      */
-    void solve(std::vector<Particle>& particles, double dt) override;
+    void solve(ParticleBuffer& particles, Real dt) override;
+
+    void getParticleIds(std::vector<int>& outIds) const override;
 
 private:
     int m_idA;              ///< Index of the first particle.
     int m_idB;              ///< Index of the second particle.
-    double m_restLength;    ///< Natural length of the constraint.
-    double m_compliance;    ///< Physical compliance @f$ \alpha @f$.
+    Real m_restLength;    ///< Natural length of the constraint.
+    Real m_compliance;    ///< Physical compliance @f$ \alpha @f$.
 };
 
 }
\ No newline at end of file
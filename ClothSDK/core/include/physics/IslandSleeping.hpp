@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ParticleBuffer.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ClothSDK {
+
+/** @brief When resting cloth is put to sleep, see Solver::setSleeping(). */
+struct SleepSettings {
+    bool enabled = false;
+    Real velocityThreshold = Real(0.05);   ///< Speed below which a particle counts as resting.
+    int substeps = 30;                      ///< Consecutive resting substeps before an island sleeps.
+};
+
+/** @brief Particle and island counts of the sleeping state. */
+struct SleepStats {
+    int activeParticles = 0;
+    int sleepingParticles = 0;
+    int islands = 0;
+    int sleepingIslands = 0;
+};
+
+/**
+ * @class IslandSleeping
+ * @brief Groups particles into islands and tracks which islands are asleep.
+ *
+ * An island is a connected component of the constraint graph, typically one
+ * garment. Its particles sleep together, so no constraint ever links a sleeping
+ * particle to an awake one. An island falls asleep after all its particles
+ * stayed below the velocity threshold for the configured number of substeps.
+ * Its velocity is zeroed at that point. It stays asleep until it is woken
+ * explicitly.
+ */
+class IslandSleeping {
+public:
+    /**
+     * @brief Rebuilds the islands with every particle awake.
+     *
+     * @param particleCount Number of particles in the solver buffer.
+     * @param edges Pairs of particles connected by a constraint.
+     * @param restless Particles whose islands must never sleep.
+     */
+    void build(int particleCount, const std::vector<std::pair<int, int>>& edges, const std::vector<int>& restless);
+
+    /** @brief Drops every island. */
+    void clear();
+
+    /**
+     * @brief Advances the resting counters after a substep and puts quiet islands to sleep.
+     *
+     * @param particles Solver particle buffer; sleeping particles get old position = position.
+     * @param dt Length of the substep.
+     * @return True if an island fell asleep.
+     */
+    bool update(ParticleBuffer& particles, Real dt, const SleepSettings& settings);
+
+    /** @brief Wakes the island of `particle`. @return True if it was asleep. */
+    bool wakeParticle(int particle);
+
+    /** @brief Wakes every island. @return True if any was asleep. */
+    bool wakeAll();
+
+    /**
+     * @brief Restores the resting counter of every island from per-particle values.
+     *
+     * @param state Per particle: the resting substeps of its island, or -1 if it sleeps.
+     */
+    void setState(const int32_t* state);
+
+    /** @brief Per particle: the resting substeps of its island, or -1 if it sleeps. */
+    void getState(std::vector<int32_t>& state) const;
+
+    /** @return One flag per particle, 1 while awake. */
+    inline const uint8_t* awakeParticles() const { return m_awake.data(); }
+    inline bool isAwake(int particle) const { return m_awake[particle] != 0; }
+    inline bool hasSleepingIslands() const { return m_sleepingIslands > 0; }
+    inline int getParticleCount() const { return static_cast<int>(m_island.size()); }
+    inline int getIslandCount() const { return static_cast<int>(m_islandOffsets.size()) - 1; }
+
+    SleepStats getStats() const;
+
+private:
+    void sleepIsland(int island, ParticleBuffer& particles);
+    void wakeIsland(int island);
+
+    std::vector<int> m_island;              ///< Island of every particle.
+    std::vector<int> m_islandOffsets = {0}; ///< CSR start of every island in m_islandParticles.
+    std::vector<int> m_islandParticles;
+    std::vector<int> m_restingSubsteps;     ///< Per island; -1 while asleep.
+    std::vector<uint8_t> m_restless;        ///< Per island, 1 if it may never sleep.
+    std::vector<uint8_t> m_moving;          ///< Per island, scratch of update().
+    std::vector<uint8_t> m_awake;           ///< Per particle.
+    int m_sleepingIslands = 0;
+    int m_sleepingParticles = 0;
+};
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "math/Precision.hpp"
 #include <Eigen/Dense>
 
 namespace ClothSDK {
@@ -17,21 +18,31 @@ public:
      * 
      * @param initialPos Initial world-space position.
      */
-    Particle(const Eigen::Vector3d& initialPos);
+    Particle(const Vector3r& initialPos);
+
+    /**
+     * @brief Constructs a Particle from a complete state snapshot.
+     * 
+     * @param position Current world-space position.
+     * @param oldPosition Position from the previous step.
+     * @param acceleration Accumulated acceleration.
+     * @param invMass Inverse mass.
+     */
+    Particle(const Vector3r& position, const Vector3r& oldPosition, const Vector3r& acceleration, Real invMass);
 
     /**
      * @brief Accumulates an external force into the particle's state.
      * 
      * @param force Force vector in Newtons.
      */
-    void addForce(const Eigen::Vector3d& force);
+    void addForce(const Vector3r& force);
 
     /**
      * @brief Add real mass to the particle and update its inverse mass.
      * 
      * @param mass Amount of mass in kg to add to the current value.
      */
-    void addMass(double mass);
+    void addMass(Real mass);
 
     /**
      * @brief Resets the acceleration acumulator to zero.
@@ -44,46 +55,46 @@ public:
      * 
      * @param deltaTime The fixed time step for the current update.
      */
-    void integrate(double deltaTime);
+    void integrate(Real deltaTime);
 
     /**
      * @brief Sets the particle's current position.
      * 
      * @param newPosition The new point in world space.
      */
-    void setPosition(const Eigen::Vector3d& newPosition);
+    void setPosition(const Vector3r& newPosition);
 
     /**
      * @brief Set the inverse mass of the particle.
      * 
      * @param invMass The inverse mass value.
      */
-    void setInverseMass(double invMass);
+    void setInverseMass(Real invMass);
 
     /**
      * @brief Set the particle's old position.
      * 
      * @param newOldPosition The new point in the world space for the previous state.
      */
-    void setOldPosition(const Eigen::Vector3d& newOldPosition);
+    void setOldPosition(const Vector3r& newOldPosition);
 
     /** @return Constant reference to the current position vector. */
-    inline const Eigen::Vector3d& getPosition() const { return m_position; }
+    inline const Vector3r& getPosition() const { return m_position; }
 
     /** @return Constant reference to the accumulated acceleration vector. */
-    inline const Eigen::Vector3d& getAcceleration() const { return m_acceleration; }
+    inline const Vector3r& getAcceleration() const { return m_acceleration; }
 
     /** @return Constant reference to the previous step's position vector. */
-    inline const Eigen::Vector3d& getOldPosition() const { return m_oldPosition; }
+    inline const Vector3r& getOldPosition() const { return m_oldPosition; }
 
     /** @return The current inverse mass value. */
-    inline const double getInverseMass() const { return inverseMass; }
+    inline const Real getInverseMass() const { return inverseMass; }
 
 private:
-    Eigen::Vector3d m_position;     ///< Current position in 3D world space.
-    Eigen::Vector3d m_oldPosition;  ///< Position from the previous step.
-    Eigen::Vector3d m_acceleration; ///< Force accumulator converted to acceleration.
-    double inverseMass;             ///< Inverse mass.
+    Vector3r m_position;     ///< Current position in 3D world space.
+    Vector3r m_oldPosition;  ///< Position from the previous step.
+    Vector3r m_acceleration; ///< Force accumulator converted to acceleration.
+    Real inverseMass;             ///< Inverse mass.
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Particle.hpp"
+#include "utils/AlignedAllocator.hpp"
+#include <Eigen/Dense>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace ClothSDK {
+
+/**
+ * @class ParticleBuffer
+ * @brief Structure-of-arrays storage for the solver's particle state.
+ *
+ * Every vector quantity (position, old position and acceleration) is kept as one
+ * 64-byte aligned block holding the x, y and z components as three separate
+ * arrays of length stride(). The inverse masses live in their own aligned array.
+ * Solver phases iterate these arrays directly, which keeps each loop streaming
+ * only the components it touches and lets the compiler vectorize them.
+ *
+ * Indexing with operator[] returns a Particle snapshot by value so that code
+ * written against the old std::vector<Particle> interface keeps working for
+ * read access. Writes must go through the setters or the raw arrays.
+ */
+class ParticleBuffer {
+public:
+    /**
+     * @class ConstIterator
+     * @brief Forward iterator producing Particle snapshots.
+     */
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Particle;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Particle;
+
+        ConstIterator(const ParticleBuffer* buffer, std::size_t index) : m_buffer(buffer), m_index(index) {}
+
+        Particle operator*() const { return (*m_buffer)[m_index]; }
+        ConstIterator& operator++() { ++m_index; return *this; }
+        ConstIterator operator++(int) { ConstIterator tmp = *this; ++m_index; return tmp; }
+        bool operator==(const ConstIterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const ConstIterator& other) const { return m_index != other.m_index; }
+
+    private:
+        const ParticleBuffer* m_buffer;
+        std::size_t m_index;
+    };
+
+    ParticleBuffer();
+
+    /**
+     * @brief Builds a buffer holding a copy of the given particles.
+     *
+     * @param particles Array-of-structures particle list.
+     */
+    explicit ParticleBuffer(const std::vector<Particle>& particles);
+
+    /**
+     * @brief Appends a particle to the end of the buffer.
+     *
+     * @param particle Initial particle state.
+     * @return Index of the new particle.
+     */
+    int add(const Particle& particle);
+
+    /**
+     * @brief Appends `count` particles at rest, growing the buffer at most once.
+     *
+     * @param positions Interleaved x, y, z coordinates, 3 * count values.
+     * @param count Number of particles to append.
+     * @param inverseMass Inverse mass of every new particle.
+     * @return Index of the first new particle; the others follow consecutively.
+     */
+    int append(const Real* positions, std::size_t count, Real inverseMass);
+
+    /**
+     * @brief Grows the per-component stride so that at least `count` particles fit without reallocation.
+     *
+     * @param count Number of particles to reserve space for.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief Sets the number of particles. Particles past the old size are zero-initialized.
+     *
+     * @param count New particle count.
+     */
+    void resize(std::size_t count);
+
+    /**
+     * @brief Removes every particle. Capacity is retained.
+     *
+     */
+    void clear();
+
+    /** @return Number of particles stored. */
+    inline std::size_t size() const { return m_size; }
+
+    /** @return True if the buffer holds no particles. */
+    inline bool empty() const { return m_size == 0; }
+
+    /** @return Distance, in elements, between the x, y and z arrays of a vector block. */
+    inline std::size_t stride() const { return m_stride; }
+
+    /** @return Snapshot of the particle at index `i`. */
+    Particle operator[](std::size_t i) const;
+
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end() const { return ConstIterator(this, m_size); }
+
+    inline Vector3r getPosition(int i) const { return Vector3r(posX()[i], posY()[i], posZ()[i]); }
+    inline Vector3r getOldPosition(int i) const { return Vector3r(oldX()[i], oldY()[i], oldZ()[i]); }
+    inline Vector3r getAcceleration(int i) const { return Vector3r(accX()[i], accY()[i], accZ()[i]); }
+    inline Real getInverseMass(int i) const { return m_inverseMass[i]; }
+
+    inline void setPosition(int i, const Vector3r& p) { posX()[i] = p.x(); posY()[i] = p.y(); posZ()[i] = p.z(); }
+    inline void setOldPosition(int i, const Vector3r& p) { oldX()[i] = p.x(); oldY()[i] = p.y(); oldZ()[i] = p.z(); }
+    inline void setInverseMass(int i, Real invMass) { m_inverseMass[i] = invMass; }
+
+    /**
+     * @brief Accumulates a force into the acceleration of particle `i`.
+     *
+     * @param i Particle index.
+     * @param force Force vector in Newtons.
+     */
+    inline void addForce(int i, const Vector3r& force) {
+        Real w = m_inverseMass[i];
+        accX()[i] += force.x() * w;
+        accY()[i] += force.y() * w;
+        accZ()[i] += force.z() * w;
+    }
+
+    /**
+     * @brief Adds real mass to particle `i`. Static particles stay static.
+     *
+     * @param i Particle index.
+     * @param mass Amount of mass in kg.
+     */
+    void addMass(int i, Real mass);
+
+    inline Real* posX() { return m_position.data(); }
+    inline Real* posY() { return m_position.data() + m_stride; }
+    inline Real* posZ() { return m_position.data() + 2 * m_stride; }
+    inline const Real* posX() const { return m_position.data(); }
+    inline const Real* posY() const { return m_position.data() + m_stride; }
+    inline const Real* posZ() const { return m_position.data() + 2 * m_stride; }
+
+    inline Real* oldX() { return m_oldPosition.data(); }
+    inline Real* oldY() { return m_oldPosition.data() + m_stride; }
+    inline Real* oldZ() { return m_oldPosition.data() + 2 * m_stride; }
+    inline const Real* oldX() const { return m_oldPosition.data(); }
+    inline const Real* oldY() const { return m_oldPosition.data() + m_stride; }
+    inline const Real* oldZ() const { return m_oldPosition.data() + 2 * m_stride; }
+
+    inline Real* accX() { return m_acceleration.data(); }
+    inline Real* accY() { return m_acceleration.data() + m_stride; }
+    inline Real* accZ() { return m_acceleration.data() + 2 * m_stride; }
+    inline const Real* accX() const { return m_acceleration.data(); }
+    inline const Real* accY() const { return m_acceleration.data() + m_stride; }
+    inline const Real* accZ() const { return m_acceleration.data() + 2 * m_stride; }
+
+    inline Real* invMass() { return m_inverseMass.data(); }
+    inline const Real* invMass() const { return m_inverseMass.data(); }
+
+private:
+    static void regrowBlock(AlignedVector<Real>& block, std::size_t oldStride, std::size_t newStride, std::size_t count);
+
+    AlignedVector<Real> m_position;      ///< x | y | z arrays, each of length m_stride.
+    AlignedVector<Real> m_oldPosition;   ///< Previous positions, same layout as m_position.
+    AlignedVector<Real> m_acceleration;  ///< Accumulated accelerations, same layout as m_position.
+    AlignedVector<Real> m_inverseMass;   ///< Inverse masses, length m_stride.
+    std::size_t m_size;                    ///< Number of live particles.
+    std::size_t m_stride;                  ///< Allocated particles per component array.
+};
+
+}
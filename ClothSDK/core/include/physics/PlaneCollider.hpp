@@ -22,7 +22,7 @@ public:
      * @param normal A vector defining the collision side of the plane.
      * @param friction The friction coefficient [0.0 - 1.0] for tangential damping.
      */
-    PlaneCollider(const Eigen::Vector3d& origin, const Eigen::Vector3d& normal, double friction);
+    PlaneCollider(const Vector3r& origin, const Vector3r& normal, Real friction);
     
     /**
      * @brief Projects penetrating particles onto the plane's surface.
@@ -34,11 +34,14 @@ public:
      * @param particles Reference to the global particle buffer.
      * @param dt Current substep time delta.
      */
-    void resolve(std::vector<Particle>& particles, double dt);
+    void resolve(ParticleBuffer& particles, Real dt) override;
+
+    inline const Vector3r& getOrigin() const { return m_origin; }
+    inline const Vector3r& getNormal() const { return m_normal; }
 
 private:
-    Eigen::Vector3d m_origin;   ///< World-space coordinate of a point in the plane.  
-    Eigen::Vector3d m_normal;   ///< Normalized vector defining the surface orientation.
+    Vector3r m_origin;   ///< World-space coordinate of a point in the plane.  
+    Vector3r m_normal;   ///< Normalized vector defining the surface orientation.
 };
 
 }
\ No newline at end of file
@@ -1,10 +1,18 @@
 #pragma once
 
 #include "Particle.hpp"  
+#include "ParticleBuffer.hpp"
 #include "Constraint.hpp"
 #include "Collider.hpp"
+#include "ConstraintColoring.hpp"
+#include "DistanceBatch.hpp"
+#include "BendingBatch.hpp"
+#include "TetherBatch.hpp"
 #include "SpatialHash.hpp"
-#include <unordered_set>
+#include "AdjacencyList.hpp"
+#include "SolverStats.hpp"
+#include "AdaptiveSubstepping.hpp"
+#include "IslandSleeping.hpp"
 #include <vector>
 #include <memory>
 #include <Eigen/Dense>
@@ -18,62 +26,253 @@ public:
     int addParticle(const Particle& p);
     void clear();
 
-    const std::vector<Particle>& getParticles() const;
+    const ParticleBuffer& getParticles() const;
 
-    void setGravity(const Eigen::Vector3d& gravity);
+    void setGravity(const Vector3r& gravity);
     void setSubsteps(int count);
     void setIterations(int count); 
-    void setParticleInverseMass(int id, double invMass);
-    void setWind(const Eigen::Vector3d& wind) {m_wind = wind; }
-    void setAirDensity(double density) {m_airDensity = density; }
-    void setThickness(double thickness) { m_thickness = thickness; }
-    void setCollisionCompliance(double c) { m_collisionCompliance = c; }
-
-    void addDistanceConstraint(int idA, int idB, double compliance);
-    void addBendingConstraint(int a, int b, int c, int d, double restAngle, double compliance);
-    void addMassToParticle(int id, double mass);
-    void addPlaneCollider(const Eigen::Vector3d& origin, const Eigen::Vector3d& normal, double friction);
-    void addSphereCollider(const Eigen::Vector3d& center, double radius, double friction);
+    void setParticleInverseMass(int id, Real invMass);
+    void setWind(const Vector3r& wind) {m_wind = wind; wakeAll(); }
+    void setAirDensity(Real density) {m_airDensity = density; wakeAll(); }
+    void setThickness(Real thickness) { m_thickness = thickness; wakeAll(); }
+    void setCollisionCompliance(Real c) { m_collisionCompliance = c; }
+    void setCollectHashStats(bool enabled) { m_spatialHash.setCollectStats(enabled); }
+
+    void addDistanceConstraint(int idA, int idB, Real compliance);
+    void addBendingConstraint(int a, int b, int c, int d, Real restAngle, Real compliance);
+    void addConstraint(std::unique_ptr<Constraint> constraint);
+
+    /**
+     * @brief Appends particles at rest with unit inverse mass.
+     *
+     * @param positions Interleaved x, y, z coordinates, 3 * count values.
+     * @param count Number of particles.
+     * @return Id of the first new particle; the others follow consecutively.
+     */
+    int addParticles(const Real* positions, int count);
+
+    /**
+     * @brief Appends distance constraints whose rest lengths are the current particle distances.
+     *
+     * Equivalent to calling addDistanceConstraint() for every pair, with storage
+     * reserved once up front.
+     *
+     * @param pairs Particle ids, 2 * count values.
+     * @param compliances One compliance per constraint.
+     * @param count Number of constraints.
+     */
+    void addDistanceConstraints(const int* pairs, const Real* compliances, int count);
+
+    /** @brief Same as above, with one compliance shared by every constraint. */
+    void addDistanceConstraints(const int* pairs, Real compliance, int count);
+
+    /**
+     * @brief Appends bending constraints; equivalent to calling addBendingConstraint() for every quad.
+     *
+     * @param quads Hinge particles a, b and wing particles c, d, 4 * count values.
+     * @param restAngles One rest angle per constraint, in radians.
+     * @param compliances One compliance per constraint.
+     * @param count Number of constraints.
+     */
+    void addBendingConstraints(const int* quads, const Real* restAngles, const Real* compliances, int count);
+
+    /** @brief Same as above, with one compliance shared by every constraint. */
+    void addBendingConstraints(const int* quads, const Real* restAngles, Real compliance, int count);
+
+    /**
+     * @brief Overwrites the positions of every particle.
+     *
+     * Velocity is implicit in position minus old position, so moving particles
+     * without changing their velocity means shifting both by the same amount.
+     *
+     * @param positions Interleaved x, y, z coordinates, 3 * particle count values.
+     */
+    void setPositions(const Real* positions);
+
+    /** @brief Overwrites the previous positions of every particle, same layout as setPositions(). */
+    void setOldPositions(const Real* positions);
+
+    /** @brief Overwrites the inverse mass of every particle; zero pins a particle. */
+    void setInverseMasses(const Real* inverseMasses);
+
+    void addMassToParticle(int id, Real mass);
+    void addPlaneCollider(const Vector3r& origin, const Vector3r& normal, Real friction);
+    void addSphereCollider(const Vector3r& center, Real radius, Real friction);
     void addAeroFace(int idA, int idB, int idC);
 
-    void update(double deltaTime);
+    void update(Real deltaTime);
+
+    /**
+     * @brief Caps the OpenMP threads used by update().
+     *
+     * The cap applies only for the duration of update() and only on the calling
+     * thread, so solvers stepped from different threads keep separate budgets.
+     *
+     * @param count Thread count; 0 uses the OpenMP default of the calling thread.
+     */
+    void setThreadCount(int count) { m_threadCount = count > 0 ? count : 0; }
+    int getThreadCount() const { return m_threadCount; }
+
+    /**
+     * @brief Lets update() pick the substep count from the measured error instead of getSubsteps().
+     *
+     * Every substep measures the largest particle displacement and the largest
+     * relative residual of the distance constraints. A substep over either target
+     * splits the rest of the frame into more substeps right away; quiet frames
+     * lower the count of the next frame. Velocities are rescaled whenever the
+     * substep length changes. The damping applied in every substep makes a
+     * frame with fewer substeps slightly less damped.
+     *
+     * Invalid bounds are clamped: minSubsteps to at least 1, maxSubsteps to at least minSubsteps.
+     * The first adaptive frame starts from getSubsteps() clamped to the bounds.
+     */
+    void setAdaptiveSubstepping(const AdaptiveSubstepping& settings);
+    const AdaptiveSubstepping& getAdaptiveSubstepping() const { return m_adaptive; }
+
+    /** @return Substeps and, in adaptive mode, the errors measured by the last update(). */
+    const SubstepMetrics& getLastSubstepMetrics() const { return m_lastMetrics; }
+
+    /** @return Substeps the next update() starts with. */
+    int getCurrentSubsteps() const { return m_adaptive.enabled ? m_adaptiveSubsteps : m_substeps; }
+
+    /**
+     * @brief Turns on long-range attachments to the pinned particles, see TetherBatch.
+     *
+     * The tethers are regenerated by the next update() whenever pins, particles
+     * or distance constraints change, and are projected at the start of every
+     * constraint iteration. Particles that cannot reach a pin get no tether.
+     * Invalid values are clamped: stretchLimit to at least 1.
+     */
+    void setTethers(const TetherSettings& settings);
+    const TetherSettings& getTethers() const { return m_tetherSettings; }
+
+    /**
+     * @brief Lets islands of resting cloth sleep, see IslandSleeping.
+     *
+     * A sleeping island gets no forces, integration or constraint projection and
+     * its particles are skipped by self-collision detection. It wakes when an
+     * awake particle moving faster than the threshold touches it, and every island
+     * wakes when gravity, wind, air density, thickness, colliders, particle state
+     * or topology change. Islands under wind still sleep once they stop moving and
+     * then ignore the gusts until woken. Islands touched by custom constraints
+     * never sleep, nor does anything while a constraint without particle ids exists.
+     *
+     * Disabling wakes every island. Invalid values are clamped: substeps to at least 1.
+     */
+    void setSleeping(const SleepSettings& settings);
+    const SleepSettings& getSleeping() const { return m_sleep; }
+
+    /** @return Awake and sleeping counts; every particle is active while sleeping is disabled. */
+    SleepStats getSleepStats() const;
+
+    /**
+     * @brief Turns per-phase timing of update() on or off.
+     *
+     * Has no effect in builds without CLOTHSDK_ENABLE_PROFILING. Disabled by default.
+     */
+    void setProfilingEnabled(bool enabled);
+    bool isProfilingEnabled() const { return m_profilingEnabled; }
+
+    /** @return Phase timings recorded while profiling was enabled. */
+    const SolverStats& getStats() const { return m_stats; }
+    void resetStats();
 
     int getSubsteps() const { return m_substeps; }
     int getIterations() const { return m_iterations; }
-    const Eigen::Vector3d& getGravity() const { return m_gravity; }
-    double getAirDensity() const { return m_airDensity; }
-    const Eigen::Vector3d& getWind() const { return m_wind; }
-    double getThickness() const { return m_thickness; }
-    double getCollisionCompliance() const { return m_collisionCompliance; }
+    const DistanceBatch& getDistanceBatch() const { return m_distanceBatch; }
+    const BendingBatch& getBendingBatch() const { return m_bendingBatch; }
+    const TetherBatch& getTetherBatch() const { return m_tetherBatch; }
+    const SpatialHash& getSpatialHash() const { return m_spatialHash; }
+    const Vector3r& getGravity() const { return m_gravity; }
+    Real getAirDensity() const { return m_airDensity; }
+    const Vector3r& getWind() const { return m_wind; }
+    Real getThickness() const { return m_thickness; }
+    Real getCollisionCompliance() const { return m_collisionCompliance; }
 
 private:
-    void step(double dt);
-    void applyForces(double dt);
-    void predictPositions(double dt);
-    void solveConstraints(double dt); 
-    void applyAerodynamics(double dt);
-    void solveSelfCollisions(double dt);
-    uint64_t getAdjacencyKey(int idA, int idB) const;
+    friend class SolverSnapshot;
+
+    void step(Real dt);
+    int runAdaptiveSubsteps(Real deltaTime);
+    Real maxSubstepDisplacement() const;
+    void rescaleVelocities(Real ratio);
+    void updateTopology();
+    void buildIslands();
+    void updateSleeping(Real dt);
+    void refreshActiveParticles();
+    void wakeAll();
+    const uint8_t* awakeParticles() const {
+        return m_islands.hasSleepingIslands() ? m_islands.awakeParticles() : nullptr;
+    }
+    void applyForces();
+    void predictPositions(Real dt);
+    void solveConstraints(Real dt); 
+    void applyAerodynamics(Real dt);
+    void solveSelfCollisions(Real dt);
+    void buildConstraintColoring();
+    void buildAeroTopology();
+    double* phaseTimes() { return m_profilingEnabled ? m_stats.lastFrameMs : nullptr; }
+    void appendDistanceConstraints(const int* pairs, const Real* compliance, int complianceStride, int count);
+    void appendBendingConstraints(const int* quads, const Real* restAngles, const Real* compliance,
+                                  int complianceStride, int count);
 
     struct AeroFace {
         int a, b, c;
     };
 
-    std::vector<Particle> m_particles; 
+    struct SelfContact {
+        int i, j;
+    };
+
+    static constexpr int kCollisionChunk = 64;
+
+    ParticleBuffer m_particles; 
+    DistanceBatch m_distanceBatch;
+    BendingBatch m_bendingBatch;
+    TetherBatch m_tetherBatch;
+    TetherSettings m_tetherSettings;
+    bool m_tethersDirty = false;
     std::vector<std::unique_ptr<Constraint>> m_constraints;
+    ConstraintColoring m_constraintColoring;
+    std::vector<int> m_colorOrder;
+    std::vector<int> m_serialConstraints;
+    bool m_coloringDirty = false;
     std::vector<std::unique_ptr<Collider>> m_colliders;
-    std::vector<int> m_neighborsBuffer;
-    std::unordered_set<uint64_t> m_adjacencies;
+    std::vector<std::vector<SelfContact>> m_contactBuffers;
+    int m_contactBufferCount = 0;       ///< Buffers filled by the last self-collision pass.
+    std::vector<std::vector<int>> m_threadNeighbors;
+    std::vector<std::vector<int>> m_threadNeighborOffsets;
+    std::vector<Real> m_collisionDelta;
+    std::vector<int> m_collisionCount;
+    std::vector<std::pair<int, int>> m_adjacencyEdges;
+    AdjacencyList m_adjacency;
+    bool m_adjacencyDirty = false;
     SpatialHash m_spatialHash;
-    Eigen::Vector3d m_gravity;
+    Vector3r m_gravity;
     int m_substeps;
     int m_iterations;
     std::vector<AeroFace> m_aeroFaces;
-    Eigen::Vector3d m_wind;
-    double m_airDensity;
-    double m_time; 
-    double m_thickness;
-    double m_collisionCompliance;
+    std::vector<Real> m_aeroForces;
+    std::vector<int> m_vertexFaceOffsets;
+    std::vector<int> m_vertexFaces;
+    bool m_aeroDirty = false;
+    Vector3r m_wind;
+    Real m_airDensity;
+    Real m_time; 
+    Real m_thickness;
+    Real m_collisionCompliance;
+    int m_threadCount = 0;
+    AdaptiveSubstepping m_adaptive;
+    int m_adaptiveSubsteps = 0;
+    Real m_lastSubstepDt = 0;           ///< Length of the last substep; velocities are relative to it.
+    Real m_substepResidual = 0;         ///< Constraint residual of the current substep, adaptive mode only.
+    SubstepMetrics m_lastMetrics;
+    SleepSettings m_sleep;
+    IslandSleeping m_islands;
+    bool m_islandsDirty = false;
+    std::vector<int32_t> m_pendingSleepState;  ///< Restored by SolverSnapshot, applied once the islands exist.
+    bool m_profilingEnabled = false;
+    SolverStats m_stats;
 };
 
 } 
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+
+namespace ClothSDK {
+
+/**
+ * @brief Timed sections of Solver::update().
+ *
+ * HashBuild and Topology run once per frame, the others once per substep.
+ */
+enum class SolverPhase : int {
+    HashBuild = 0,      ///< Spatial hash rebuild.
+    Topology,           ///< Lazy rebuild of colorings, adjacency and aerodynamic faces.
+    Forces,             ///< Gravity.
+    Aerodynamics,       ///< Wind drag and lift.
+    Predict,            ///< Position prediction.
+    Constraints,        ///< Lambda reset and all constraint iterations.
+    Colliders,          ///< Plane and sphere colliders.
+    SelfCollision,      ///< Self-collision detection and response.
+    SubstepControl,     ///< Error measurements of adaptive substepping.
+    Sleeping,           ///< Island sleep bookkeeping and wake-ups.
+    Count
+};
+
+/**
+ * @brief Wall-clock time spent in each phase of Solver::update().
+ *
+ * Filled only while profiling is enabled on the solver (Solver::setProfilingEnabled)
+ * and only in builds configured with CLOTHSDK_ENABLE_PROFILING; otherwise every
+ * field stays zero. "Last" values describe the most recent update(), totals
+ * accumulate until Solver::resetStats().
+ */
+struct SolverStats {
+    static constexpr int kPhaseCount = static_cast<int>(SolverPhase::Count);
+
+#ifdef CLOTHSDK_ENABLE_PROFILING
+    static constexpr bool kCompiledIn = true;
+#else
+    static constexpr bool kCompiledIn = false;
+#endif
+
+    int frames = 0;                         ///< Profiled update() calls.
+    int substeps = 0;                       ///< Substeps of all profiled frames.
+    int lastSubsteps = 0;
+    double lastUpdateMs = 0.0;              ///< Whole update(), including untimed bookkeeping.
+    double totalUpdateMs = 0.0;
+    double lastFrameMs[kPhaseCount] = {};
+    double totalMs[kPhaseCount] = {};
+    double maxFrameMs[kPhaseCount] = {};    ///< Slowest single frame per phase.
+
+    /** @return Time of `phase` in the last frame. */
+    double frameMs(SolverPhase phase) const { return lastFrameMs[static_cast<int>(phase)]; }
+
+    /** @return Mean time of `phase` per substep over the last frame. */
+    double substepMs(SolverPhase phase) const {
+        return lastSubsteps > 0 ? frameMs(phase) / lastSubsteps : 0.0;
+    }
+
+    /** @return Mean time of `phase` per frame since the last reset. */
+    double meanFrameMs(SolverPhase phase) const {
+        return frames > 0 ? totalMs[static_cast<int>(phase)] / frames : 0.0;
+    }
+
+    static const char* phaseName(SolverPhase phase) {
+        static const char* const names[kPhaseCount] = {
+            "hash build", "topology", "forces", "aerodynamics",
+            "predict", "constraints", "colliders", "self collision", "substep control", "sleeping"
+        };
+        return names[static_cast<int>(phase)];
+    }
+};
+
+/**
+ * @brief Adds the lifetime of the scope to one phase of the current frame.
+ *
+ * A null `frameMs` disables the timer at runtime; without CLOTHSDK_ENABLE_PROFILING
+ * the class is empty and the timer compiles to nothing.
+ */
+class PhaseTimer {
+public:
+#ifdef CLOTHSDK_ENABLE_PROFILING
+    PhaseTimer(double* frameMs, SolverPhase phase)
+        : m_target(frameMs ? frameMs + static_cast<int>(phase) : nullptr) {
+        if (m_target)
+            m_start = std::chrono::steady_clock::now();
+    }
+
+    ~PhaseTimer() {
+        if (m_target)
+            *m_target += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    double* m_target;
+    std::chrono::steady_clock::time_point m_start;
+#else
+    PhaseTimer(double*, SolverPhase) {}
+#endif
+
+public:
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+};
+
+}
@@ -1,39 +1,174 @@
 #pragma once
 
+#include "utils/AlignedAllocator.hpp"
+#include <atomic>
+#include <cstdint>
 #include <vector>
+#include "math/Precision.hpp"
 #include <Eigen/Dense>
 
 namespace ClothSDK {
 
-class Particle;
+class ParticleBuffer;
+
+/**
+ * @brief Occupancy and query telemetry of a SpatialHash.
+ *
+ * Bucket loads describe the last build; query counters accumulate until
+ * SpatialHash::resetQueryStats().
+ */
+struct SpatialHashStats {
+    int tableSize = 0;
+    int particleCount = 0;
+    int occupiedBuckets = 0;
+    int maxBucketLoad = 0;
+    double meanBucketLoad = 0.0;     ///< Particles per occupied bucket.
+    double buildTimeMs = 0.0;
+    long long queries = 0;
+    long long candidates = 0;        ///< Bucket entries scanned by all queries.
+    long long hashCollisions = 0;    ///< Scanned entries that live in a different grid cell.
+
+    /** @return Share of scanned entries that only matched through a hash collision. */
+    double falsePositiveRate() const { return candidates > 0 ? static_cast<double>(hashCollisions) / candidates : 0.0; }
+
+    /** @return Average number of hash-collision entries scanned per query. */
+    double falsePositivesPerQuery() const { return queries > 0 ? static_cast<double>(hashCollisions) / queries : 0.0; }
+};
 
 class SpatialHash {
 public:
-    SpatialHash(int tableSize, double cellSize);
-    void build(const std::vector<Particle>& particles);
-    void query(const std::vector<Particle>& particles, const Eigen::Vector3d& pos, double radius, std::vector<int>& outNeighbors) const ;
+    SpatialHash(int tableSize, Real cellSize);
+
+    /**
+     * @brief Creates a hash whose table is resized on every build.
+     *
+     * The table holds the next power of two above twice the particle count, so the
+     * load factor stays below one half regardless of scene size.
+     */
+    explicit SpatialHash(Real cellSize);
+
+    void build(const ParticleBuffer& particles);
+
+    /** @brief Neighbors of `pos` within `radius`, tested against the current positions of `particles`. */
+    void query(const ParticleBuffer& particles, const Vector3r& pos, Real radius, std::vector<int>& outNeighbors) const ;
+
+    /**
+     * @brief Queries the neighborhoods of the particles `[begin, end)` at once.
+     *
+     * Neighbors of particle `begin + k` are stored in
+     * `outNeighbors[outOffsets[k] .. outOffsets[k + 1])`, in the order query() returns them.
+     */
+    void queryRange(const ParticleBuffer& particles, int begin, int end, Real radius,
+                    std::vector<int>& outOffsets, std::vector<int>& outNeighbors) const;
+
+    /**
+     * @brief Same as queryRange(), but tests candidates against the cell-ordered copy.
+     *
+     * Only the query centers are read from `particles`. The result matches
+     * queryRange() as long as the copy was written by build() or
+     * refreshSortedPositions() from the same buffer and the particles have not
+     * moved since; the solver calls it right after refreshing. Without a valid
+     * copy for a buffer of this size it falls back to queryRange().
+     */
+    void queryRangeSorted(const ParticleBuffer& particles, int begin, int end, Real radius,
+                          std::vector<int>& outOffsets, std::vector<int>& outNeighbors) const;
+
+    /**
+     * @brief Keeps a copy of the particle positions in cell order for queryRangeSorted().
+     *
+     * Its queries then scan contiguous memory instead of dereferencing every
+     * candidate index into the particle buffer. The copy is written by build()
+     * and can be refreshed with refreshSortedPositions() after the particles moved.
+     */
+    void setStoreSortedPositions(bool enabled);
+    bool getStoreSortedPositions() const { return m_storeSortedPositions; }
+
+    /**
+     * @brief Re-gathers the cell-ordered positions without rebuilding the cells.
+     *
+     * A buffer with a different particle count than the last build invalidates the copy instead.
+     */
+    void refreshSortedPositions(const ParticleBuffer& particles);
+
+    void setCellSize(Real h) { m_cellSize = h; }
+    Real getCellSize() const { return m_cellSize; }
+    int getTableSize() const { return m_tableSize; }
+
+    void setAdaptiveTableSize(bool enabled) { m_adaptiveTableSize = enabled; }
+    bool getAdaptiveTableSize() const { return m_adaptiveTableSize; }
+
+    /**
+     * @brief Enables bucket-load and hash-collision telemetry.
+     *
+     * Build time is always recorded. Bucket loads cost one pass over the table per
+     * build and query counters one grid lookup per scanned entry, so both are off
+     * by default.
+     */
+    void setCollectStats(bool enabled) { m_collectStats = enabled; }
+    bool getCollectStats() const { return m_collectStats; }
+    SpatialHashStats getStats() const;
+    void resetQueryStats();
+
+    /** @return Smallest power-of-two table the adaptive mode uses for `particleCount`. */
+    static int adaptiveTableSize(int particleCount);
+
+    const std::vector<int>& getCellStart() const { return m_cellStart; }
+    const std::vector<int>& getParticleIndices() const { return m_particleIndices; }
 
-    void setCellSize(double h) { m_cellSize = h; }
-    double getCellSize() const { return m_cellSize; }
 private:
+    static constexpr int kMinParticlesPerThread = 4096;
+    static constexpr int kMinAdaptiveTableSize = 1024;
+    static constexpr int kRadixBits = 11;
+    static constexpr int kRadixBuckets = 1 << kRadixBits;
+
+    // Cell coordinates are combined with large odd multipliers and then run through
+    // an avalanche finalizer, so the low bits used by power-of-two tables are well mixed.
     inline int hashCoords(int x, int y, int z) const {
-    unsigned int h = (static_cast<unsigned int>(x) * 73856093) ^ 
-                     (static_cast<unsigned int>(y) * 19349663) ^ 
-                     (static_cast<unsigned int>(z) * 83492791);
-    return static_cast<int>(h % m_tableSize);
-}
+        uint32_t h = (static_cast<uint32_t>(x) * 0x8da6b343u) ^
+                     (static_cast<uint32_t>(y) * 0xd8163841u) ^
+                     (static_cast<uint32_t>(z) * 0xcb1ab31fu);
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return static_cast<int>(m_tableMask != 0 ? (h & m_tableMask) : (h % static_cast<uint32_t>(m_tableSize)));
+    }
+
+    void setTableSize(int tableSize);
+    void updateBucketStats();
+
+    void appendNeighbors(const Real* px, const Real* py, const Real* pz, bool sorted, const Vector3r& pos,
+                         Real radius, std::vector<int>& outNeighbors) const;
+    void queryRange(const ParticleBuffer& particles, bool sorted, int begin, int end, Real radius,
+                    std::vector<int>& outOffsets, std::vector<int>& outNeighbors) const;
 
-    inline void posToGrid(const Eigen::Vector3d& pos, int& gx, int& gy, int& gz) const {
+    inline void posToGrid(const Vector3r& pos, int& gx, int& gy, int& gz) const {
         gx = static_cast<int>(std::floor(pos.x() / m_cellSize));
         gy = static_cast<int>(std::floor(pos.y() / m_cellSize));
         gz = static_cast<int>(std::floor(pos.z() / m_cellSize));
     }
 
     int m_tableSize;
-    double m_cellSize;
+    uint32_t m_tableMask = 0;
+    Real m_cellSize;
+    bool m_adaptiveTableSize = false;
+    bool m_collectStats = false;
+    SpatialHashStats m_buildStats;
+    mutable std::atomic<long long> m_queryCount{0};
+    mutable std::atomic<long long> m_candidateCount{0};
+    mutable std::atomic<long long> m_collisionCount{0};
     std::vector<int> m_cellStart;
     std::vector<int> m_particleIndices;
-    std::vector<int> m_particleHashes;
+    std::vector<int> m_sortedHashes;        ///< Hash of every slot of m_particleIndices.
+    std::vector<int> m_scratchHashes;
+    std::vector<int> m_scratchIndices;
+    std::vector<int> m_threadHistograms;    ///< kRadixBuckets per build thread.
+    bool m_storeSortedPositions = false;
+    bool m_sortedPositionsValid = false;
+    AlignedVector<Real> m_sortedX;
+    AlignedVector<Real> m_sortedY;
+    AlignedVector<Real> m_sortedZ;
 };
 
 }
\ No newline at end of file
@@ -23,7 +23,7 @@ public:
      * @param radius The radius of the sphere in world units.
      * @param friction The friction coefficient.
      */
-    SphereCollider(const Eigen::Vector3d& center, double radius, double friction);
+    SphereCollider(const Vector3r& center, Real radius, Real friction);
 
     /**
      * @brief Resolves collisions between the sphere and a buffer of particles.
@@ -37,11 +37,14 @@ public:
      * @param particles Reference to the global particle buffer.
      * @param dt Current substep time delta.
      */
-    void resolve(std::vector<Particle>& particles, double dt);
+    void resolve(ParticleBuffer& particles, Real dt) override;
+
+    inline const Vector3r& getCenter() const { return m_center; }
+    inline Real getRadius() const { return m_radius; }
 
 private:
-    Eigen::Vector3d m_center;   ///< The center point of the sphere in 3D space.
-    double m_radius;            ///< Radius of the collision volume. 
+    Vector3r m_center;   ///< The center point of the sphere in 3D space.
+    Real m_radius;            ///< Radius of the collision volume. 
 };
 
 }
\ No newline at end of file
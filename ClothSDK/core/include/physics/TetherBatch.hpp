@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ParticleBuffer.hpp"
+#include "DistanceBatch.hpp"
+#include "utils/AlignedAllocator.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace ClothSDK {
+
+/** @brief Long-range attachments generated by the solver, see Solver::setTethers(). */
+struct TetherSettings {
+    bool enabled = false;
+    Real stretchLimit = Real(1);    ///< Allowed tether length as a multiple of the geodesic rest distance.
+};
+
+/**
+ * @class TetherBatch
+ * @brief Long-range attachment constraints between free particles and pinned ones.
+ *
+ * Every free particle that can reach a pinned particle through distance
+ * constraints is tethered to the nearest one, measured along the constraint
+ * graph with the rest lengths as edge weights. A tether is unilateral: it only
+ * acts once the particle is farther from its anchor than the geodesic rest
+ * distance times the stretch limit, and then moves the particle straight back
+ * onto that sphere. Because the correction reaches every particle in one
+ * projection, hanging cloth stops sagging after one or two iterations where
+ * distance constraints alone need many more to carry the load edge by edge.
+ *
+ * Each particle has at most one tether and anchors have zero inverse mass, so
+ * every tether writes a different particle and the batch is projected in
+ * parallel without coloring.
+ */
+class TetherBatch {
+public:
+    /**
+     * @brief Rebuilds the tethers from the current pins and distance constraints.
+     *
+     * Runs a multi-source Dijkstra from every particle with zero inverse mass.
+     *
+     * @param particles Solver particle buffer; pins are read from its inverse masses.
+     * @param distances Distance constraints whose rest lengths define the geodesic distances.
+     * @param stretchLimit Multiplier of the geodesic distance, at least 1.
+     */
+    void build(const ParticleBuffer& particles, const DistanceBatch& distances, Real stretchLimit);
+
+    /** @brief Removes every tether. */
+    void clear();
+
+    /**
+     * @brief Pulls every particle that strayed too far from its anchor back onto the tether sphere.
+     *
+     * @param particles Solver particle buffer.
+     * @param awake One flag per particle, nonzero when awake; nullptr projects every tether.
+     */
+    void solve(ParticleBuffer& particles, const uint8_t* awake) const;
+
+    inline int size() const { return static_cast<int>(m_particle.size()); }
+    inline const int* particle() const { return m_particle.data(); }
+    inline const int* anchor() const { return m_anchor.data(); }
+    inline const Real* maxLength() const { return m_maxLength.data(); }
+
+private:
+    AlignedVector<int> m_particle;
+    AlignedVector<int> m_anchor;
+    AlignedVector<Real> m_maxLength;
+};
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ClothSDK {
+
+/**
+ * @class AlignedAllocator
+ * @brief Minimal STL allocator returning storage aligned to a fixed boundary.
+ *
+ * Used by the structure-of-arrays buffers so that every component array starts
+ * on a cache line and can be loaded with aligned SIMD instructions.
+ *
+ * @tparam T Element type.
+ * @tparam Alignment Alignment in bytes, must be a power of two.
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* ptr, std::size_t) noexcept {
+        ::operator delete(ptr, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+/** @brief Contiguous vector whose storage starts on a 64-byte boundary. */
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+}
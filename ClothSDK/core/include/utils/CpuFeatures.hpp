@@ -0,0 +1,36 @@
+#pragma once
+
+namespace ClothSDK {
+
+/**
+ * @brief Vector instruction sets the hand-written kernels can target.
+ */
+enum class SimdLevel {
+    Scalar, ///< Portable scalar code.
+    AVX2,   ///< 256-bit lanes, four doubles or eight floats per instruction.
+    AVX512  ///< 512-bit lanes, eight doubles or sixteen floats per instruction.
+};
+
+/**
+ * @brief Queries the running CPU for the widest supported SIMD level.
+ *
+ * The result is computed once and cached. Builds for non-x86 targets or
+ * compilers without function multi-versioning always report Scalar.
+ *
+ * @return Best SimdLevel available at runtime.
+ */
+inline SimdLevel detectSimdLevel() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+}
@@ -1,6 +1,8 @@
 #include "engine/ClothMesh.hpp"
+#include "engine/MeshTopology.hpp"
 #include "physics/Solver.hpp"
 #include "physics/Particle.hpp"
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 
@@ -9,14 +11,14 @@ namespace ClothSDK {
 ClothMesh::ClothMesh() 
 : m_density(1.0), m_structuralCompliance(0.8), m_shearCompliance(0.5), m_bendingCompliance(0.2), m_cols(0), m_rows(0) {} 
 
-void ClothMesh::initGrid(int rows, int cols, double spacing, Solver& solver) {
+void ClothMesh::initGrid(int rows, int cols, Real spacing, Solver& solver) {
     m_rows = rows;
     m_cols = cols;
     m_triangles.clear();
 
     for(int r = 0; r < m_rows; r++) {
         for(int c = 0; c < m_cols; c++) {
-            Eigen::Vector3d pos(c * spacing, r * spacing, 0.0);
+            Vector3r pos(c * spacing, r * spacing, 0.0);
             int id = solver.addParticle(Particle(pos));
             m_particlesIndices.push_back(id);
         }
@@ -61,18 +63,16 @@ void ClothMesh::initGrid(int rows, int cols, double spacing, Solver& solver) {
         }
     }
 
-    const std::vector<Particle>& particles = solver.getParticles();
+    const ParticleBuffer& particles = solver.getParticles();
 
     for(auto& triangle : m_triangles) {
-        const Particle& pA = particles[triangle.a];
-        const Particle& pB = particles[triangle.b];
-        const Particle& pC = particles[triangle.c];
+        Vector3r pA = particles.getPosition(triangle.a);
 
-        Eigen::Vector3d vA = pB.getPosition() - pA.getPosition();
-        Eigen::Vector3d vB = pC.getPosition() - pA.getPosition();
+        Vector3r vA = particles.getPosition(triangle.b) - pA;
+        Vector3r vB = particles.getPosition(triangle.c) - pA;
 
-        double area = 0.5 * vA.cross(vB).norm();
-        double massPerVertex = (area * m_density) / 3.0;
+        Real area = 0.5 * vA.cross(vB).norm();
+        Real massPerVertex = (area * m_density) / 3.0;
 
         solver.addMassToParticle(triangle.a, massPerVertex);
         solver.addMassToParticle(triangle.b, massPerVertex);
@@ -81,7 +81,7 @@ void ClothMesh::initGrid(int rows, int cols, double spacing, Solver& solver) {
     }
 }
 
-void ClothMesh::setMaterial(double density, double stretch, double shear, double bend) {
+void ClothMesh::setMaterial(Real density, Real stretch, Real shear, Real bend) {
     m_density = density;
     m_structuralCompliance = stretch;
     m_shearCompliance = shear;
@@ -97,30 +97,41 @@ void ClothMesh::exportToOBJ(const std::string& filename, const Solver& solver) c
     std::ofstream file(filename);
     if (!file.is_open()) return;
 
-    const std::vector<Particle>& particles = solver.getParticles();
+    const ParticleBuffer& particles = solver.getParticles();
 
     for (int id : m_particlesIndices) {
-        const Eigen::Vector3d& pos = particles[id].getPosition();
+        Vector3r pos = particles.getPosition(id);
         
         file << "v " << pos.x() << " " << pos.y() << " " << pos.z() << "\n";
     }
 
+    // Triangles hold solver ids; write them back in terms of the exported vertex order.
+    std::vector<int> localIndex(particles.size(), -1);
+    for (size_t v = 0; v < m_particlesIndices.size(); ++v)
+        localIndex[m_particlesIndices[v]] = static_cast<int>(v);
+
     for (const auto& t : m_triangles) {
-        file << "f " << t.a + 1 << " " << t.b + 1 << " " << t.c + 1 << "\n";
+        file << "f " << localIndex[t.a] + 1 << " " << localIndex[t.b] + 1 << " " << localIndex[t.c] + 1 << "\n";
     }
 
     file.close();
 }
 
-void ClothMesh::buildFromMesh(const std::vector<Eigen::Vector3d>& positions, const std::vector<int>& indices, Solver& solver) {
-    std::map<Edge, std::vector<int>> edgeToTriangles;
+void ClothMesh::buildFromMesh(const std::vector<Vector3r>& positions, const std::vector<int>& indices, Solver& solver) {
     m_particlesIndices.clear();
     m_triangles.clear();
 
-    for (auto& position : positions) {
-        auto id = solver.addParticle(Particle(position));
-        m_particlesIndices.push_back(id);
-    }
+    // m_particlesIndices stays indexed by file vertex, whatever order the particles are created in.
+    const std::vector<int> order = MeshReordering::compute(m_ordering, positions, indices);
+    std::vector<Real> coordinates;
+    coordinates.reserve(order.size() * 3);
+    for (int vertex : order)
+        coordinates.insert(coordinates.end(), positions[vertex].data(), positions[vertex].data() + 3);
+
+    const int first = solver.addParticles(coordinates.data(), static_cast<int>(order.size()));
+    m_particlesIndices.assign(positions.size(), -1);
+    for (size_t k = 0; k < order.size(); ++k)
+        m_particlesIndices[order[k]] = first + static_cast<int>(k);
 
     std::vector<int> solver_indices;
     solver_indices.reserve(indices.size());
@@ -130,38 +141,39 @@ void ClothMesh::buildFromMesh(const std::vector<Eigen::Vector3d>& positions, con
     }
 
     for (size_t i = 0; i < solver_indices.size(); i += 3) {
-        auto vA = solver_indices[i];
-        auto vB = solver_indices[i + 1];
-        auto vC = solver_indices[i + 2];
-
-        m_triangles.push_back({vA, vB, vC});
-        int id = m_triangles.size() - 1;
+        m_triangles.push_back({solver_indices[i], solver_indices[i + 1], solver_indices[i + 2]});
+    }
 
-        Edge edges[3] = { {vA, vB}, {vB, vC}, {vC, vA} };
+    const bool reordered = m_ordering != MeshOrdering::None;
+    if (reordered) {
+        std::stable_sort(m_triangles.begin(), m_triangles.end(), [](const Triangle& x, const Triangle& y) {
+            return std::min({x.a, x.b, x.c}) < std::min({y.a, y.b, y.c});
+        });
+    }
 
-        for (auto& edge : edges) {
-            if (edgeToTriangles.find(edge) == edgeToTriangles.end()) 
-                solver.addDistanceConstraint(edge.v1, edge.v2, m_structuralCompliance);
-            edgeToTriangles[edge].push_back(id);
+    const MeshTopology topology = MeshTopology::build(static_cast<int>(solver.getParticles().size()), m_triangles);
+
+    // Reordered meshes emit their edges sorted by first particle, others in file order.
+    if (reordered) {
+        solver.addDistanceConstraints(topology.edges.data(), m_structuralCompliance, topology.edgeCount());
+    } else {
+        std::vector<int> pairs(topology.edges.size());
+        for (int k = 0; k < topology.edgeCount(); ++k) {
+            const int edge = topology.discoveryOrder[k];
+            pairs[2 * k] = topology.edges[2 * edge];
+            pairs[2 * k + 1] = topology.edges[2 * edge + 1];
         }
+        solver.addDistanceConstraints(pairs.data(), m_structuralCompliance, topology.edgeCount());
     }
 
-    for (auto const& [key, triList] : edgeToTriangles) {
-        if (triList.size() == 2) {
-            int v1 = key.v1;
-            int v2 = key.v2;
-
-            const Triangle& t1 = m_triangles[triList[0]];
-            const Triangle& t2 = m_triangles[triList[1]];
-
-            int v3 = getOppositeVertex(t1, v1, v2);
-            int v4 = getOppositeVertex(t2, v1, v2);
-
-            double initialAngle = calculateInitialAngle(v1, v2, v3, v4, solver);
-
-            solver.addBendingConstraint(v1, v2, v3, v4, initialAngle, m_bendingCompliance);
-        }
+    const int dihedralCount = topology.dihedralCount();
+    std::vector<Real> restAngles(dihedralCount);
+    #pragma omp parallel for schedule(static) if(dihedralCount > 4096)
+    for (int k = 0; k < dihedralCount; ++k) {
+        const int* d = &topology.dihedrals[4 * k];
+        restAngles[k] = calculateInitialAngle(d[0], d[1], d[2], d[3], solver);
     }
+    solver.addBendingConstraints(topology.dihedrals.data(), restAngles.data(), m_bendingCompliance, dihedralCount);
 
     const auto& particles = solver.getParticles();
 
@@ -170,15 +182,13 @@ void ClothMesh::buildFromMesh(const std::vector<Eigen::Vector3d>& positions, con
     }
 
     for(auto& triangle : m_triangles) {
-        const Particle& pA = particles[triangle.a];
-        const Particle& pB = particles[triangle.b];
-        const Particle& pC = particles[triangle.c];
+        Vector3r pA = particles.getPosition(triangle.a);
 
-        Eigen::Vector3d vA = pB.getPosition() - pA.getPosition();
-        Eigen::Vector3d vB = pC.getPosition() - pA.getPosition();
+        Vector3r vA = particles.getPosition(triangle.b) - pA;
+        Vector3r vB = particles.getPosition(triangle.c) - pA;
 
-        double area = 0.5 * vA.cross(vB).norm();
-        double massPerVertex = (area * m_density) / 3.0;
+        Real area = 0.5 * vA.cross(vB).norm();
+        Real massPerVertex = (area * m_density) / 3.0;
 
         solver.addMassToParticle(triangle.a, massPerVertex);
         solver.addMassToParticle(triangle.b, massPerVertex);
@@ -187,34 +197,28 @@ void ClothMesh::buildFromMesh(const std::vector<Eigen::Vector3d>& positions, con
     }
 }
 
-int ClothMesh::getOppositeVertex(const Triangle& tri, int v1, int v2) const{
-    if (tri.a != v1 && tri.a != v2) return tri.a;
-    if (tri.b != v1 && tri.b != v2) return tri.b;
-    return tri.c;
-}
-
-double ClothMesh::calculateInitialAngle(int id1, int id2, int id3, int id4, const Solver& solver) const {
+Real ClothMesh::calculateInitialAngle(int id1, int id2, int id3, int id4, const Solver& solver) const {
     const auto& particles = solver.getParticles();
     
-    const Eigen::Vector3d& p1 = particles[id1].getPosition();
-    const Eigen::Vector3d& p2 = particles[id2].getPosition(); 
-    const Eigen::Vector3d& p3 = particles[id3].getPosition(); 
-    const Eigen::Vector3d& p4 = particles[id4].getPosition(); 
+    Vector3r p1 = particles.getPosition(id1);
+    Vector3r p2 = particles.getPosition(id2); 
+    Vector3r p3 = particles.getPosition(id3); 
+    Vector3r p4 = particles.getPosition(id4); 
 
-    Eigen::Vector3d e = p2 - p1;
+    Vector3r e = p2 - p1;
     if (e.isZero(1e-6)) return 0.0; 
 
-    Eigen::Vector3d n1 = e.cross(p3 - p1);
-    Eigen::Vector3d n2 = (p4 - p1).cross(e); 
+    Vector3r n1 = e.cross(p3 - p1);
+    Vector3r n2 = (p4 - p1).cross(e); 
 
-    double len1 = n1.norm();
-    double len2 = n2.norm();
+    Real len1 = n1.norm();
+    Real len2 = n2.norm();
 
     if (len1 < 1e-6 || len2 < 1e-6) return 0.0; 
 
-    double cosTheta = n1.dot(n2) / (len1 * len2);
+    Real cosTheta = n1.dot(n2) / (len1 * len2);
     
-    return std::acos(std::clamp(cosTheta, -1.0, 1.0));
+    return std::acos(std::clamp(cosTheta, Real(-1), Real(1)));
 }
 
 
@@ -0,0 +1,151 @@
+#include "engine/MeshReordering.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+
+namespace ClothSDK {
+
+namespace {
+
+// Spreads the low 21 bits of v so that there are two zero bits between each of them.
+uint64_t expandBits(uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8) & 0x100f00f00f00f00fULL;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+}
+
+}
+
+std::vector<int> MeshReordering::morton(const std::vector<Vector3r>& positions) {
+    const int count = static_cast<int>(positions.size());
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    if (count == 0)
+        return order;
+
+    Vector3r lower = positions[0];
+    Vector3r upper = positions[0];
+    for (const Vector3r& p : positions) {
+        lower = lower.cwiseMin(p);
+        upper = upper.cwiseMax(p);
+    }
+
+    const Real extent = (upper - lower).maxCoeff();
+    const Real scale = extent > 0 ? Real(0x1fffff) / extent : Real(0);
+
+    std::vector<uint64_t> codes(count);
+    for (int i = 0; i < count; ++i) {
+        Vector3r q = ((positions[i] - lower) * scale).cwiseMin(Real(0x1fffff));
+        codes[i] = expandBits(static_cast<uint64_t>(q.x())) |
+                   expandBits(static_cast<uint64_t>(q.y())) << 1 |
+                   expandBits(static_cast<uint64_t>(q.z())) << 2;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&codes](int a, int b) { return codes[a] < codes[b]; });
+    return order;
+}
+
+std::vector<int> MeshReordering::reverseCuthillMcKee(int vertexCount, const std::vector<int>& indices) {
+    // Vertex graph in compressed rows; duplicate neighbors are harmless for a BFS.
+    std::vector<int> offsets(vertexCount + 1, 0);
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        for (int e = 0; e < 3; ++e)
+            offsets[indices[t + e] + 1] += 2;
+    }
+    for (int v = 0; v < vertexCount; ++v)
+        offsets[v + 1] += offsets[v];
+
+    std::vector<int> neighbors(offsets[vertexCount]);
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const int tri[3] = {indices[t], indices[t + 1], indices[t + 2]};
+        for (int e = 0; e < 3; ++e) {
+            const int v = tri[e];
+            neighbors[cursor[v]++] = tri[(e + 1) % 3];
+            neighbors[cursor[v]++] = tri[(e + 2) % 3];
+        }
+    }
+
+    std::vector<int> degree(vertexCount);
+    for (int v = 0; v < vertexCount; ++v) {
+        std::sort(neighbors.begin() + offsets[v], neighbors.begin() + offsets[v + 1]);
+        auto last = std::unique(neighbors.begin() + offsets[v], neighbors.begin() + offsets[v + 1]);
+        degree[v] = static_cast<int>(last - (neighbors.begin() + offsets[v]));
+    }
+
+    std::vector<int> byDegree(vertexCount);
+    std::iota(byDegree.begin(), byDegree.end(), 0);
+    std::stable_sort(byDegree.begin(), byDegree.end(), [&degree](int a, int b) { return degree[a] < degree[b]; });
+
+    std::vector<int> order;
+    order.reserve(vertexCount);
+    std::vector<char> visited(vertexCount, 0);
+    std::vector<int> isolated;
+    std::vector<int> frontier;
+
+    for (int start : byDegree) {
+        if (visited[start])
+            continue;
+        if (degree[start] == 0) {
+            isolated.push_back(start);
+            visited[start] = 1;
+            continue;
+        }
+
+        size_t head = order.size();
+        order.push_back(start);
+        visited[start] = 1;
+
+        while (head < order.size()) {
+            const int v = order[head++];
+            frontier.clear();
+            for (int k = offsets[v]; k < offsets[v] + degree[v]; ++k) {
+                const int n = neighbors[k];
+                if (!visited[n]) {
+                    visited[n] = 1;
+                    frontier.push_back(n);
+                }
+            }
+            std::stable_sort(frontier.begin(), frontier.end(), [&degree](int a, int b) { return degree[a] < degree[b]; });
+            order.insert(order.end(), frontier.begin(), frontier.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    std::sort(isolated.begin(), isolated.end());
+    order.insert(order.end(), isolated.begin(), isolated.end());
+    return order;
+}
+
+std::vector<int> MeshReordering::compute(MeshOrdering ordering, const std::vector<Vector3r>& positions,
+                                         const std::vector<int>& indices) {
+    switch (ordering) {
+        case MeshOrdering::Morton:
+            return morton(positions);
+        case MeshOrdering::ReverseCuthillMcKee:
+            return reverseCuthillMcKee(static_cast<int>(positions.size()), indices);
+        case MeshOrdering::None:
+        default: {
+            std::vector<int> order(positions.size());
+            std::iota(order.begin(), order.end(), 0);
+            return order;
+        }
+    }
+}
+
+int MeshReordering::bandwidth(const std::vector<int>& indices) {
+    int result = 0;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        result = std::max(result, std::abs(indices[t] - indices[t + 1]));
+        result = std::max(result, std::abs(indices[t + 1] - indices[t + 2]));
+        result = std::max(result, std::abs(indices[t + 2] - indices[t]));
+    }
+    return result;
+}
+
+}
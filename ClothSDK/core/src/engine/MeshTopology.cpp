@@ -0,0 +1,138 @@
+#include "engine/MeshTopology.hpp"
+#include <algorithm>
+
+namespace ClothSDK {
+
+namespace {
+
+constexpr int kParallelThreshold = 4096;
+
+int cornerOf(const Triangle& t, int corner) {
+    return corner == 0 ? t.a : (corner == 1 ? t.b : t.c);
+}
+
+// Half-edge h runs from corner h % 3 to the next corner of triangle h / 3.
+void halfEdgeVertices(const std::vector<Triangle>& triangles, int h, int& lo, int& hi) {
+    const Triangle& t = triangles[h / 3];
+    const int from = cornerOf(t, h % 3);
+    const int to = cornerOf(t, (h + 1) % 3);
+    lo = std::min(from, to);
+    hi = std::max(from, to);
+}
+
+int oppositeVertex(const Triangle& t, int v1, int v2) {
+    if (t.a != v1 && t.a != v2) return t.a;
+    if (t.b != v1 && t.b != v2) return t.b;
+    return t.c;
+}
+
+}
+
+MeshTopology MeshTopology::build(int vertexCount, const std::vector<Triangle>& triangles) {
+    MeshTopology topology;
+    const int halfEdgeCount = static_cast<int>(triangles.size()) * 3;
+
+    // Counting sort of half-edges by their smaller vertex. The scatter runs in
+    // increasing half-edge order, so every bucket starts out sorted by triangle.
+    std::vector<int> upper(halfEdgeCount);
+    std::vector<int> bucketStart(vertexCount + 1, 0);
+    for (int h = 0; h < halfEdgeCount; ++h) {
+        int lo, hi;
+        halfEdgeVertices(triangles, h, lo, hi);
+        upper[h] = hi;
+        ++bucketStart[lo + 1];
+    }
+    for (int v = 0; v < vertexCount; ++v)
+        bucketStart[v + 1] += bucketStart[v];
+
+    std::vector<int> sorted(halfEdgeCount);
+    {
+        std::vector<int> cursor(bucketStart.begin(), bucketStart.end() - 1);
+        for (int h = 0; h < halfEdgeCount; ++h) {
+            int lo, hi;
+            halfEdgeVertices(triangles, h, lo, hi);
+            sorted[cursor[lo]++] = h;
+        }
+    }
+
+    // Buckets are as small as the vertex valence: a stable insertion sort on the
+    // larger vertex groups duplicate edges while keeping triangle order inside each group.
+    std::vector<int> edgesPerVertex(vertexCount + 1, 0);
+    #pragma omp parallel for schedule(static) if(vertexCount > kParallelThreshold)
+    for (int v = 0; v < vertexCount; ++v) {
+        const int begin = bucketStart[v];
+        const int end = bucketStart[v + 1];
+        for (int i = begin + 1; i < end; ++i) {
+            const int h = sorted[i];
+            int j = i;
+            for (; j > begin && upper[sorted[j - 1]] > upper[h]; --j)
+                sorted[j] = sorted[j - 1];
+            sorted[j] = h;
+        }
+
+        int distinct = 0;
+        for (int i = begin; i < end; ++i) {
+            if (i == begin || upper[sorted[i]] != upper[sorted[i - 1]])
+                ++distinct;
+        }
+        edgesPerVertex[v + 1] = distinct;
+    }
+    for (int v = 0; v < vertexCount; ++v)
+        edgesPerVertex[v + 1] += edgesPerVertex[v];
+
+    const int edgeCount = edgesPerVertex[vertexCount];
+    topology.edges.resize(edgeCount * 2);
+    topology.edgeTriangleOffsets.resize(edgeCount + 1);
+    topology.edgeTriangles.resize(halfEdgeCount);
+    topology.edgeTriangleOffsets[edgeCount] = halfEdgeCount;
+
+    // The sorted half-edges already list each edge's triangles contiguously.
+    std::vector<int> edgeOfFirstHalfEdge(halfEdgeCount, -1);
+    #pragma omp parallel for schedule(static) if(vertexCount > kParallelThreshold)
+    for (int v = 0; v < vertexCount; ++v) {
+        int edge = edgesPerVertex[v] - 1;
+        for (int i = bucketStart[v]; i < bucketStart[v + 1]; ++i) {
+            const int h = sorted[i];
+            if (i == bucketStart[v] || upper[h] != upper[sorted[i - 1]]) {
+                ++edge;
+                topology.edges[2 * edge] = v;
+                topology.edges[2 * edge + 1] = upper[h];
+                topology.edgeTriangleOffsets[edge] = i;
+                edgeOfFirstHalfEdge[h] = edge;
+            }
+            topology.edgeTriangles[i] = h / 3;
+        }
+    }
+
+    topology.discoveryOrder.reserve(edgeCount);
+    for (int h = 0; h < halfEdgeCount; ++h) {
+        if (edgeOfFirstHalfEdge[h] >= 0)
+            topology.discoveryOrder.push_back(edgeOfFirstHalfEdge[h]);
+    }
+
+    std::vector<int> dihedralOffsets(edgeCount + 1, 0);
+    for (int e = 0; e < edgeCount; ++e) {
+        const bool shared = topology.edgeTriangleOffsets[e + 1] - topology.edgeTriangleOffsets[e] == 2;
+        dihedralOffsets[e + 1] = dihedralOffsets[e] + (shared ? 1 : 0);
+    }
+
+    topology.dihedrals.resize(dihedralOffsets[edgeCount] * 4);
+    #pragma omp parallel for schedule(static) if(edgeCount > kParallelThreshold)
+    for (int e = 0; e < edgeCount; ++e) {
+        if (dihedralOffsets[e + 1] == dihedralOffsets[e])
+            continue;
+
+        const int v1 = topology.edges[2 * e];
+        const int v2 = topology.edges[2 * e + 1];
+        const int first = topology.edgeTriangleOffsets[e];
+        int* out = &topology.dihedrals[dihedralOffsets[e] * 4];
+        out[0] = v1;
+        out[1] = v2;
+        out[2] = oppositeVertex(triangles[topology.edgeTriangles[first]], v1, v2);
+        out[3] = oppositeVertex(triangles[topology.edgeTriangles[first + 1]], v1, v2);
+    }
+
+    return topology;
+}
+
+}
@@ -0,0 +1,200 @@
+#include "io/AsyncExporter.hpp"
+#include "engine/ClothMesh.hpp"
+#include "physics/Solver.hpp"
+#include "utils/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace ClothSDK {
+
+bool FrameCacheSink::open(const std::string& filepath, const ClothMesh& mesh, const Solver& solver,
+                          FrameEncoding encoding) {
+    return m_writer.open(filepath, mesh, solver, encoding);
+}
+
+bool FrameCacheSink::write(const float* positions, int, double time) {
+    return m_writer.writePositions(positions, time);
+}
+
+bool FrameCacheSink::close() {
+    return m_writer.close();
+}
+
+ObjSequenceSink::ObjSequenceSink(const std::string& prefix, const ClothMesh& mesh)
+    : m_prefix(prefix) {
+    const std::vector<int>& particleIds = mesh.getParticleIndices();
+    m_vertexCount = static_cast<int>(particleIds.size());
+    const int idCount = particleIds.empty() ? 0 : *std::max_element(particleIds.begin(), particleIds.end()) + 1;
+
+    // Triangles hold solver ids; write them back in terms of the exported vertex order.
+    std::vector<int> localIndex(idCount, -1);
+    for (size_t v = 0; v < particleIds.size(); ++v)
+        localIndex[particleIds[v]] = static_cast<int>(v);
+
+    char line[64];
+    for (const Triangle& t : mesh.getTriangles()) {
+        const int length = std::snprintf(line, sizeof(line), "f %d %d %d\n",
+                                         localIndex[t.a] + 1, localIndex[t.b] + 1, localIndex[t.c] + 1);
+        m_faces.append(line, length);
+    }
+}
+
+bool ObjSequenceSink::write(const float* positions, int frame, double) {
+    char name[16];
+    std::snprintf(name, sizeof(name), "%04d.obj", frame);
+    const std::string filepath = m_prefix + name;
+
+    // %g matches the default stream formatting used by ClothMesh::exportToOBJ().
+    m_text.clear();
+    char line[96];
+    for (int v = 0; v < m_vertexCount; ++v) {
+        const float* p = positions + 3 * v;
+        const int length = std::snprintf(line, sizeof(line), "v %g %g %g\n", p[0], p[1], p[2]);
+        m_text.append(line, length);
+    }
+    m_text += m_faces;
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        Logger::error("AsyncExporter: cannot create " + filepath);
+        return false;
+    }
+    file.write(m_text.data(), static_cast<std::streamsize>(m_text.size()));
+    return static_cast<bool>(file);
+}
+
+AsyncExporter::~AsyncExporter() {
+    finish();
+}
+
+bool AsyncExporter::start(const ClothMesh& mesh, std::unique_ptr<ExportSink> sink, int queueDepth) {
+    finish();
+
+    if (!sink || queueDepth < 1 || mesh.getParticleIndices().empty()) {
+        Logger::error("AsyncExporter: needs a sink, a non-empty mesh and a queue depth of at least 1");
+        return false;
+    }
+
+    m_sink = std::move(sink);
+    m_particleIds = mesh.getParticleIndices();
+    m_slots.assign(queueDepth, Slot{});
+    m_free.clear();
+    m_ready.clear();
+    for (int s = 0; s < queueDepth; ++s) {
+        m_slots[s].positions.resize(3 * m_particleIds.size());
+        m_free.push_back(s);
+    }
+
+    m_stopping = false;
+    m_failed = false;
+    m_written = 0;
+    m_published = 0;
+    m_stallSeconds = 0.0;
+    m_worker = std::thread(&AsyncExporter::run, this);
+    return true;
+}
+
+bool AsyncExporter::startFrameCache(const std::string& filepath, const ClothMesh& mesh, const Solver& solver,
+                                    FrameEncoding encoding, int queueDepth) {
+    finish();
+    auto sink = std::make_unique<FrameCacheSink>();
+    if (!sink->open(filepath, mesh, solver, encoding))
+        return false;
+    return start(mesh, std::move(sink), queueDepth);
+}
+
+bool AsyncExporter::startObjSequence(const std::string& prefix, const ClothMesh& mesh, int queueDepth) {
+    return start(mesh, std::make_unique<ObjSequenceSink>(prefix, mesh), queueDepth);
+}
+
+bool AsyncExporter::publish(const Solver& solver, double time) {
+    if (!m_worker.joinable())
+        return false;
+
+    int slot;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_free.empty()) {
+            const auto begin = std::chrono::steady_clock::now();
+            m_slotFreed.wait(lock, [this] { return !m_free.empty() || m_failed; });
+            m_stallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        }
+        if (m_failed)
+            return false;
+        slot = m_free.front();
+        m_free.pop_front();
+    }
+
+    // The slot belongs to this thread until it is queued, so the copy runs unlocked.
+    const ParticleBuffer& particles = solver.getParticles();
+    const Real* px = particles.posX();
+    const Real* py = particles.posY();
+    const Real* pz = particles.posZ();
+    float* out = m_slots[slot].positions.data();
+    for (size_t v = 0; v < m_particleIds.size(); ++v) {
+        const int id = m_particleIds[v];
+        out[3 * v] = static_cast<float>(px[id]);
+        out[3 * v + 1] = static_cast<float>(py[id]);
+        out[3 * v + 2] = static_cast<float>(pz[id]);
+    }
+    m_slots[slot].frame = m_published++;
+    m_slots[slot].time = time;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.push_back(slot);
+    }
+    m_frameReady.notify_one();
+    return true;
+}
+
+bool AsyncExporter::finish() {
+    if (!m_worker.joinable())
+        return !m_failed;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_frameReady.notify_one();
+    m_worker.join();
+
+    if (!m_sink->close())
+        m_failed = true;
+    m_sink.reset();
+    if (m_failed)
+        Logger::error("AsyncExporter: export failed after " + std::to_string(m_written) + " frames");
+    return !m_failed;
+}
+
+void AsyncExporter::run() {
+    for (;;) {
+        int slot;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_frameReady.wait(lock, [this] { return !m_ready.empty() || m_stopping; });
+            if (m_ready.empty())
+                return;
+            slot = m_ready.front();
+            m_ready.pop_front();
+        }
+
+        const Slot& frame = m_slots[slot];
+        if (!m_failed) {
+            if (m_sink->write(frame.positions.data(), frame.frame, frame.time))
+                ++m_written;
+            else
+                m_failed = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(slot);
+        }
+        m_slotFreed.notify_one();
+    }
+}
+
+}
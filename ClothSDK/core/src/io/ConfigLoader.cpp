@@ -28,6 +28,35 @@ bool ConfigLoader::load(const std::string& filepath, Solver& solver, ClothMesh&
         if (sim.contains("gravity")) {
             solver.setGravity(jsonToVector(sim["gravity"]));
         }
+
+        if (sim.contains("adaptive_substeps")) {
+            auto adaptive = sim["adaptive_substeps"];
+            AdaptiveSubstepping settings;
+            settings.enabled = adaptive.value("enabled", true);
+            settings.minSubsteps = adaptive.value("min", settings.minSubsteps);
+            settings.maxSubsteps = adaptive.value("max", settings.maxSubsteps);
+            settings.maxDisplacement = adaptive.value("max_displacement", settings.maxDisplacement);
+            settings.maxResidual = adaptive.value("max_residual", settings.maxResidual);
+            settings.relaxRatio = adaptive.value("relax_ratio", settings.relaxRatio);
+            solver.setAdaptiveSubstepping(settings);
+        }
+
+        if (sim.contains("sleeping")) {
+            auto sleeping = sim["sleeping"];
+            SleepSettings settings;
+            settings.enabled = sleeping.value("enabled", true);
+            settings.velocityThreshold = sleeping.value("velocity_threshold", settings.velocityThreshold);
+            settings.substeps = sleeping.value("substeps", settings.substeps);
+            solver.setSleeping(settings);
+        }
+
+        if (sim.contains("tethers")) {
+            auto tethers = sim["tethers"];
+            TetherSettings settings;
+            settings.enabled = tethers.value("enabled", true);
+            settings.stretchLimit = tethers.value("stretch_limit", settings.stretchLimit);
+            solver.setTethers(settings);
+        }
     }
 
     if (data.contains("material")) {
@@ -42,13 +71,23 @@ bool ConfigLoader::load(const std::string& filepath, Solver& solver, ClothMesh&
         );
     }
 
+    if (data.contains("mesh")) {
+        const std::string ordering = data["mesh"].value("ordering", "none");
+        if (ordering == "morton")
+            mesh.setOrdering(MeshOrdering::Morton);
+        else if (ordering == "rcm")
+            mesh.setOrdering(MeshOrdering::ReverseCuthillMcKee);
+        else
+            mesh.setOrdering(MeshOrdering::None);
+    }
+
     if (data.contains("aerodynamics")) {
         auto aero = data["aerodynamics"];
 
         if (aero.contains("wind_velocity")) {
             solver.setWind(jsonToVector(aero["wind_velocity"]));
         } else {
-            solver.setWind(Eigen::Vector3d(5.0, 0.0, 0.0));
+            solver.setWind(Vector3r(5.0, 0.0, 0.0));
         }
         solver.setAirDensity(aero.value("air_density", 0.1));
     }
@@ -72,10 +111,33 @@ bool ConfigLoader::save(const std::string& filepath, const Solver& solver, Cloth
     data["simulation"]["iterations"] = solver.getIterations();
     data["simulation"]["gravity"] = vectorToJson(solver.getGravity());
 
+    const AdaptiveSubstepping& adaptive = solver.getAdaptiveSubstepping();
+    data["simulation"]["adaptive_substeps"]["enabled"] = adaptive.enabled;
+    data["simulation"]["adaptive_substeps"]["min"] = adaptive.minSubsteps;
+    data["simulation"]["adaptive_substeps"]["max"] = adaptive.maxSubsteps;
+    data["simulation"]["adaptive_substeps"]["max_displacement"] = adaptive.maxDisplacement;
+    data["simulation"]["adaptive_substeps"]["max_residual"] = adaptive.maxResidual;
+    data["simulation"]["adaptive_substeps"]["relax_ratio"] = adaptive.relaxRatio;
+
+    const SleepSettings& sleeping = solver.getSleeping();
+    data["simulation"]["sleeping"]["enabled"] = sleeping.enabled;
+    data["simulation"]["sleeping"]["velocity_threshold"] = sleeping.velocityThreshold;
+    data["simulation"]["sleeping"]["substeps"] = sleeping.substeps;
+
+    const TetherSettings& tethers = solver.getTethers();
+    data["simulation"]["tethers"]["enabled"] = tethers.enabled;
+    data["simulation"]["tethers"]["stretch_limit"] = tethers.stretchLimit;
+
     data["material"]["compliance"]["structural"] = mesh.getStructuralCompliance();
     data["material"]["compliance"]["shear"] = mesh.getShearCompliance();
     data["material"]["compliance"]["bending"] = mesh.getBendingCompliance();
 
+    switch (mesh.getOrdering()) {
+        case MeshOrdering::Morton: data["mesh"]["ordering"] = "morton"; break;
+        case MeshOrdering::ReverseCuthillMcKee: data["mesh"]["ordering"] = "rcm"; break;
+        default: data["mesh"]["ordering"] = "none"; break;
+    }
+
     data["aerodynamics"]["wind_velocity"] = vectorToJson(solver.getWind());
     data["aerodynamics"]["air_density"] = solver.getAirDensity();
 
@@ -86,15 +148,15 @@ bool ConfigLoader::save(const std::string& filepath, const Solver& solver, Cloth
     return true;
 }
 
-Eigen::Vector3d ConfigLoader::jsonToVector(const nlohmann::json& json) {
+Vector3r ConfigLoader::jsonToVector(const nlohmann::json& json) {
     if (!json.is_array() || json.size() != 3)
-        return Eigen::Vector3d::Zero();
+        return Vector3r::Zero();
 
-    Eigen::Vector3d pos(json[0].get<double>(), json[1].get<double>(), json[2].get<double>());
+    Vector3r pos(json[0].get<Real>(), json[1].get<Real>(), json[2].get<Real>());
     return pos;
 }
 
-nlohmann::json ConfigLoader::vectorToJson(const Eigen::Vector3d& vector) {
+nlohmann::json ConfigLoader::vectorToJson(const Vector3r& vector) {
     return nlohmann::json{ vector.x(), vector.y(), vector.z() };
 }
 
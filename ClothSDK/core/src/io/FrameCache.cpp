@@ -0,0 +1,391 @@
+#include "io/FrameCache.hpp"
+#include "engine/ClothMesh.hpp"
+#include "physics/Solver.hpp"
+#include "utils/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ClothSDK {
+
+static_assert(sizeof(FrameCacheHeader) == 64, "FrameCacheHeader must stay 64 bytes");
+static_assert(sizeof(FrameCacheBlock) == 24, "FrameCacheBlock must stay 24 bytes");
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'L', 'T', 'H', 'C', 'A', 'C', 'H'};
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::size_t bytesPerValue(FrameEncoding encoding) {
+    return encoding == FrameEncoding::Float32 ? sizeof(float) : sizeof(uint16_t);
+}
+
+uint64_t topologyEnd(uint64_t triangles, uint64_t vertices) {
+    return sizeof(FrameCacheHeader) + 3 * triangles * sizeof(int32_t) + 3 * vertices * sizeof(float);
+}
+
+// IEEE 754 binary16 conversion with round-to-nearest-even.
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    const uint32_t magnitude = bits & 0x7fffffff;
+
+    if (magnitude >= 0x7f800000)
+        return sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0);
+    if (magnitude >= 0x477ff000)
+        return sign | 0x7c00;
+
+    if (magnitude < 0x38800000) {
+        if (magnitude < 0x33000000)
+            return sign;
+        const uint32_t shift = 126 - (magnitude >> 23);
+        const uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+        uint32_t result = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (result & 1)))
+            ++result;
+        return sign | static_cast<uint16_t>(result);
+    }
+
+    uint32_t result = (magnitude - 0x38000000) >> 13;
+    const uint32_t remainder = magnitude & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1)))
+        ++result;
+    return sign | static_cast<uint16_t>(result);
+}
+
+float halfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        exponent = 113;
+        while (!(mantissa & 0x400)) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+}
+
+FrameCacheWriter::~FrameCacheWriter() {
+    close();
+}
+
+bool FrameCacheWriter::open(const std::string& filepath, const ClothMesh& mesh, const Solver& solver,
+                            FrameEncoding encoding) {
+    close();
+
+    const std::vector<int>& particleIds = mesh.getParticleIndices();
+    const std::vector<Triangle>& triangles = mesh.getTriangles();
+    const ParticleBuffer& particles = solver.getParticles();
+    if (particleIds.empty()) {
+        Logger::error("FrameCache: mesh has no vertices");
+        return false;
+    }
+
+    // Triangles hold solver ids; the cache stores them in terms of cached vertices.
+    std::vector<int> localIndex(particles.size(), -1);
+    for (size_t v = 0; v < particleIds.size(); ++v)
+        localIndex[particleIds[v]] = static_cast<int>(v);
+
+    std::vector<int32_t> faces;
+    faces.reserve(3 * triangles.size());
+    for (const Triangle& t : triangles)
+        faces.insert(faces.end(), {localIndex[t.a], localIndex[t.b], localIndex[t.c]});
+
+    m_encoding = encoding;
+    m_particleIds = particleIds;
+    m_rest.resize(3 * m_particleIds.size());
+    for (size_t v = 0; v < m_particleIds.size(); ++v) {
+        const Vector3r p = particles.getPosition(m_particleIds[v]);
+        m_rest[3 * v] = static_cast<float>(p.x());
+        m_rest[3 * v + 1] = static_cast<float>(p.y());
+        m_rest[3 * v + 2] = static_cast<float>(p.z());
+    }
+
+    FrameCacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.encoding = static_cast<uint32_t>(encoding);
+    header.vertexCount = static_cast<uint32_t>(m_particleIds.size());
+    header.triangleCount = static_cast<uint32_t>(triangles.size());
+    header.frameStride = alignUp(sizeof(FrameCacheBlock) + m_rest.size() * bytesPerValue(encoding), 8);
+    header.frameOffset = alignUp(topologyEnd(header.triangleCount, header.vertexCount), 64);
+    header.frameCount = 0;
+
+    m_file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        Logger::error("FrameCache: cannot create " + filepath);
+        return false;
+    }
+
+    const char padding[64] = {};
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(reinterpret_cast<const char*>(faces.data()), faces.size() * sizeof(int32_t));
+    m_file.write(reinterpret_cast<const char*>(m_rest.data()), m_rest.size() * sizeof(float));
+    m_file.write(padding, header.frameOffset - topologyEnd(header.triangleCount, header.vertexCount));
+
+    m_block.assign(header.frameStride, 0);
+    m_frameCount = 0;
+    return static_cast<bool>(m_file);
+}
+
+bool FrameCacheWriter::writeFrame(const Solver& solver, double time) {
+    if (!m_file.is_open())
+        return false;
+
+    const ParticleBuffer& particles = solver.getParticles();
+    const Real* px = particles.posX();
+    const Real* py = particles.posY();
+    const Real* pz = particles.posZ();
+
+    m_frame.resize(m_rest.size());
+    for (size_t v = 0; v < m_particleIds.size(); ++v) {
+        const int id = m_particleIds[v];
+        m_frame[3 * v] = static_cast<float>(px[id]);
+        m_frame[3 * v + 1] = static_cast<float>(py[id]);
+        m_frame[3 * v + 2] = static_cast<float>(pz[id]);
+    }
+    return writePositions(m_frame.data(), time);
+}
+
+bool FrameCacheWriter::writePositions(const float* positions, double time) {
+    if (!m_file.is_open())
+        return false;
+
+    const size_t count = m_particleIds.size();
+    FrameCacheBlock block{};
+    block.time = time;
+    uint8_t* values = m_block.data() + sizeof(FrameCacheBlock);
+
+    switch (m_encoding) {
+        case FrameEncoding::Float32:
+            std::memcpy(values, positions, 3 * count * sizeof(float));
+            break;
+        case FrameEncoding::Float16: {
+            float lower[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+            float upper[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+            for (size_t v = 0; v < count; ++v) {
+                for (int k = 0; k < 3; ++k) {
+                    lower[k] = std::min(lower[k], positions[3 * v + k]);
+                    upper[k] = std::max(upper[k], positions[3 * v + k]);
+                }
+            }
+            for (int k = 0; k < 3; ++k)
+                block.origin[k] = 0.5f * (lower[k] + upper[k]);
+
+            uint16_t* out = reinterpret_cast<uint16_t*>(values);
+            for (size_t i = 0; i < 3 * count; ++i)
+                out[i] = floatToHalf(positions[i] - block.origin[i % 3]);
+            break;
+        }
+        case FrameEncoding::Delta16: {
+            float largest = 0.0f;
+            for (size_t i = 0; i < 3 * count; ++i)
+                largest = std::max(largest, std::abs(positions[i] - m_rest[i]));
+            block.scale = largest > 0.0f ? largest / 32767.0f : 0.0f;
+            const float inverse = largest > 0.0f ? 32767.0f / largest : 0.0f;
+
+            int16_t* out = reinterpret_cast<int16_t*>(values);
+            for (size_t i = 0; i < 3 * count; ++i) {
+                const long q = std::lround((positions[i] - m_rest[i]) * inverse);
+                out[i] = static_cast<int16_t>(std::clamp(q, -32767L, 32767L));
+            }
+            break;
+        }
+    }
+
+    std::memcpy(m_block.data(), &block, sizeof(block));
+    m_file.write(reinterpret_cast<const char*>(m_block.data()), m_block.size());
+    ++m_frameCount;
+    return static_cast<bool>(m_file);
+}
+
+bool FrameCacheWriter::close() {
+    if (!m_file.is_open())
+        return true;
+
+    m_file.seekp(offsetof(FrameCacheHeader, frameCount));
+    m_file.write(reinterpret_cast<const char*>(&m_frameCount), sizeof(m_frameCount));
+    const bool ok = static_cast<bool>(m_file);
+    m_file.close();
+    return ok;
+}
+
+FrameCacheReader::~FrameCacheReader() {
+    close();
+}
+
+bool FrameCacheReader::open(const std::string& filepath) {
+    close();
+
+#ifndef _WIN32
+    const int descriptor = ::open(filepath.c_str(), O_RDONLY);
+    if (descriptor >= 0) {
+        struct stat info;
+        if (::fstat(descriptor, &info) == 0 && info.st_size > 0) {
+            void* mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (mapping != MAP_FAILED) {
+                m_data = static_cast<const uint8_t*>(mapping);
+                m_size = static_cast<size_t>(info.st_size);
+                m_mapped = true;
+            }
+        }
+        ::close(descriptor);
+    }
+#endif
+
+    if (!m_data) {
+        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            Logger::error("FrameCache: cannot open " + filepath);
+            return false;
+        }
+        const std::streamoff size = file.tellg();
+        if (size < 0) {
+            Logger::error("FrameCache: cannot read " + filepath);
+            return false;
+        }
+        m_size = static_cast<size_t>(size);
+        file.seekg(0);
+        m_buffer.resize((m_size + 7) / 8);
+        file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_size));
+        if (file.gcount() != static_cast<std::streamsize>(m_size)) {
+            Logger::error("FrameCache: " + filepath + ": short read");
+            close();
+            return false;
+        }
+        m_data = reinterpret_cast<const uint8_t*>(m_buffer.data());
+    }
+
+    auto reject = [this, &filepath](const std::string& reason) {
+        Logger::error("FrameCache: " + filepath + ": " + reason);
+        close();
+        return false;
+    };
+
+    if (m_size < sizeof(FrameCacheHeader))
+        return reject("file is too small");
+    std::memcpy(&m_header, m_data, sizeof(m_header));
+    if (std::memcmp(m_header.magic, kMagic, sizeof(kMagic)) != 0)
+        return reject("not a frame cache");
+    if (m_header.version != FrameCacheWriter::kVersion)
+        return reject("unsupported version " + std::to_string(m_header.version));
+    if (m_header.encoding > static_cast<uint32_t>(FrameEncoding::Delta16))
+        return reject("unknown encoding");
+
+    const FrameEncoding encoding = getEncoding();
+    if (m_header.frameOffset % 64 != 0 || m_header.frameOffset > m_size ||
+        topologyEnd(m_header.triangleCount, m_header.vertexCount) > m_header.frameOffset ||
+        m_header.frameStride < sizeof(FrameCacheBlock) + 3ull * m_header.vertexCount * bytesPerValue(encoding) ||
+        m_header.frameStride % 8 != 0)
+        return reject("inconsistent header");
+
+    const int32_t* triangles = getTriangles();
+    for (uint64_t i = 0; i < 3ull * m_header.triangleCount; ++i) {
+        if (triangles[i] < 0 || static_cast<uint32_t>(triangles[i]) >= m_header.vertexCount)
+            return reject("triangle references a missing vertex");
+    }
+
+    // A writer that did not close leaves frameCount at zero; the file size still tells.
+    const uint64_t available = (m_size - m_header.frameOffset) / m_header.frameStride;
+    m_frameCount = m_header.frameCount > 0 ? std::min(m_header.frameCount, available) : available;
+    return true;
+}
+
+void FrameCacheReader::close() {
+#ifndef _WIN32
+    if (m_mapped)
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_header = FrameCacheHeader{};
+    m_frameCount = 0;
+}
+
+const int32_t* FrameCacheReader::getTriangles() const {
+    return reinterpret_cast<const int32_t*>(m_data + sizeof(FrameCacheHeader));
+}
+
+const float* FrameCacheReader::getRestPositions() const {
+    return reinterpret_cast<const float*>(m_data + sizeof(FrameCacheHeader) + 3ull * m_header.triangleCount * sizeof(int32_t));
+}
+
+const uint8_t* FrameCacheReader::frameBlock(int frame) const {
+    return m_data + m_header.frameOffset + static_cast<uint64_t>(frame) * m_header.frameStride;
+}
+
+double FrameCacheReader::getFrameTime(int frame) const {
+    if (frame < 0 || static_cast<uint64_t>(frame) >= m_frameCount)
+        return 0.0;
+    FrameCacheBlock block;
+    std::memcpy(&block, frameBlock(frame), sizeof(block));
+    return block.time;
+}
+
+bool FrameCacheReader::readFrame(int frame, std::vector<float>& out) const {
+    if (frame < 0 || static_cast<uint64_t>(frame) >= m_frameCount)
+        return false;
+
+    const uint8_t* data = frameBlock(frame);
+    FrameCacheBlock block;
+    std::memcpy(&block, data, sizeof(block));
+    const uint8_t* values = data + sizeof(FrameCacheBlock);
+    const size_t count = 3 * static_cast<size_t>(m_header.vertexCount);
+    out.resize(count);
+
+    switch (getEncoding()) {
+        case FrameEncoding::Float32:
+            std::memcpy(out.data(), values, count * sizeof(float));
+            break;
+        case FrameEncoding::Float16: {
+            const uint16_t* in = reinterpret_cast<const uint16_t*>(values);
+            for (size_t i = 0; i < count; ++i)
+                out[i] = block.origin[i % 3] + halfToFloat(in[i]);
+            break;
+        }
+        case FrameEncoding::Delta16: {
+            const int16_t* in = reinterpret_cast<const int16_t*>(values);
+            const float* rest = getRestPositions();
+            for (size_t i = 0; i < count; ++i)
+                out[i] = rest[i] + static_cast<float>(in[i]) * block.scale;
+            break;
+        }
+    }
+    return true;
+}
+
+}
@@ -6,7 +6,7 @@
 
 namespace ClothSDK {
 
-bool OBJLoader::load(const std::string& path, std::vector<Eigen::Vector3d>& outPos, std::vector<int>& outIndices) {
+bool OBJLoader::load(const std::string& path, std::vector<Vector3r>& outPos, std::vector<int>& outIndices) {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
@@ -22,9 +22,9 @@ bool OBJLoader::load(const std::string& path, std::vector<Eigen::Vector3d>& outP
     outPos.reserve(numVertices);
 
     for (size_t i = 0; i < numVertices; ++i) {
-        double vx = static_cast<double>(attrib.vertices[3 * i + 0]);
-        double vy = static_cast<double>(attrib.vertices[3 * i + 1]);
-        double vz = static_cast<double>(attrib.vertices[3 * i + 2]);
+        Real vx = static_cast<Real>(attrib.vertices[3 * i + 0]);
+        Real vy = static_cast<Real>(attrib.vertices[3 * i + 1]);
+        Real vz = static_cast<Real>(attrib.vertices[3 * i + 2]);
         
         outPos.emplace_back(vx, vy, vz);
     }
@@ -0,0 +1,502 @@
+#include "io/SolverSnapshot.hpp"
+#include "physics/Solver.hpp"
+#include "physics/PlaneCollider.hpp"
+#include "physics/SphereCollider.hpp"
+#include "utils/Logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace ClothSDK {
+
+static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader must stay 64 bytes");
+static_assert(sizeof(SnapshotSectionEntry) == 24, "SnapshotSectionEntry must stay 24 bytes");
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'L', 'T', 'H', 'S', 'N', 'A', 'P'};
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr uint64_t kAlignment = 64;
+constexpr int kColliderStride = 8;
+
+uint64_t alignUp(uint64_t value) {
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// A section is written from one or more contiguous chunks, e.g. the x, y and z
+// arrays of a particle block that are `stride` apart in memory.
+struct PendingSection {
+    SnapshotSection id;
+    uint32_t elementSize;
+    uint64_t count;
+    std::vector<std::pair<const void*, std::size_t>> chunks;
+};
+
+template <typename T>
+PendingSection section(SnapshotSection id, const T* data, std::size_t count) {
+    return {id, sizeof(T), count, {{data, count * sizeof(T)}}};
+}
+
+PendingSection vectorBlock(SnapshotSection id, const Real* x, const Real* y, const Real* z, std::size_t count) {
+    const std::size_t bytes = count * sizeof(Real);
+    return {id, sizeof(Real), 3 * count, {{x, bytes}, {y, bytes}, {z, bytes}}};
+}
+
+// Read-only view over the sections of a snapshot held in memory.
+class SnapshotReader {
+public:
+    bool open(const void* data, std::size_t size) {
+        m_data = static_cast<const uint8_t*>(data);
+        if (size < sizeof(SnapshotHeader))
+            return fail("file is too small for a snapshot header");
+
+        std::memcpy(&m_header, m_data, sizeof(SnapshotHeader));
+        if (std::memcmp(m_header.magic, kMagic, sizeof(kMagic)) != 0)
+            return fail("not a solver snapshot");
+        if (m_header.version != SolverSnapshot::kVersion)
+            return fail("unsupported snapshot version " + std::to_string(m_header.version));
+        if (m_header.byteOrder != kByteOrder)
+            return fail("snapshot was written with a different byte order");
+        if (m_header.realSize != sizeof(Real))
+            return fail("snapshot was written with " + std::to_string(8 * m_header.realSize) + "-bit reals");
+        if (m_header.fileSize > size)
+            return fail("snapshot is truncated");
+
+        const uint64_t tableEnd = sizeof(SnapshotHeader) + uint64_t(m_header.sectionCount) * sizeof(SnapshotSectionEntry);
+        if (tableEnd > m_header.fileSize)
+            return fail("section table is truncated");
+        m_entries = reinterpret_cast<const SnapshotSectionEntry*>(m_data + sizeof(SnapshotHeader));
+
+        for (uint32_t i = 0; i < m_header.sectionCount; ++i) {
+            const SnapshotSectionEntry& entry = m_entries[i];
+            // Divide instead of multiplying so a corrupt count cannot wrap past the check.
+            if (entry.offset % kAlignment != 0 || entry.offset > m_header.fileSize ||
+                (entry.count != 0 &&
+                 (entry.elementSize == 0 || entry.count > (m_header.fileSize - entry.offset) / entry.elementSize)))
+                return fail("section " + std::to_string(entry.id) + " lies outside the file");
+        }
+        return true;
+    }
+
+    // Returns the section data, or nullptr if it is missing or has the wrong element type.
+    template <typename T>
+    const T* find(SnapshotSection id, uint64_t& count) const {
+        for (uint32_t i = 0; i < m_header.sectionCount; ++i) {
+            const SnapshotSectionEntry& entry = m_entries[i];
+            if (entry.id != static_cast<uint32_t>(id))
+                continue;
+            if (entry.elementSize != sizeof(T))
+                break;
+            count = entry.count;
+            return reinterpret_cast<const T*>(m_data + entry.offset);
+        }
+        count = 0;
+        return nullptr;
+    }
+
+    bool fail(const std::string& reason) const {
+        Logger::error("Snapshot: " + reason);
+        return false;
+    }
+
+private:
+    const uint8_t* m_data = nullptr;
+    SnapshotHeader m_header{};
+    const SnapshotSectionEntry* m_entries = nullptr;
+};
+
+bool idsInRange(const int32_t* ids, uint64_t count, uint64_t particleCount) {
+    for (uint64_t i = 0; i < count; ++i) {
+        if (ids[i] < 0 || static_cast<uint64_t>(ids[i]) >= particleCount)
+            return false;
+    }
+    return true;
+}
+
+bool validColorOffsets(const int32_t* offsets, uint64_t count, uint64_t constraints) {
+    if (count == 0 || offsets[0] != 0 || static_cast<uint64_t>(offsets[count - 1]) != constraints)
+        return false;
+    for (uint64_t i = 1; i < count; ++i) {
+        if (offsets[i] < offsets[i - 1])
+            return false;
+    }
+    return true;
+}
+
+}
+
+bool SolverSnapshot::save(const std::string& filepath, const Solver& solver) {
+    if (!solver.m_constraints.empty()) {
+        Logger::error("Snapshot: constraints added through addConstraint() cannot be serialized");
+        return false;
+    }
+
+    const ParticleBuffer& particles = solver.m_particles;
+    const DistanceBatch& distance = solver.m_distanceBatch;
+    const BendingBatch& bending = solver.m_bendingBatch;
+    const SpatialHash& hash = solver.m_spatialHash;
+    const std::size_t count = particles.size();
+
+    SnapshotSettings settings{};
+    for (int k = 0; k < 3; ++k) {
+        settings.gravity[k] = solver.m_gravity[k];
+        settings.wind[k] = solver.m_wind[k];
+    }
+    settings.airDensity = solver.m_airDensity;
+    settings.time = solver.m_time;
+    settings.thickness = solver.m_thickness;
+    settings.collisionCompliance = solver.m_collisionCompliance;
+    settings.hashCellSize = hash.getCellSize();
+    settings.substeps = solver.m_substeps;
+    settings.iterations = solver.m_iterations;
+    settings.hashTableSize = hash.getTableSize();
+    settings.adaptiveHashTable = hash.getAdaptiveTableSize();
+    settings.storeSortedPositions = hash.getStoreSortedPositions();
+    settings.distanceColoringDirty = distance.m_coloringDirty;
+    settings.bendingColoringDirty = bending.m_coloringDirty;
+
+    const AdaptiveSubstepping& adaptive = solver.m_adaptive;
+    SnapshotSubstepping substepping{};
+    substepping.maxDisplacement = adaptive.maxDisplacement;
+    substepping.maxResidual = adaptive.maxResidual;
+    substepping.relaxRatio = adaptive.relaxRatio;
+    substepping.lastSubstepDt = solver.m_lastSubstepDt;
+    substepping.minSubsteps = adaptive.minSubsteps;
+    substepping.maxSubsteps = adaptive.maxSubsteps;
+    substepping.currentSubsteps = solver.m_adaptiveSubsteps;
+    substepping.enabled = adaptive.enabled;
+
+    SnapshotSleeping sleeping{};
+    sleeping.velocityThreshold = solver.m_sleep.velocityThreshold;
+    sleeping.substeps = solver.m_sleep.substeps;
+    sleeping.enabled = solver.m_sleep.enabled;
+
+    SnapshotTethers tethers{};
+    tethers.stretchLimit = solver.m_tetherSettings.stretchLimit;
+    tethers.enabled = solver.m_tetherSettings.enabled;
+
+    std::vector<int32_t> sleepState;
+    if (solver.m_islands.getParticleCount() == static_cast<int>(count))
+        solver.m_islands.getState(sleepState);
+    else
+        sleepState = solver.m_pendingSleepState;
+
+    std::vector<int32_t> adjacency;
+    adjacency.reserve(2 * solver.m_adjacencyEdges.size());
+    for (const auto& [a, b] : solver.m_adjacencyEdges) {
+        adjacency.push_back(a);
+        adjacency.push_back(b);
+    }
+
+    std::vector<int32_t> aeroFaces;
+    aeroFaces.reserve(3 * solver.m_aeroFaces.size());
+    for (const auto& face : solver.m_aeroFaces)
+        aeroFaces.insert(aeroFaces.end(), {face.a, face.b, face.c});
+
+    std::vector<Real> colliders;
+    for (const auto& collider : solver.m_colliders) {
+        if (const auto* plane = dynamic_cast<const PlaneCollider*>(collider.get())) {
+            const Vector3r& o = plane->getOrigin();
+            const Vector3r& n = plane->getNormal();
+            colliders.insert(colliders.end(), {Real(0), plane->getFriction(), o.x(), o.y(), o.z(), n.x(), n.y(), n.z()});
+        } else if (const auto* sphere = dynamic_cast<const SphereCollider*>(collider.get())) {
+            const Vector3r& c = sphere->getCenter();
+            colliders.insert(colliders.end(), {Real(1), sphere->getFriction(), c.x(), c.y(), c.z(), sphere->getRadius(), Real(0), Real(0)});
+        } else {
+            Logger::error("Snapshot: unknown collider type cannot be serialized");
+            return false;
+        }
+    }
+
+    const std::size_t distanceCount = distance.size();
+    const std::size_t bendingCount = bending.size();
+    const std::size_t idBytes = sizeof(int32_t);
+
+    std::vector<PendingSection> sections;
+    sections.push_back(section(SnapshotSection::Settings, &settings, 1));
+    sections.push_back(vectorBlock(SnapshotSection::Position, particles.posX(), particles.posY(), particles.posZ(), count));
+    sections.push_back(vectorBlock(SnapshotSection::OldPosition, particles.oldX(), particles.oldY(), particles.oldZ(), count));
+    sections.push_back(vectorBlock(SnapshotSection::Acceleration, particles.accX(), particles.accY(), particles.accZ(), count));
+    sections.push_back(section(SnapshotSection::InverseMass, particles.invMass(), count));
+
+    sections.push_back({SnapshotSection::DistanceIds, sizeof(int32_t), 2 * distanceCount,
+                        {{distance.idA(), distanceCount * idBytes}, {distance.idB(), distanceCount * idBytes}}});
+    sections.push_back(section(SnapshotSection::DistanceRestLength, distance.restLength(), distanceCount));
+    sections.push_back(section(SnapshotSection::DistanceCompliance, distance.compliance(), distanceCount));
+    sections.push_back(section(SnapshotSection::DistanceLambda, distance.lambda(), distanceCount));
+    sections.push_back(section(SnapshotSection::DistanceColorOffsets, distance.m_colorOffsets.data(), distance.m_colorOffsets.size()));
+
+    sections.push_back({SnapshotSection::BendingIds, sizeof(int32_t), 4 * bendingCount,
+                        {{bending.idA(), bendingCount * idBytes}, {bending.idB(), bendingCount * idBytes},
+                         {bending.idC(), bendingCount * idBytes}, {bending.idD(), bendingCount * idBytes}}});
+    sections.push_back(section(SnapshotSection::BendingRestAngle, bending.restAngle(), bendingCount));
+    sections.push_back(section(SnapshotSection::BendingCompliance, bending.compliance(), bendingCount));
+    sections.push_back(section(SnapshotSection::BendingLambda, bending.lambda(), bendingCount));
+    sections.push_back(section(SnapshotSection::BendingColorOffsets, bending.m_colorOffsets.data(), bending.m_colorOffsets.size()));
+
+    sections.push_back(section(SnapshotSection::AdjacencyEdges, adjacency.data(), adjacency.size()));
+    sections.push_back(section(SnapshotSection::AeroFaces, aeroFaces.data(), aeroFaces.size()));
+    sections.push_back(section(SnapshotSection::Colliders, colliders.data(), colliders.size()));
+    sections.push_back(section(SnapshotSection::Substepping, &substepping, 1));
+    sections.push_back(section(SnapshotSection::Sleeping, &sleeping, 1));
+    sections.push_back(section(SnapshotSection::Tethers, &tethers, 1));
+    if (!sleepState.empty())
+        sections.push_back(section(SnapshotSection::SleepState, sleepState.data(), sleepState.size()));
+
+    std::vector<SnapshotSectionEntry> table(sections.size());
+    uint64_t offset = alignUp(sizeof(SnapshotHeader) + table.size() * sizeof(SnapshotSectionEntry));
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        table[i] = {static_cast<uint32_t>(sections[i].id), sections[i].elementSize, sections[i].count, offset};
+        offset = alignUp(offset + sections[i].count * sections[i].elementSize);
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.realSize = sizeof(Real);
+    header.byteOrder = kByteOrder;
+    header.sectionCount = static_cast<uint32_t>(table.size());
+    header.fileSize = offset;
+
+    // Write next to the target and rename, so an interrupted save never leaves a torn checkpoint.
+    const std::string temporary = filepath + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            Logger::error("Snapshot: cannot open " + temporary + " for writing");
+            return false;
+        }
+
+        const char padding[kAlignment] = {};
+        uint64_t written = 0;
+        auto write = [&file, &written](const void* data, std::size_t bytes) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            written += bytes;
+        };
+
+        write(&header, sizeof(header));
+        write(table.data(), table.size() * sizeof(SnapshotSectionEntry));
+        for (std::size_t i = 0; i < sections.size(); ++i) {
+            write(padding, table[i].offset - written);
+            for (const auto& [data, bytes] : sections[i].chunks)
+                write(data, bytes);
+        }
+        write(padding, header.fileSize - written);
+
+        if (!file) {
+            Logger::error("Snapshot: failed while writing " + temporary);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, filepath, error);
+    if (error) {
+        Logger::error("Snapshot: cannot move " + temporary + " to " + filepath + ": " + error.message());
+        return false;
+    }
+    return true;
+}
+
+bool SolverSnapshot::load(const std::string& filepath, Solver& solver) {
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        Logger::error("Snapshot: cannot open " + filepath);
+        return false;
+    }
+
+    const std::streamsize size = file.tellg();
+    file.seekg(0);
+
+    // uint64_t storage keeps the buffer 8-byte aligned for the section casts.
+    std::vector<uint64_t> buffer((static_cast<std::size_t>(size) + 7) / 8);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) {
+        Logger::error("Snapshot: failed to read " + filepath);
+        return false;
+    }
+    return restore(buffer.data(), static_cast<std::size_t>(size), solver);
+}
+
+bool SolverSnapshot::restore(const void* data, std::size_t size, Solver& solver) {
+    SnapshotReader reader;
+    if (!reader.open(data, size))
+        return false;
+
+    uint64_t settingsCount, positionCount, oldCount, accelerationCount, massCount;
+    const auto* settingsData = reader.find<SnapshotSettings>(SnapshotSection::Settings, settingsCount);
+    const Real* position = reader.find<Real>(SnapshotSection::Position, positionCount);
+    const Real* oldPosition = reader.find<Real>(SnapshotSection::OldPosition, oldCount);
+    const Real* acceleration = reader.find<Real>(SnapshotSection::Acceleration, accelerationCount);
+    const Real* inverseMass = reader.find<Real>(SnapshotSection::InverseMass, massCount);
+    if (!settingsData || settingsCount != 1 || !position || !oldPosition || !acceleration || !inverseMass)
+        return reader.fail("particle sections are missing");
+
+    const uint64_t count = massCount;
+    if (positionCount != 3 * count || oldCount != 3 * count || accelerationCount != 3 * count)
+        return reader.fail("particle sections disagree on the particle count");
+
+    uint64_t distanceIdCount, restLengthCount, distanceComplianceCount, distanceLambdaCount, distanceColorCount;
+    const int32_t* distanceIds = reader.find<int32_t>(SnapshotSection::DistanceIds, distanceIdCount);
+    const Real* restLength = reader.find<Real>(SnapshotSection::DistanceRestLength, restLengthCount);
+    const Real* distanceCompliance = reader.find<Real>(SnapshotSection::DistanceCompliance, distanceComplianceCount);
+    const Real* distanceLambda = reader.find<Real>(SnapshotSection::DistanceLambda, distanceLambdaCount);
+    const int32_t* distanceColors = reader.find<int32_t>(SnapshotSection::DistanceColorOffsets, distanceColorCount);
+    const uint64_t distanceCount = restLengthCount;
+    if (!distanceIds || !restLength || !distanceCompliance || !distanceLambda || !distanceColors ||
+        distanceIdCount != 2 * distanceCount || distanceComplianceCount != distanceCount ||
+        distanceLambdaCount != distanceCount)
+        return reader.fail("distance constraint sections are missing or inconsistent");
+
+    uint64_t bendingIdCount, restAngleCount, bendingComplianceCount, bendingLambdaCount, bendingColorCount;
+    const int32_t* bendingIds = reader.find<int32_t>(SnapshotSection::BendingIds, bendingIdCount);
+    const Real* restAngle = reader.find<Real>(SnapshotSection::BendingRestAngle, restAngleCount);
+    const Real* bendingCompliance = reader.find<Real>(SnapshotSection::BendingCompliance, bendingComplianceCount);
+    const Real* bendingLambda = reader.find<Real>(SnapshotSection::BendingLambda, bendingLambdaCount);
+    const int32_t* bendingColors = reader.find<int32_t>(SnapshotSection::BendingColorOffsets, bendingColorCount);
+    const uint64_t bendingCount = restAngleCount;
+    if (!bendingIds || !restAngle || !bendingCompliance || !bendingLambda || !bendingColors ||
+        bendingIdCount != 4 * bendingCount || bendingComplianceCount != bendingCount ||
+        bendingLambdaCount != bendingCount)
+        return reader.fail("bending constraint sections are missing or inconsistent");
+
+    uint64_t adjacencyCount, aeroCount, colliderCount;
+    const int32_t* adjacency = reader.find<int32_t>(SnapshotSection::AdjacencyEdges, adjacencyCount);
+    const int32_t* aeroFaces = reader.find<int32_t>(SnapshotSection::AeroFaces, aeroCount);
+    const Real* colliders = reader.find<Real>(SnapshotSection::Colliders, colliderCount);
+    if ((adjacencyCount && !adjacency) || adjacencyCount % 2 != 0 || aeroCount % 3 != 0 || colliderCount % kColliderStride != 0)
+        return reader.fail("topology or collider sections are malformed");
+    for (uint64_t i = 0; i < colliderCount; i += kColliderStride) {
+        if (colliders[i] != Real(0) && colliders[i] != Real(1))
+            return reader.fail("unknown collider type");
+    }
+
+    if (!idsInRange(distanceIds, distanceIdCount, count) || !idsInRange(bendingIds, bendingIdCount, count) ||
+        !idsInRange(adjacency, adjacencyCount, count) || !idsInRange(aeroFaces, aeroCount, count))
+        return reader.fail("constraint references a particle outside the snapshot");
+
+    const SnapshotSettings& settings = *settingsData;
+    if ((!settings.distanceColoringDirty && !validColorOffsets(distanceColors, distanceColorCount, distanceCount)) ||
+        (!settings.bendingColoringDirty && !validColorOffsets(bendingColors, bendingColorCount, bendingCount)))
+        return reader.fail("constraint coloring does not match the constraint count");
+    if (settings.substeps <= 0 || settings.iterations < 0 || settings.hashTableSize <= 0)
+        return reader.fail("solver settings are invalid");
+
+    uint64_t substeppingCount;
+    const auto* substepping = reader.find<SnapshotSubstepping>(SnapshotSection::Substepping, substeppingCount);
+    if (substepping && (substeppingCount != 1 || substepping->minSubsteps < 1 ||
+                        substepping->maxSubsteps < substepping->minSubsteps))
+        return reader.fail("substepping settings are invalid");
+
+    uint64_t sleepingCount, sleepStateCount;
+    const auto* sleeping = reader.find<SnapshotSleeping>(SnapshotSection::Sleeping, sleepingCount);
+    const int32_t* sleepState = reader.find<int32_t>(SnapshotSection::SleepState, sleepStateCount);
+    if ((sleeping && (sleepingCount != 1 || sleeping->substeps < 1)) ||
+        (sleepState && (sleepStateCount != count ||
+                        std::any_of(sleepState, sleepState + count, [](int32_t s) { return s < -1; }))))
+        return reader.fail("sleeping settings are invalid");
+
+    uint64_t tethersCount;
+    const auto* tethers = reader.find<SnapshotTethers>(SnapshotSection::Tethers, tethersCount);
+    if (tethers && (tethersCount != 1 || !(tethers->stretchLimit >= 1.0)))
+        return reader.fail("tether settings are invalid");
+
+    // Everything is validated; from here on the solver is replaced wholesale.
+    solver.clear();
+
+    ParticleBuffer& particles = solver.m_particles;
+    particles.resize(count);
+    Real* targets[10] = {particles.posX(), particles.posY(), particles.posZ(),
+                         particles.oldX(), particles.oldY(), particles.oldZ(),
+                         particles.accX(), particles.accY(), particles.accZ(), particles.invMass()};
+    const Real* sources[4] = {position, oldPosition, acceleration, inverseMass};
+    for (int k = 0; k < 10; ++k)
+        std::memcpy(targets[k], sources[k / 3] + (k % 3) * count, count * sizeof(Real));
+
+    DistanceBatch& distance = solver.m_distanceBatch;
+    distance.m_idA.assign(distanceIds, distanceIds + distanceCount);
+    distance.m_idB.assign(distanceIds + distanceCount, distanceIds + 2 * distanceCount);
+    distance.m_restLength.assign(restLength, restLength + distanceCount);
+    distance.m_compliance.assign(distanceCompliance, distanceCompliance + distanceCount);
+    distance.m_lambda.assign(distanceLambda, distanceLambda + distanceCount);
+    distance.m_colorOffsets.assign(distanceColors, distanceColors + distanceColorCount);
+    distance.m_coloringDirty = settings.distanceColoringDirty != 0;
+
+    BendingBatch& bending = solver.m_bendingBatch;
+    bending.m_idA.assign(bendingIds, bendingIds + bendingCount);
+    bending.m_idB.assign(bendingIds + bendingCount, bendingIds + 2 * bendingCount);
+    bending.m_idC.assign(bendingIds + 2 * bendingCount, bendingIds + 3 * bendingCount);
+    bending.m_idD.assign(bendingIds + 3 * bendingCount, bendingIds + 4 * bendingCount);
+    bending.m_restAngle.assign(restAngle, restAngle + bendingCount);
+    bending.m_compliance.assign(bendingCompliance, bendingCompliance + bendingCount);
+    bending.m_lambda.assign(bendingLambda, bendingLambda + bendingCount);
+    bending.m_colorOffsets.assign(bendingColors, bendingColors + bendingColorCount);
+    bending.m_coloringDirty = settings.bendingColoringDirty != 0;
+
+    solver.m_adjacencyEdges.reserve(adjacencyCount / 2);
+    for (uint64_t i = 0; i < adjacencyCount; i += 2)
+        solver.m_adjacencyEdges.emplace_back(adjacency[i], adjacency[i + 1]);
+    solver.m_adjacencyDirty = true;
+
+    for (uint64_t i = 0; i < aeroCount; i += 3)
+        solver.addAeroFace(aeroFaces[i], aeroFaces[i + 1], aeroFaces[i + 2]);
+
+    for (uint64_t i = 0; i < colliderCount; i += kColliderStride) {
+        const Real* c = colliders + i;
+        if (c[0] == Real(0))
+            solver.addPlaneCollider(Vector3r(c[2], c[3], c[4]), Vector3r(c[5], c[6], c[7]), c[1]);
+        else
+            solver.addSphereCollider(Vector3r(c[2], c[3], c[4]), c[5], c[1]);
+    }
+
+    solver.m_gravity = Vector3r(Real(settings.gravity[0]), Real(settings.gravity[1]), Real(settings.gravity[2]));
+    solver.m_wind = Vector3r(Real(settings.wind[0]), Real(settings.wind[1]), Real(settings.wind[2]));
+    solver.m_airDensity = static_cast<Real>(settings.airDensity);
+    solver.m_time = static_cast<Real>(settings.time);
+    solver.m_thickness = static_cast<Real>(settings.thickness);
+    solver.m_collisionCompliance = static_cast<Real>(settings.collisionCompliance);
+    solver.m_substeps = settings.substeps;
+    solver.m_iterations = settings.iterations;
+
+    // Files written before adaptive substepping existed restore to fixed substeps.
+    AdaptiveSubstepping adaptive;
+    if (substepping) {
+        adaptive.enabled = substepping->enabled != 0;
+        adaptive.minSubsteps = substepping->minSubsteps;
+        adaptive.maxSubsteps = substepping->maxSubsteps;
+        adaptive.maxDisplacement = static_cast<Real>(substepping->maxDisplacement);
+        adaptive.maxResidual = static_cast<Real>(substepping->maxResidual);
+        adaptive.relaxRatio = static_cast<Real>(substepping->relaxRatio);
+    }
+    solver.m_adaptive = adaptive;
+    solver.m_adaptiveSubsteps = substepping ? adaptive.clamp(substepping->currentSubsteps) : 0;
+    solver.m_lastSubstepDt = substepping ? static_cast<Real>(substepping->lastSubstepDt) : Real(0);
+
+    // The islands are rebuilt by the next update, which then applies the saved state.
+    SleepSettings sleep;
+    if (sleeping) {
+        sleep.enabled = sleeping->enabled != 0;
+        sleep.velocityThreshold = static_cast<Real>(sleeping->velocityThreshold);
+        sleep.substeps = sleeping->substeps;
+    }
+    solver.m_sleep = sleep;
+    if (sleep.enabled && sleepState)
+        solver.m_pendingSleepState.assign(sleepState, sleepState + count);
+
+    // Tethers derive from the restored pins and rest lengths, so the next update regenerates them.
+    TetherSettings tetherSettings;
+    if (tethers) {
+        tetherSettings.enabled = tethers->enabled != 0;
+        tetherSettings.stretchLimit = static_cast<Real>(tethers->stretchLimit);
+    }
+    solver.setTethers(tetherSettings);
+
+    // The table is sized again by the next build; only its configuration is restored.
+    solver.m_spatialHash.setCellSize(static_cast<Real>(settings.hashCellSize));
+    solver.m_spatialHash.setAdaptiveTableSize(settings.adaptiveHashTable != 0);
+    solver.m_spatialHash.setStoreSortedPositions(settings.storeSortedPositions != 0);
+    return true;
+}
+
+}
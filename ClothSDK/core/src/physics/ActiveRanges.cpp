@@ -0,0 +1,40 @@
+#include "physics/ActiveRanges.hpp"
+#include <algorithm>
+
+namespace ClothSDK {
+
+void ActiveRanges::build(const std::vector<int>& colorOffsets, const int* firstParticle, const uint8_t* awake,
+                         int chunk) {
+    const int colorCount = static_cast<int>(colorOffsets.size()) - 1;
+    m_colorOffsets.assign(1, 0);
+    m_runs.clear();
+    m_activeCount = 0;
+
+    for (int color = 0; color < colorCount; ++color) {
+        const int end = colorOffsets[color + 1];
+        int k = colorOffsets[color];
+        while (k < end) {
+            while (k < end && !awake[firstParticle[k]])
+                ++k;
+            const int begin = k;
+            while (k < end && k - begin < chunk && awake[firstParticle[k]])
+                ++k;
+            if (k > begin) {
+                m_runs.push_back(begin);
+                m_runs.push_back(k);
+                m_activeCount += k - begin;
+            }
+        }
+        m_colorOffsets.push_back(static_cast<int>(m_runs.size()) / 2);
+    }
+    m_enabled = true;
+}
+
+void ActiveRanges::clear() {
+    m_enabled = false;
+    m_colorOffsets.clear();
+    m_runs.clear();
+    m_activeCount = 0;
+}
+
+}
@@ -0,0 +1,62 @@
+#include "physics/AdjacencyList.hpp"
+#include <algorithm>
+
+namespace ClothSDK {
+
+void AdjacencyList::build(int particleCount, const std::vector<std::pair<int, int>>& edges) {
+    m_offsets.assign(particleCount + 1, 0);
+
+    for (const auto& [a, b] : edges) {
+        if (a == b) continue;
+        m_offsets[a + 1]++;
+        m_offsets[b + 1]++;
+    }
+    for (int i = 0; i < particleCount; ++i)
+        m_offsets[i + 1] += m_offsets[i];
+
+    m_neighbors.resize(m_offsets[particleCount]);
+    std::vector<int> cursor(m_offsets.begin(), m_offsets.end() - 1);
+    for (const auto& [a, b] : edges) {
+        if (a == b) continue;
+        m_neighbors[cursor[a]++] = b;
+        m_neighbors[cursor[b]++] = a;
+    }
+
+    // Sort every row and squeeze out duplicates in place.
+    int write = 0;
+    for (int i = 0; i < particleCount; ++i) {
+        int begin = m_offsets[i];
+        int end = m_offsets[i + 1];
+        std::sort(m_neighbors.begin() + begin, m_neighbors.begin() + end);
+        m_offsets[i] = write;
+        for (int k = begin; k < end; ++k) {
+            if (k > begin && m_neighbors[k] == m_neighbors[k - 1]) continue;
+            m_neighbors[write++] = m_neighbors[k];
+        }
+    }
+    m_offsets[particleCount] = write;
+    m_neighbors.resize(write);
+}
+
+void AdjacencyList::clear() {
+    m_offsets.assign(1, 0);
+    m_neighbors.clear();
+}
+
+bool AdjacencyList::contains(int a, int b) const {
+    if (a < 0 || a >= getParticleCount()) return false;
+
+    const int* begin = neighborsBegin(a);
+    const int* end = neighborsEnd(a);
+
+    if (end - begin <= 16) {
+        for (const int* it = begin; it != end; ++it) {
+            if (*it == b) return true;
+            if (*it > b) return false;
+        }
+        return false;
+    }
+    return std::binary_search(begin, end, b);
+}
+
+}
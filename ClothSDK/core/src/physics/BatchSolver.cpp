@@ -0,0 +1,111 @@
+#include "physics/BatchSolver.hpp"
+#include "physics/Solver.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <numeric>
+
+namespace ClothSDK {
+
+BatchSolver::BatchSolver(int threadCount)
+    : m_threadCount(threadCount > 0 ? threadCount : omp_get_max_threads()) {}
+
+BatchSolver::~BatchSolver() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_batchReady.notify_all();
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+
+void BatchSolver::add(Solver& solver) {
+    m_solvers.push_back(&solver);
+}
+
+void BatchSolver::clear() {
+    m_solvers.clear();
+}
+
+void BatchSolver::update(Real deltaTime, int frames) {
+    const int sceneCount = static_cast<int>(m_solvers.size());
+    if (sceneCount == 0 || frames <= 0)
+        return;
+
+    // Longest scenes first, so the tail of the batch is made of short ones.
+    m_order.resize(sceneCount);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::vector<double> cost(sceneCount);
+    for (int s = 0; s < sceneCount; ++s)
+        cost[s] = static_cast<double>(m_solvers[s]->getParticles().size()) * m_solvers[s]->getCurrentSubsteps();
+    std::stable_sort(m_order.begin(), m_order.end(), [&cost](int a, int b) { return cost[a] > cost[b]; });
+
+    const int concurrent = std::min(m_threadCount, sceneCount);
+    m_deltaTime = deltaTime;
+    m_frames = frames;
+    m_sceneThreads = std::max(1, m_threadCount / concurrent);
+    m_nextScene = 0;
+
+    const int helpers = concurrent - 1;
+    if (static_cast<int>(m_workers.size()) < helpers)
+        startWorkers(helpers - static_cast<int>(m_workers.size()));
+
+    if (helpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busyWorkers = static_cast<int>(m_workers.size());
+            ++m_generation;
+        }
+        m_batchReady.notify_all();
+    }
+
+    const int previousThreads = omp_get_max_threads();
+    runScenes();
+    omp_set_num_threads(previousThreads);
+
+    if (helpers > 0) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_batchDone.wait(lock, [this] { return m_busyWorkers == 0; });
+    }
+}
+
+void BatchSolver::startWorkers(int count) {
+    // Workers start from the current generation, so they wait for the next batch
+    // even if update() publishes it before they first take the lock.
+    for (int w = 0; w < count; ++w)
+        m_workers.emplace_back(&BatchSolver::workerLoop, this, m_generation);
+}
+
+void BatchSolver::workerLoop(std::uint64_t seen) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_batchReady.wait(lock, [this, seen] { return m_stopping || m_generation != seen; });
+            if (m_stopping)
+                return;
+            seen = m_generation;
+        }
+
+        runScenes();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyWorkers == 0)
+            m_batchDone.notify_one();
+    }
+}
+
+void BatchSolver::runScenes() {
+    const int sceneCount = static_cast<int>(m_order.size());
+    for (int next = m_nextScene++; next < sceneCount; next = m_nextScene++) {
+        Solver& solver = *m_solvers[m_order[next]];
+
+        // Scenes without a budget of their own run with the pool's share; the
+        // setting is per thread, so scenes on other threads are unaffected.
+        if (solver.getThreadCount() == 0)
+            omp_set_num_threads(m_sceneThreads);
+        for (int frame = 0; frame < m_frames; ++frame)
+            solver.update(m_deltaTime);
+    }
+}
+
+}
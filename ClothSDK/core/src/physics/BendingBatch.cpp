@@ -0,0 +1,167 @@
+#include "physics/BendingBatch.hpp"
+#include "physics/ConstraintColoring.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ClothSDK {
+
+void BendingBatch::project(ParticleBuffer& particles, int a, int b, int c, int d,
+                           Real restAngle, Real alphaHat, Real& lambda) {
+    Vector3r pA = particles.getPosition(a);
+    Vector3r pB = particles.getPosition(b);
+    Vector3r pC = particles.getPosition(c);
+    Vector3r pD = particles.getPosition(d);
+
+    Vector3r edgeVector = pB - pA;
+    Real length = edgeVector.norm();
+    Vector3r CVector = pC - pA;
+    Vector3r DVector = pD - pA;
+
+    Vector3r normal1 = edgeVector.cross(CVector);
+    Vector3r normal2 = edgeVector.cross(DVector);
+
+    Real area1 = normal1.norm();
+    Real area2 = normal2.norm();
+
+    if (area1 < 1e-6 || area2 < 1e-6 || length < 1e-6) return;
+
+    Real cosTheta = normal1.dot(normal2) / (area1 * area2);
+    Real clampedCos = std::clamp(cosTheta, Real(-1), Real(1));
+    Real currentAngle = std::acos(clampedCos);
+
+    if (normal1.squaredNorm() < 1e-6)
+        return;
+
+    Vector3r gradC = (length / area1) * (normal1 / area1);
+    Vector3r gradD = (length / area2) * (normal2 / area2);
+
+    Real weightBC = (- (pB - pC).dot(edgeVector)) / length;
+    Real weightBD = (- (pB - pD).dot(edgeVector)) / length;
+    Real weightAC = (- (pA - pC).dot(edgeVector)) / length;
+    Real weightAD = (- (pA - pD).dot(edgeVector)) / length;
+
+    Vector3r gradA = -weightBC * gradC - weightBD * gradD;
+    Vector3r gradB = weightAC * gradC + weightAD * gradD;
+
+    Real wA = particles.getInverseMass(a);
+    Real wB = particles.getInverseMass(b);
+    Real wC = particles.getInverseMass(c);
+    Real wD = particles.getInverseMass(d);
+
+    Real wSum = wA * gradA.squaredNorm() + wB * gradB.squaredNorm() + wC * gradC.squaredNorm() + wD * gradD.squaredNorm();
+
+    Real deltaLambda = (-(currentAngle - restAngle) - alphaHat * lambda) / (wSum + alphaHat);
+    lambda += deltaLambda;
+
+    particles.setPosition(a, pA + wA * gradA * deltaLambda);
+    particles.setPosition(b, pB + wB * gradB * deltaLambda);
+    particles.setPosition(c, pC + wC * gradC * deltaLambda);
+    particles.setPosition(d, pD + wD * gradD * deltaLambda);
+}
+
+void BendingBatch::add(int idA, int idB, int idC, int idD, Real restAngle, Real compliance) {
+    m_idA.push_back(idA);
+    m_idB.push_back(idB);
+    m_idC.push_back(idC);
+    m_idD.push_back(idD);
+    m_restAngle.push_back(restAngle);
+    m_compliance.push_back(compliance);
+    m_lambda.push_back(0.0);
+    m_coloringDirty = true;
+}
+
+void BendingBatch::reserve(std::size_t count) {
+    m_idA.reserve(count);
+    m_idB.reserve(count);
+    m_idC.reserve(count);
+    m_idD.reserve(count);
+    m_restAngle.reserve(count);
+    m_compliance.reserve(count);
+    m_lambda.reserve(count);
+}
+
+void BendingBatch::clear() {
+    m_idA.clear();
+    m_idB.clear();
+    m_idC.clear();
+    m_idD.clear();
+    m_restAngle.clear();
+    m_compliance.clear();
+    m_lambda.clear();
+    m_colorOffsets.assign(1, 0);
+    m_coloringDirty = false;
+    m_active.clear();
+}
+
+void BendingBatch::resetLambda() {
+    std::fill(m_lambda.begin(), m_lambda.end(), 0.0);
+}
+
+void BendingBatch::buildColoring(int particleCount) {
+    const int count = size();
+    std::vector<int> offsets(count + 1);
+    std::vector<int> ids(4 * count);
+    for (int c = 0; c < count; ++c) {
+        offsets[c] = 4 * c;
+        ids[4 * c] = m_idA[c];
+        ids[4 * c + 1] = m_idB[c];
+        ids[4 * c + 2] = m_idC[c];
+        ids[4 * c + 3] = m_idD[c];
+    }
+    offsets[count] = 4 * count;
+
+    ConstraintColoring coloring;
+    coloring.build(offsets, ids, particleCount);
+
+    const std::vector<int>& order = coloring.getOrder();
+    ConstraintColoring::permute(m_idA, order);
+    ConstraintColoring::permute(m_idB, order);
+    ConstraintColoring::permute(m_idC, order);
+    ConstraintColoring::permute(m_idD, order);
+    ConstraintColoring::permute(m_restAngle, order);
+    ConstraintColoring::permute(m_compliance, order);
+    ConstraintColoring::permute(m_lambda, order);
+    m_colorOffsets = coloring.getColorOffsets();
+    m_coloringDirty = false;
+    m_active.clear();
+}
+
+void BendingBatch::solve(ParticleBuffer& particles, Real dt) {
+    if (m_active.isEnabled()) {
+        for (size_t color = 0; color + 1 < m_colorOffsets.size(); ++color) {
+            const int begin = m_active.colorBegin(static_cast<int>(color));
+            const int end = m_active.colorEnd(static_cast<int>(color));
+
+            #pragma omp parallel for if(end - begin > 1)
+            for (int run = begin; run < end; ++run)
+                solveRange(particles, dt, m_active.runBegin(run), m_active.runEnd(run));
+        }
+        return;
+    }
+
+    for (size_t color = 0; color + 1 < m_colorOffsets.size(); ++color) {
+        const int begin = m_colorOffsets[color];
+        const int end = m_colorOffsets[color + 1];
+        const int chunk = 128;
+
+        #pragma omp parallel for if(end - begin > chunk)
+        for (int k = begin; k < end; k += chunk)
+            solveRange(particles, dt, k, std::min(k + chunk, end));
+    }
+}
+
+void BendingBatch::setActiveParticles(const uint8_t* awake) {
+    if (awake)
+        m_active.build(m_colorOffsets, m_idA.data(), awake, 128);
+    else
+        m_active.clear();
+}
+
+void BendingBatch::solveRange(ParticleBuffer& particles, Real dt, int begin, int end) {
+    const Real dtSq = dt * dt;
+
+    for (int k = begin; k < end; ++k)
+        project(particles, m_idA[k], m_idB[k], m_idC[k], m_idD[k], m_restAngle[k], m_compliance[k] / dtSq, m_lambda[k]);
+}
+
+}
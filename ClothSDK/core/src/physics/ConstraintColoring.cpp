@@ -0,0 +1,71 @@
+#include "physics/ConstraintColoring.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace ClothSDK {
+
+void ConstraintColoring::build(const std::vector<int>& offsets, const std::vector<int>& particleIds, int particleCount) {
+    const int constraintCount = static_cast<int>(offsets.size()) - 1;
+    m_colors.assign(constraintCount > 0 ? constraintCount : 0, -1);
+
+    // Colors are assigned in windows of 64 so the per-particle "used colors" set fits a
+    // bitmask. Constraints that find all 64 colors of a window taken move on to the next one.
+    std::vector<uint64_t> usedMask(particleCount, 0);
+    std::vector<int> pending;
+    pending.reserve(constraintCount);
+    for (int c = 0; c < constraintCount; ++c)
+        pending.push_back(c);
+
+    int colorCount = 0;
+    int windowBase = 0;
+    std::vector<int> deferred;
+
+    while (!pending.empty()) {
+        std::fill(usedMask.begin(), usedMask.end(), 0);
+        deferred.clear();
+
+        for (int c : pending) {
+            uint64_t forbidden = 0;
+            for (int k = offsets[c]; k < offsets[c + 1]; ++k)
+                forbidden |= usedMask[particleIds[k]];
+
+            if (forbidden == ~uint64_t(0)) {
+                deferred.push_back(c);
+                continue;
+            }
+
+            int bit = 0;
+            while (forbidden & (uint64_t(1) << bit))
+                ++bit;
+
+            for (int k = offsets[c]; k < offsets[c + 1]; ++k)
+                usedMask[particleIds[k]] |= uint64_t(1) << bit;
+
+            m_colors[c] = windowBase + bit;
+            if (m_colors[c] + 1 > colorCount)
+                colorCount = m_colors[c] + 1;
+        }
+
+        pending.swap(deferred);
+        windowBase += 64;
+    }
+
+    m_colorOffsets.assign(colorCount + 1, 0);
+    for (int c = 0; c < constraintCount; ++c)
+        m_colorOffsets[m_colors[c] + 1]++;
+    for (int k = 0; k < colorCount; ++k)
+        m_colorOffsets[k + 1] += m_colorOffsets[k];
+
+    std::vector<int> cursor(m_colorOffsets.begin(), m_colorOffsets.end() - 1);
+    m_order.resize(constraintCount > 0 ? constraintCount : 0);
+    for (int c = 0; c < constraintCount; ++c)
+        m_order[cursor[m_colors[c]]++] = c;
+}
+
+void ConstraintColoring::clear() {
+    m_colors.clear();
+    m_order.clear();
+    m_colorOffsets.assign(1, 0);
+}
+
+}
@@ -0,0 +1,431 @@
+#include "physics/DistanceBatch.hpp"
+#include "physics/ConstraintColoring.hpp"
+#include <algorithm>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CLOTHSDK_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace ClothSDK {
+
+#ifdef CLOTHSDK_X86_SIMD
+namespace {
+
+// Both kernels mirror DistanceBatch::project operation by operation. Lanes whose
+// constraint is degenerate (length < 1e-6 or two static particles) keep their
+// previous state, matching the early returns of the scalar code. The float build
+// gets its own pair with twice the lanes per register.
+
+#ifdef CLOTHSDK_SINGLE_PRECISION
+
+__attribute__((target("avx2")))
+int solveDistanceAvx2(float* px, float* py, float* pz, const float* invMass,
+                      const int* idA, const int* idB, const float* restLength,
+                      const float* compliance, float* lambda, float dtSq, int begin, int end) {
+    const __m256 minLength = _mm256_set1_ps(1e-6f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 dtSqV = _mm256_set1_ps(dtSq);
+    alignas(32) float outA[3][8];
+    alignas(32) float outB[3][8];
+
+    int k = begin;
+    for (; k + 8 <= end; k += 8) {
+        __m256i ia = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idA + k));
+        __m256i ib = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idB + k));
+
+        __m256 ax = _mm256_i32gather_ps(px, ia, 4);
+        __m256 ay = _mm256_i32gather_ps(py, ia, 4);
+        __m256 az = _mm256_i32gather_ps(pz, ia, 4);
+        __m256 bx = _mm256_i32gather_ps(px, ib, 4);
+        __m256 by = _mm256_i32gather_ps(py, ib, 4);
+        __m256 bz = _mm256_i32gather_ps(pz, ib, 4);
+        __m256 wA = _mm256_i32gather_ps(invMass, ia, 4);
+        __m256 wB = _mm256_i32gather_ps(invMass, ib, 4);
+
+        __m256 dx = _mm256_sub_ps(ax, bx);
+        __m256 dy = _mm256_sub_ps(ay, by);
+        __m256 dz = _mm256_sub_ps(az, bz);
+        __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        __m256 length = _mm256_sqrt_ps(lengthSq);
+        __m256 wSum = _mm256_add_ps(wA, wB);
+
+        __m256 active = _mm256_and_ps(_mm256_cmp_ps(length, minLength, _CMP_NLT_UQ),
+                                      _mm256_cmp_ps(wSum, zero, _CMP_NEQ_UQ));
+
+        __m256 nx = _mm256_div_ps(dx, length);
+        __m256 ny = _mm256_div_ps(dy, length);
+        __m256 nz = _mm256_div_ps(dz, length);
+        __m256 C = _mm256_sub_ps(length, _mm256_loadu_ps(restLength + k));
+
+        __m256 alphaHat = _mm256_div_ps(_mm256_loadu_ps(compliance + k), dtSqV);
+        __m256 lam = _mm256_loadu_ps(lambda + k);
+        __m256 numerator = _mm256_sub_ps(_mm256_xor_ps(C, signMask), _mm256_mul_ps(alphaHat, lam));
+        __m256 deltaLambda = _mm256_div_ps(numerator, _mm256_add_ps(wSum, alphaHat));
+        _mm256_storeu_ps(lambda + k, _mm256_blendv_ps(lam, _mm256_add_ps(lam, deltaLambda), active));
+
+        _mm256_store_ps(outA[0], _mm256_blendv_ps(ax, _mm256_add_ps(ax, _mm256_mul_ps(_mm256_mul_ps(wA, nx), deltaLambda)), active));
+        _mm256_store_ps(outA[1], _mm256_blendv_ps(ay, _mm256_add_ps(ay, _mm256_mul_ps(_mm256_mul_ps(wA, ny), deltaLambda)), active));
+        _mm256_store_ps(outA[2], _mm256_blendv_ps(az, _mm256_add_ps(az, _mm256_mul_ps(_mm256_mul_ps(wA, nz), deltaLambda)), active));
+        _mm256_store_ps(outB[0], _mm256_blendv_ps(bx, _mm256_sub_ps(bx, _mm256_mul_ps(_mm256_mul_ps(wB, nx), deltaLambda)), active));
+        _mm256_store_ps(outB[1], _mm256_blendv_ps(by, _mm256_sub_ps(by, _mm256_mul_ps(_mm256_mul_ps(wB, ny), deltaLambda)), active));
+        _mm256_store_ps(outB[2], _mm256_blendv_ps(bz, _mm256_sub_ps(bz, _mm256_mul_ps(_mm256_mul_ps(wB, nz), deltaLambda)), active));
+
+        for (int lane = 0; lane < 8; ++lane) {
+            int a = idA[k + lane];
+            int b = idB[k + lane];
+            px[a] = outA[0][lane]; py[a] = outA[1][lane]; pz[a] = outA[2][lane];
+            px[b] = outB[0][lane]; py[b] = outB[1][lane]; pz[b] = outB[2][lane];
+        }
+    }
+    return k;
+}
+
+__attribute__((target("avx512f")))
+int solveDistanceAvx512(float* px, float* py, float* pz, const float* invMass,
+                        const int* idA, const int* idB, const float* restLength,
+                        const float* compliance, float* lambda, float dtSq, int begin, int end) {
+    const __m512 minLength = _mm512_set1_ps(1e-6f);
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512i signMask = _mm512_set1_epi32(static_cast<int>(0x80000000U));
+    const __m512 dtSqV = _mm512_set1_ps(dtSq);
+
+    int k = begin;
+    for (; k + 16 <= end; k += 16) {
+        __m512i ia = _mm512_loadu_si512(idA + k);
+        __m512i ib = _mm512_loadu_si512(idB + k);
+
+        __m512 ax = _mm512_i32gather_ps(ia, px, 4);
+        __m512 ay = _mm512_i32gather_ps(ia, py, 4);
+        __m512 az = _mm512_i32gather_ps(ia, pz, 4);
+        __m512 bx = _mm512_i32gather_ps(ib, px, 4);
+        __m512 by = _mm512_i32gather_ps(ib, py, 4);
+        __m512 bz = _mm512_i32gather_ps(ib, pz, 4);
+        __m512 wA = _mm512_i32gather_ps(ia, invMass, 4);
+        __m512 wB = _mm512_i32gather_ps(ib, invMass, 4);
+
+        __m512 dx = _mm512_sub_ps(ax, bx);
+        __m512 dy = _mm512_sub_ps(ay, by);
+        __m512 dz = _mm512_sub_ps(az, bz);
+        __m512 lengthSq = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy)), _mm512_mul_ps(dz, dz));
+        __m512 length = _mm512_sqrt_ps(lengthSq);
+        __m512 wSum = _mm512_add_ps(wA, wB);
+
+        __mmask16 active = _mm512_cmp_ps_mask(length, minLength, _CMP_NLT_UQ) &
+                           _mm512_cmp_ps_mask(wSum, zero, _CMP_NEQ_UQ);
+        if (!active) continue;
+
+        __m512 nx = _mm512_div_ps(dx, length);
+        __m512 ny = _mm512_div_ps(dy, length);
+        __m512 nz = _mm512_div_ps(dz, length);
+        __m512 C = _mm512_sub_ps(length, _mm512_loadu_ps(restLength + k));
+        __m512 negC = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(C), signMask));
+
+        __m512 alphaHat = _mm512_div_ps(_mm512_loadu_ps(compliance + k), dtSqV);
+        __m512 lam = _mm512_loadu_ps(lambda + k);
+        __m512 numerator = _mm512_sub_ps(negC, _mm512_mul_ps(alphaHat, lam));
+        __m512 deltaLambda = _mm512_div_ps(numerator, _mm512_add_ps(wSum, alphaHat));
+        _mm512_mask_storeu_ps(lambda + k, active, _mm512_add_ps(lam, deltaLambda));
+
+        _mm512_mask_i32scatter_ps(px, active, ia, _mm512_add_ps(ax, _mm512_mul_ps(_mm512_mul_ps(wA, nx), deltaLambda)), 4);
+        _mm512_mask_i32scatter_ps(py, active, ia, _mm512_add_ps(ay, _mm512_mul_ps(_mm512_mul_ps(wA, ny), deltaLambda)), 4);
+        _mm512_mask_i32scatter_ps(pz, active, ia, _mm512_add_ps(az, _mm512_mul_ps(_mm512_mul_ps(wA, nz), deltaLambda)), 4);
+        _mm512_mask_i32scatter_ps(px, active, ib, _mm512_sub_ps(bx, _mm512_mul_ps(_mm512_mul_ps(wB, nx), deltaLambda)), 4);
+        _mm512_mask_i32scatter_ps(py, active, ib, _mm512_sub_ps(by, _mm512_mul_ps(_mm512_mul_ps(wB, ny), deltaLambda)), 4);
+        _mm512_mask_i32scatter_ps(pz, active, ib, _mm512_sub_ps(bz, _mm512_mul_ps(_mm512_mul_ps(wB, nz), deltaLambda)), 4);
+    }
+    return k;
+}
+
+#else
+
+__attribute__((target("avx2")))
+int solveDistanceAvx2(double* px, double* py, double* pz, const double* invMass,
+                      const int* idA, const int* idB, const double* restLength,
+                      const double* compliance, double* lambda, double dtSq, int begin, int end) {
+    const __m256d minLength = _mm256_set1_pd(1e-6);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d dtSqV = _mm256_set1_pd(dtSq);
+    alignas(32) double outA[3][4];
+    alignas(32) double outB[3][4];
+
+    int k = begin;
+    for (; k + 4 <= end; k += 4) {
+        __m128i ia = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idA + k));
+        __m128i ib = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idB + k));
+
+        __m256d ax = _mm256_i32gather_pd(px, ia, 8);
+        __m256d ay = _mm256_i32gather_pd(py, ia, 8);
+        __m256d az = _mm256_i32gather_pd(pz, ia, 8);
+        __m256d bx = _mm256_i32gather_pd(px, ib, 8);
+        __m256d by = _mm256_i32gather_pd(py, ib, 8);
+        __m256d bz = _mm256_i32gather_pd(pz, ib, 8);
+        __m256d wA = _mm256_i32gather_pd(invMass, ia, 8);
+        __m256d wB = _mm256_i32gather_pd(invMass, ib, 8);
+
+        __m256d dx = _mm256_sub_pd(ax, bx);
+        __m256d dy = _mm256_sub_pd(ay, by);
+        __m256d dz = _mm256_sub_pd(az, bz);
+        __m256d lengthSq = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+        __m256d length = _mm256_sqrt_pd(lengthSq);
+        __m256d wSum = _mm256_add_pd(wA, wB);
+
+        __m256d active = _mm256_and_pd(_mm256_cmp_pd(length, minLength, _CMP_NLT_UQ),
+                                       _mm256_cmp_pd(wSum, zero, _CMP_NEQ_UQ));
+
+        __m256d nx = _mm256_div_pd(dx, length);
+        __m256d ny = _mm256_div_pd(dy, length);
+        __m256d nz = _mm256_div_pd(dz, length);
+        __m256d C = _mm256_sub_pd(length, _mm256_loadu_pd(restLength + k));
+
+        __m256d alphaHat = _mm256_div_pd(_mm256_loadu_pd(compliance + k), dtSqV);
+        __m256d lam = _mm256_loadu_pd(lambda + k);
+        __m256d numerator = _mm256_sub_pd(_mm256_xor_pd(C, signMask), _mm256_mul_pd(alphaHat, lam));
+        __m256d deltaLambda = _mm256_div_pd(numerator, _mm256_add_pd(wSum, alphaHat));
+        _mm256_storeu_pd(lambda + k, _mm256_blendv_pd(lam, _mm256_add_pd(lam, deltaLambda), active));
+
+        _mm256_store_pd(outA[0], _mm256_blendv_pd(ax, _mm256_add_pd(ax, _mm256_mul_pd(_mm256_mul_pd(wA, nx), deltaLambda)), active));
+        _mm256_store_pd(outA[1], _mm256_blendv_pd(ay, _mm256_add_pd(ay, _mm256_mul_pd(_mm256_mul_pd(wA, ny), deltaLambda)), active));
+        _mm256_store_pd(outA[2], _mm256_blendv_pd(az, _mm256_add_pd(az, _mm256_mul_pd(_mm256_mul_pd(wA, nz), deltaLambda)), active));
+        _mm256_store_pd(outB[0], _mm256_blendv_pd(bx, _mm256_sub_pd(bx, _mm256_mul_pd(_mm256_mul_pd(wB, nx), deltaLambda)), active));
+        _mm256_store_pd(outB[1], _mm256_blendv_pd(by, _mm256_sub_pd(by, _mm256_mul_pd(_mm256_mul_pd(wB, ny), deltaLambda)), active));
+        _mm256_store_pd(outB[2], _mm256_blendv_pd(bz, _mm256_sub_pd(bz, _mm256_mul_pd(_mm256_mul_pd(wB, nz), deltaLambda)), active));
+
+        // AVX2 has no scatter; lanes never alias inside an independent range.
+        for (int lane = 0; lane < 4; ++lane) {
+            int a = idA[k + lane];
+            int b = idB[k + lane];
+            px[a] = outA[0][lane]; py[a] = outA[1][lane]; pz[a] = outA[2][lane];
+            px[b] = outB[0][lane]; py[b] = outB[1][lane]; pz[b] = outB[2][lane];
+        }
+    }
+    return k;
+}
+
+__attribute__((target("avx512f")))
+int solveDistanceAvx512(double* px, double* py, double* pz, const double* invMass,
+                        const int* idA, const int* idB, const double* restLength,
+                        const double* compliance, double* lambda, double dtSq, int begin, int end) {
+    const __m512d minLength = _mm512_set1_pd(1e-6);
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512i signMask = _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL));
+    const __m512d dtSqV = _mm512_set1_pd(dtSq);
+
+    int k = begin;
+    for (; k + 8 <= end; k += 8) {
+        __m256i ia = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idA + k));
+        __m256i ib = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idB + k));
+
+        __m512d ax = _mm512_i32gather_pd(ia, px, 8);
+        __m512d ay = _mm512_i32gather_pd(ia, py, 8);
+        __m512d az = _mm512_i32gather_pd(ia, pz, 8);
+        __m512d bx = _mm512_i32gather_pd(ib, px, 8);
+        __m512d by = _mm512_i32gather_pd(ib, py, 8);
+        __m512d bz = _mm512_i32gather_pd(ib, pz, 8);
+        __m512d wA = _mm512_i32gather_pd(ia, invMass, 8);
+        __m512d wB = _mm512_i32gather_pd(ib, invMass, 8);
+
+        __m512d dx = _mm512_sub_pd(ax, bx);
+        __m512d dy = _mm512_sub_pd(ay, by);
+        __m512d dz = _mm512_sub_pd(az, bz);
+        __m512d lengthSq = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)), _mm512_mul_pd(dz, dz));
+        __m512d length = _mm512_sqrt_pd(lengthSq);
+        __m512d wSum = _mm512_add_pd(wA, wB);
+
+        __mmask8 active = _mm512_cmp_pd_mask(length, minLength, _CMP_NLT_UQ) &
+                          _mm512_cmp_pd_mask(wSum, zero, _CMP_NEQ_UQ);
+        if (!active) continue;
+
+        __m512d nx = _mm512_div_pd(dx, length);
+        __m512d ny = _mm512_div_pd(dy, length);
+        __m512d nz = _mm512_div_pd(dz, length);
+        __m512d C = _mm512_sub_pd(length, _mm512_loadu_pd(restLength + k));
+        __m512d negC = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(C), signMask));
+
+        __m512d alphaHat = _mm512_div_pd(_mm512_loadu_pd(compliance + k), dtSqV);
+        __m512d lam = _mm512_loadu_pd(lambda + k);
+        __m512d numerator = _mm512_sub_pd(negC, _mm512_mul_pd(alphaHat, lam));
+        __m512d deltaLambda = _mm512_div_pd(numerator, _mm512_add_pd(wSum, alphaHat));
+        _mm512_mask_storeu_pd(lambda + k, active, _mm512_add_pd(lam, deltaLambda));
+
+        _mm512_mask_i32scatter_pd(px, active, ia, _mm512_add_pd(ax, _mm512_mul_pd(_mm512_mul_pd(wA, nx), deltaLambda)), 8);
+        _mm512_mask_i32scatter_pd(py, active, ia, _mm512_add_pd(ay, _mm512_mul_pd(_mm512_mul_pd(wA, ny), deltaLambda)), 8);
+        _mm512_mask_i32scatter_pd(pz, active, ia, _mm512_add_pd(az, _mm512_mul_pd(_mm512_mul_pd(wA, nz), deltaLambda)), 8);
+        _mm512_mask_i32scatter_pd(px, active, ib, _mm512_sub_pd(bx, _mm512_mul_pd(_mm512_mul_pd(wB, nx), deltaLambda)), 8);
+        _mm512_mask_i32scatter_pd(py, active, ib, _mm512_sub_pd(by, _mm512_mul_pd(_mm512_mul_pd(wB, ny), deltaLambda)), 8);
+        _mm512_mask_i32scatter_pd(pz, active, ib, _mm512_sub_pd(bz, _mm512_mul_pd(_mm512_mul_pd(wB, nz), deltaLambda)), 8);
+    }
+    return k;
+}
+
+#endif
+
+}
+#endif
+
+void DistanceBatch::add(int idA, int idB, Real restLength, Real compliance) {
+    m_idA.push_back(idA);
+    m_idB.push_back(idB);
+    m_restLength.push_back(restLength);
+    m_compliance.push_back(compliance);
+    m_lambda.push_back(0.0);
+    m_coloringDirty = true;
+}
+
+void DistanceBatch::reserve(std::size_t count) {
+    m_idA.reserve(count);
+    m_idB.reserve(count);
+    m_restLength.reserve(count);
+    m_compliance.reserve(count);
+    m_lambda.reserve(count);
+}
+
+void DistanceBatch::clear() {
+    m_idA.clear();
+    m_idB.clear();
+    m_restLength.clear();
+    m_compliance.clear();
+    m_lambda.clear();
+    m_colorOffsets.assign(1, 0);
+    m_coloringDirty = false;
+    m_active.clear();
+}
+
+void DistanceBatch::resetLambda() {
+    std::fill(m_lambda.begin(), m_lambda.end(), 0.0);
+}
+
+void DistanceBatch::buildColoring(int particleCount) {
+    const int count = size();
+    std::vector<int> offsets(count + 1);
+    std::vector<int> ids(2 * count);
+    for (int c = 0; c < count; ++c) {
+        offsets[c] = 2 * c;
+        ids[2 * c] = m_idA[c];
+        ids[2 * c + 1] = m_idB[c];
+    }
+    offsets[count] = 2 * count;
+
+    ConstraintColoring coloring;
+    coloring.build(offsets, ids, particleCount);
+
+    const std::vector<int>& order = coloring.getOrder();
+    ConstraintColoring::permute(m_idA, order);
+    ConstraintColoring::permute(m_idB, order);
+    ConstraintColoring::permute(m_restLength, order);
+    ConstraintColoring::permute(m_compliance, order);
+    ConstraintColoring::permute(m_lambda, order);
+    m_colorOffsets = coloring.getColorOffsets();
+    m_coloringDirty = false;
+    m_active.clear();
+}
+
+void DistanceBatch::solve(ParticleBuffer& particles, Real dt) {
+    if (m_active.isEnabled()) {
+        for (size_t color = 0; color + 1 < m_colorOffsets.size(); ++color) {
+            const int begin = m_active.colorBegin(static_cast<int>(color));
+            const int end = m_active.colorEnd(static_cast<int>(color));
+
+            #pragma omp parallel for if(end - begin > 1)
+            for (int run = begin; run < end; ++run)
+                solveIndependentRange(particles, dt, m_active.runBegin(run), m_active.runEnd(run));
+        }
+        return;
+    }
+
+    for (size_t color = 0; color + 1 < m_colorOffsets.size(); ++color) {
+        const int begin = m_colorOffsets[color];
+        const int end = m_colorOffsets[color + 1];
+        const int chunk = 256;
+
+        #pragma omp parallel for if(end - begin > chunk)
+        for (int k = begin; k < end; k += chunk)
+            solveIndependentRange(particles, dt, k, std::min(k + chunk, end));
+    }
+}
+
+void DistanceBatch::setActiveParticles(const uint8_t* awake) {
+    if (awake)
+        m_active.build(m_colorOffsets, m_idA.data(), awake, 256);
+    else
+        m_active.clear();
+}
+
+void DistanceBatch::solveRange(ParticleBuffer& particles, Real dt, int begin, int end) {
+    Real* px = particles.posX();
+    Real* py = particles.posY();
+    Real* pz = particles.posZ();
+    const Real* invMass = particles.invMass();
+    const Real dtSq = dt * dt;
+
+    for (int k = begin; k < end; ++k)
+        project(px, py, pz, invMass, m_idA[k], m_idB[k], m_restLength[k], m_compliance[k] / dtSq, m_lambda[k]);
+}
+
+void DistanceBatch::solveIndependentRange(ParticleBuffer& particles, Real dt, int begin, int end) {
+    int k = begin;
+
+#ifdef CLOTHSDK_X86_SIMD
+    const Real dtSq = dt * dt;
+    if (m_simdLevel == SimdLevel::AVX512) {
+        k = solveDistanceAvx512(particles.posX(), particles.posY(), particles.posZ(), particles.invMass(),
+                                m_idA.data(), m_idB.data(), m_restLength.data(), m_compliance.data(),
+                                m_lambda.data(), dtSq, begin, end);
+    } else if (m_simdLevel == SimdLevel::AVX2) {
+        k = solveDistanceAvx2(particles.posX(), particles.posY(), particles.posZ(), particles.invMass(),
+                              m_idA.data(), m_idB.data(), m_restLength.data(), m_compliance.data(),
+                              m_lambda.data(), dtSq, begin, end);
+    }
+#endif
+
+    solveRange(particles, dt, k, end);
+}
+
+Real DistanceBatch::maxRelativeResidual(const ParticleBuffer& particles, Real dt) const {
+    const Real* px = particles.posX();
+    const Real* py = particles.posY();
+    const Real* pz = particles.posZ();
+    const Real dtSq = dt * dt;
+    Real maxResidual = 0.0;
+
+    auto residual = [&](int k) {
+        const int a = m_idA[k];
+        const int b = m_idB[k];
+        const Real rest = m_restLength[k];
+        if (rest <= Real(0))
+            return Real(0);
+        const Real dx = px[a] - px[b];
+        const Real dy = py[a] - py[b];
+        const Real dz = pz[a] - pz[b];
+        const Real C = std::sqrt(dx * dx + dy * dy + dz * dz) - rest;
+        return std::abs(C + m_compliance[k] / dtSq * m_lambda[k]) / rest;
+    };
+
+    // Constraints skipped by solve() keep a zero lambda, so they are skipped here too.
+    if (m_active.isEnabled()) {
+        const int runCount = m_active.runCount();
+
+        #pragma omp parallel for schedule(static) reduction(max : maxResidual) if(runCount > 16)
+        for (int run = 0; run < runCount; ++run) {
+            for (int k = m_active.runBegin(run); k < m_active.runEnd(run); ++k)
+                maxResidual = std::max(maxResidual, residual(k));
+        }
+        return maxResidual;
+    }
+
+    const int count = size();
+
+    #pragma omp parallel for schedule(static) reduction(max : maxResidual) if(count > 4096)
+    for (int k = 0; k < count; ++k)
+        maxResidual = std::max(maxResidual, residual(k));
+    return maxResidual;
+}
+
+void DistanceBatch::setSimdLevel(SimdLevel level) {
+    SimdLevel supported = detectSimdLevel();
+    m_simdLevel = static_cast<int>(level) > static_cast<int>(supported) ? supported : level;
+}
+
+}
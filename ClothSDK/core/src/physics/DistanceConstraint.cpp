@@ -1,35 +1,20 @@
 #include "physics/DistanceConstraint.hpp"
+#include "physics/DistanceBatch.hpp"
 
 namespace ClothSDK {
 
-DistanceConstraint::DistanceConstraint(int idA, int idB, double restLength, double compliance)
+DistanceConstraint::DistanceConstraint(int idA, int idB, Real restLength, Real compliance)
 : m_idA(idA), m_idB(idB), m_restLength(restLength), m_compliance(compliance) {}
 
-void DistanceConstraint::solve(std::vector<Particle>& particles, double dt) {
-    Particle& pA = particles[m_idA];
-    Particle& pB = particles[m_idB];
-
-    Eigen::Vector3d delta = pA.getPosition() - pB.getPosition();
-    double currentLength = delta.norm();
-
-    if (currentLength < 1e-6)
-        return;
-
-    double wA = pA.getInverseMass();
-    double wB = pB.getInverseMass();
-    double wSum = wA + wB;
-    if (wSum == 0.0)
-        return;
-
-    Eigen::Vector3d n = delta / currentLength;
-    double C = currentLength - m_restLength;  
-
-    double alphaHat = m_compliance / (dt * dt);
-    double deltaLambda = (-C - alphaHat * m_lambda) / (wSum + alphaHat);
-    m_lambda += deltaLambda;
+void DistanceConstraint::solve(ParticleBuffer& particles, Real dt) {
+    Real alphaHat = m_compliance / (dt * dt);
+    DistanceBatch::project(particles.posX(), particles.posY(), particles.posZ(), particles.invMass(),
+                           m_idA, m_idB, m_restLength, alphaHat, m_lambda);
+}
 
-    pA.setPosition(pA.getPosition() + wA * n * deltaLambda);
-    pB.setPosition(pB.getPosition() - wB * n * deltaLambda);
+void DistanceConstraint::getParticleIds(std::vector<int>& outIds) const {
+    outIds.push_back(m_idA);
+    outIds.push_back(m_idB);
 }
 
 }
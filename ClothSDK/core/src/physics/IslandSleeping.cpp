@@ -0,0 +1,192 @@
+#include "physics/IslandSleeping.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace ClothSDK {
+
+namespace {
+
+int findRoot(std::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+}
+
+void IslandSleeping::build(int particleCount, const std::vector<std::pair<int, int>>& edges,
+                           const std::vector<int>& restless) {
+    std::vector<int> parent(particleCount);
+    std::iota(parent.begin(), parent.end(), 0);
+    for (const auto& [a, b] : edges) {
+        const int rootA = findRoot(parent, a);
+        const int rootB = findRoot(parent, b);
+        if (rootA != rootB)
+            parent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+    }
+
+    // Islands are numbered by their lowest particle id, so the numbering only depends on the topology.
+    m_island.assign(particleCount, -1);
+    std::vector<int> rootIsland(particleCount, -1);
+    int islandCount = 0;
+    for (int i = 0; i < particleCount; ++i) {
+        const int root = findRoot(parent, i);
+        if (rootIsland[root] < 0)
+            rootIsland[root] = islandCount++;
+        m_island[i] = rootIsland[root];
+    }
+
+    m_islandOffsets.assign(islandCount + 1, 0);
+    for (int i = 0; i < particleCount; ++i)
+        m_islandOffsets[m_island[i] + 1]++;
+    for (int island = 0; island < islandCount; ++island)
+        m_islandOffsets[island + 1] += m_islandOffsets[island];
+    m_islandParticles.resize(particleCount);
+    std::vector<int> cursor(m_islandOffsets.begin(), m_islandOffsets.end() - 1);
+    for (int i = 0; i < particleCount; ++i)
+        m_islandParticles[cursor[m_island[i]]++] = i;
+
+    m_restingSubsteps.assign(islandCount, 0);
+    m_restless.assign(islandCount, 0);
+    for (int particle : restless)
+        m_restless[m_island[particle]] = 1;
+    m_moving.assign(islandCount, 0);
+    m_awake.assign(particleCount, 1);
+    m_sleepingIslands = 0;
+    m_sleepingParticles = 0;
+}
+
+void IslandSleeping::clear() {
+    m_island.clear();
+    m_islandOffsets.assign(1, 0);
+    m_islandParticles.clear();
+    m_restingSubsteps.clear();
+    m_restless.clear();
+    m_moving.clear();
+    m_awake.clear();
+    m_sleepingIslands = 0;
+    m_sleepingParticles = 0;
+}
+
+bool IslandSleeping::update(ParticleBuffer& particles, Real dt, const SleepSettings& settings) {
+    const Real* px = particles.posX();
+    const Real* py = particles.posY();
+    const Real* pz = particles.posZ();
+    const Real* ox = particles.oldX();
+    const Real* oy = particles.oldY();
+    const Real* oz = particles.oldZ();
+    const Real limit = settings.velocityThreshold * dt;
+    const Real limitSq = limit * limit;
+    const int islandCount = getIslandCount();
+
+    // Islands are scanned independently and stop at their first moving particle.
+    #pragma omp parallel for schedule(dynamic, 4) if(islandCount > 1)
+    for (int island = 0; island < islandCount; ++island) {
+        m_moving[island] = 0;
+        if (m_restingSubsteps[island] < 0)
+            continue;
+        for (int k = m_islandOffsets[island]; k < m_islandOffsets[island + 1]; ++k) {
+            const int i = m_islandParticles[k];
+            const Real dx = px[i] - ox[i];
+            const Real dy = py[i] - oy[i];
+            const Real dz = pz[i] - oz[i];
+            if (dx * dx + dy * dy + dz * dz > limitSq) {
+                m_moving[island] = 1;
+                break;
+            }
+        }
+    }
+
+    bool fellAsleep = false;
+    for (int island = 0; island < islandCount; ++island) {
+        int& resting = m_restingSubsteps[island];
+        if (resting < 0)
+            continue;
+        resting = m_moving[island] ? 0 : resting + 1;
+        if (resting >= settings.substeps && !m_restless[island]) {
+            sleepIsland(island, particles);
+            fellAsleep = true;
+        }
+    }
+    return fellAsleep;
+}
+
+bool IslandSleeping::wakeParticle(int particle) {
+    const int island = m_island[particle];
+    if (m_restingSubsteps[island] >= 0)
+        return false;
+    wakeIsland(island);
+    return true;
+}
+
+bool IslandSleeping::wakeAll() {
+    if (m_sleepingIslands == 0)
+        return false;
+    for (int island = 0; island < getIslandCount(); ++island) {
+        if (m_restingSubsteps[island] < 0)
+            wakeIsland(island);
+    }
+    return true;
+}
+
+void IslandSleeping::setState(const int32_t* state) {
+    m_sleepingIslands = 0;
+    m_sleepingParticles = 0;
+    for (int island = 0; island < getIslandCount(); ++island) {
+        const int first = m_islandParticles[m_islandOffsets[island]];
+        m_restingSubsteps[island] = std::max(-1, static_cast<int>(state[first]));
+        const uint8_t awake = m_restingSubsteps[island] >= 0;
+        for (int k = m_islandOffsets[island]; k < m_islandOffsets[island + 1]; ++k)
+            m_awake[m_islandParticles[k]] = awake;
+        if (!awake) {
+            ++m_sleepingIslands;
+            m_sleepingParticles += m_islandOffsets[island + 1] - m_islandOffsets[island];
+        }
+    }
+}
+
+void IslandSleeping::getState(std::vector<int32_t>& state) const {
+    state.resize(m_island.size());
+    for (size_t i = 0; i < m_island.size(); ++i)
+        state[i] = m_restingSubsteps[m_island[i]];
+}
+
+SleepStats IslandSleeping::getStats() const {
+    SleepStats stats;
+    stats.sleepingParticles = m_sleepingParticles;
+    stats.activeParticles = getParticleCount() - m_sleepingParticles;
+    stats.islands = getIslandCount();
+    stats.sleepingIslands = m_sleepingIslands;
+    return stats;
+}
+
+void IslandSleeping::sleepIsland(int island, ParticleBuffer& particles) {
+    Real* px = particles.posX();
+    Real* py = particles.posY();
+    Real* pz = particles.posZ();
+    Real* ox = particles.oldX();
+    Real* oy = particles.oldY();
+    Real* oz = particles.oldZ();
+    for (int k = m_islandOffsets[island]; k < m_islandOffsets[island + 1]; ++k) {
+        const int i = m_islandParticles[k];
+        ox[i] = px[i];
+        oy[i] = py[i];
+        oz[i] = pz[i];
+        m_awake[i] = 0;
+    }
+    m_restingSubsteps[island] = -1;
+    ++m_sleepingIslands;
+    m_sleepingParticles += m_islandOffsets[island + 1] - m_islandOffsets[island];
+}
+
+void IslandSleeping::wakeIsland(int island) {
+    for (int k = m_islandOffsets[island]; k < m_islandOffsets[island + 1]; ++k)
+        m_awake[m_islandParticles[k]] = 1;
+    m_restingSubsteps[island] = 0;
+    --m_sleepingIslands;
+    m_sleepingParticles -= m_islandOffsets[island + 1] - m_islandOffsets[island];
+}
+
+}
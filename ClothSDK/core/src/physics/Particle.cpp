@@ -2,25 +2,28 @@
 
 namespace ClothSDK {
 
-Particle::Particle(const Eigen::Vector3d& pos) : m_position(pos), m_oldPosition(pos), m_acceleration(Eigen::Vector3d::Zero()), inverseMass(1.0) {}
+Particle::Particle(const Vector3r& pos) : m_position(pos), m_oldPosition(pos), m_acceleration(Vector3r::Zero()), inverseMass(1.0) {}
 
-void Particle::addForce(const Eigen::Vector3d& force) {
+Particle::Particle(const Vector3r& position, const Vector3r& oldPosition, const Vector3r& acceleration, Real invMass)
+: m_position(position), m_oldPosition(oldPosition), m_acceleration(acceleration), inverseMass(invMass) {}
+
+void Particle::addForce(const Vector3r& force) {
     m_acceleration += force * inverseMass;
 }
 
 void Particle::clearForces() {
-    m_acceleration = Eigen::Vector3d::Zero();
+    m_acceleration = Vector3r::Zero();
 }
 
-void Particle::integrate(double deltaTime) {
+void Particle::integrate(Real deltaTime) {
     if (inverseMass <= 0.0) {
-        m_acceleration = Eigen::Vector3d::Zero();
+        m_acceleration = Vector3r::Zero();
         m_oldPosition = m_position; 
         return;
     }
 
-    Eigen::Vector3d velocity = (m_position - m_oldPosition) * 0.988;
-    Eigen::Vector3d currentPos = m_position;
+    Vector3r velocity = (m_position - m_oldPosition) * 0.988;
+    Vector3r currentPos = m_position;
 
     m_position = m_position + velocity + m_acceleration * (deltaTime * deltaTime);
     
@@ -28,22 +31,22 @@ void Particle::integrate(double deltaTime) {
     clearForces();
 }
 
-void Particle::setPosition(const Eigen::Vector3d& newPosition) {
+void Particle::setPosition(const Vector3r& newPosition) {
     m_position = newPosition;
 }
 
-void Particle::setInverseMass(double invMass) {
+void Particle::setInverseMass(Real invMass) {
     inverseMass = invMass;
 }
 
-void Particle::setOldPosition(const Eigen::Vector3d& newOldPosition) {
+void Particle::setOldPosition(const Vector3r& newOldPosition) {
     m_oldPosition = newOldPosition;
 }
 
-void Particle::addMass(double mass) {
+void Particle::addMass(Real mass) {
     if (inverseMass == 0.0) return;
 
-    double currentMass = 1.0 / inverseMass;
+    Real currentMass = 1.0 / inverseMass;
     currentMass += mass;
     inverseMass = 1.0 / currentMass;
 }
@@ -0,0 +1,104 @@
+#include "physics/ParticleBuffer.hpp"
+#include <algorithm>
+
+namespace ClothSDK {
+
+namespace {
+    constexpr std::size_t kStrideGranularity = 64 / sizeof(Real); // One cache line of Real
+
+    std::size_t roundUpStride(std::size_t count) {
+        return (count + kStrideGranularity - 1) / kStrideGranularity * kStrideGranularity;
+    }
+}
+
+ParticleBuffer::ParticleBuffer() : m_size(0), m_stride(0) {}
+
+ParticleBuffer::ParticleBuffer(const std::vector<Particle>& particles) : m_size(0), m_stride(0) {
+    reserve(particles.size());
+    for (const auto& particle : particles)
+        add(particle);
+}
+
+int ParticleBuffer::add(const Particle& particle) {
+    if (m_size == m_stride)
+        reserve(std::max<std::size_t>(kStrideGranularity, m_stride * 2));
+
+    int i = static_cast<int>(m_size++);
+    setPosition(i, particle.getPosition());
+    setOldPosition(i, particle.getOldPosition());
+    accX()[i] = particle.getAcceleration().x();
+    accY()[i] = particle.getAcceleration().y();
+    accZ()[i] = particle.getAcceleration().z();
+    m_inverseMass[i] = particle.getInverseMass();
+    return i;
+}
+
+int ParticleBuffer::append(const Real* positions, std::size_t count, Real inverseMass) {
+    if (m_size + count > m_stride)
+        reserve(std::max(m_size + count, m_stride * 2));
+
+    const int first = static_cast<int>(m_size);
+    Real* px = posX(); Real* py = posY(); Real* pz = posZ();
+    Real* ox = oldX(); Real* oy = oldY(); Real* oz = oldZ();
+    Real* ax = accX(); Real* ay = accY(); Real* az = accZ();
+    for (std::size_t k = 0; k < count; ++k) {
+        const std::size_t i = m_size + k;
+        px[i] = ox[i] = positions[3 * k];
+        py[i] = oy[i] = positions[3 * k + 1];
+        pz[i] = oz[i] = positions[3 * k + 2];
+        ax[i] = ay[i] = az[i] = 0.0;
+        m_inverseMass[i] = inverseMass;
+    }
+    m_size += count;
+    return first;
+}
+
+void ParticleBuffer::reserve(std::size_t count) {
+    if (count <= m_stride) return;
+
+    std::size_t newStride = roundUpStride(count);
+    regrowBlock(m_position, m_stride, newStride, m_size);
+    regrowBlock(m_oldPosition, m_stride, newStride, m_size);
+    regrowBlock(m_acceleration, m_stride, newStride, m_size);
+    m_inverseMass.resize(newStride, 0.0);
+    m_stride = newStride;
+}
+
+void ParticleBuffer::resize(std::size_t count) {
+    reserve(count);
+    for (std::size_t i = m_size; i < count; ++i) {
+        posX()[i] = posY()[i] = posZ()[i] = 0.0;
+        oldX()[i] = oldY()[i] = oldZ()[i] = 0.0;
+        accX()[i] = accY()[i] = accZ()[i] = 0.0;
+        m_inverseMass[i] = 0.0;
+    }
+    m_size = count;
+}
+
+void ParticleBuffer::clear() {
+    m_size = 0;
+}
+
+Particle ParticleBuffer::operator[](std::size_t i) const {
+    int id = static_cast<int>(i);
+    return Particle(getPosition(id), getOldPosition(id), getAcceleration(id), m_inverseMass[i]);
+}
+
+void ParticleBuffer::addMass(int i, Real mass) {
+    Real& w = m_inverseMass[i];
+    if (w == 0.0) return;
+
+    Real currentMass = 1.0 / w;
+    currentMass += mass;
+    w = 1.0 / currentMass;
+}
+
+void ParticleBuffer::regrowBlock(AlignedVector<Real>& block, std::size_t oldStride, std::size_t newStride, std::size_t count) {
+    AlignedVector<Real> grown(3 * newStride, 0.0);
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        std::copy_n(block.data() + axis * oldStride, count, grown.data() + axis * newStride);
+    }
+    block.swap(grown);
+}
+
+}
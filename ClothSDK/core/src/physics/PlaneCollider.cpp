@@ -1,34 +1,48 @@
 #include "physics/PlaneCollider.hpp"
-#include "physics/Particle.hpp"
+#include "physics/ParticleBuffer.hpp"
 
 namespace ClothSDK {
 
-PlaneCollider::PlaneCollider(const Eigen::Vector3d& origin, const Eigen::Vector3d& normal, double friction) 
+PlaneCollider::PlaneCollider(const Vector3r& origin, const Vector3r& normal, Real friction) 
 : m_origin(origin), m_normal(normal.normalized()) {
     m_friction = friction;
 }
 
-void PlaneCollider::resolve(std::vector<Particle>& particles, double) {
-    double thickness = 0.01;
-    for(auto& particle : particles) {
-        Eigen::Vector3d vec = particle.getPosition() - m_origin;
-        double distance = vec.dot(m_normal);
+void PlaneCollider::resolve(ParticleBuffer& particles, Real) {
+    Real thickness = 0.01;
+    Real* px = particles.posX();
+    Real* py = particles.posY();
+    Real* pz = particles.posZ();
+    Real* ox = particles.oldX();
+    Real* oy = particles.oldY();
+    Real* oz = particles.oldZ();
+    const Real nx = m_normal.x(), ny = m_normal.y(), nz = m_normal.z();
+    const Real keep = 1.0 - m_friction;
+    const int count = static_cast<int>(particles.size());
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        Real distance = (px[i] - m_origin.x()) * nx + (py[i] - m_origin.y()) * ny + (pz[i] - m_origin.z()) * nz;
 
         if (distance < thickness) {
-            double penetration = thickness - distance;
-            Eigen::Vector3d newPosition = particle.getPosition() + m_normal * penetration;
-            particle.setPosition(newPosition);
-
-            Eigen::Vector3d displacement = particle.getPosition() - particle.getOldPosition();
-            Eigen::Vector3d normalDisp = m_normal * displacement.dot(m_normal);
-            Eigen::Vector3d tangentialDisp = displacement - normalDisp;
-            Eigen::Vector3d newDisplacement = normalDisp + tangentialDisp * (1.0 - m_friction);
-
-            particle.setOldPosition(particle.getPosition() - newDisplacement);
-
-
+            Real penetration = thickness - distance;
+            px[i] += nx * penetration;
+            py[i] += ny * penetration;
+            pz[i] += nz * penetration;
+
+            Real dx = px[i] - ox[i];
+            Real dy = py[i] - oy[i];
+            Real dz = pz[i] - oz[i];
+            Real normalPart = dx * nx + dy * ny + dz * nz;
+            Real tx = dx - nx * normalPart;
+            Real ty = dy - ny * normalPart;
+            Real tz = dz - nz * normalPart;
+
+            ox[i] = px[i] - (nx * normalPart + tx * keep);
+            oy[i] = py[i] - (ny * normalPart + ty * keep);
+            oz[i] = pz[i] - (nz * normalPart + tz * keep);
         }
     }
 }
 
-}
\ No newline at end of file
+}
@@ -1,201 +1,823 @@
 #include <omp.h>
 
 #include "physics/Solver.hpp"
-#include "physics/DistanceConstraint.hpp"
-#include "physics/BendingConstraint.hpp"
 #include "physics/PlaneCollider.hpp"
 #include "physics/SphereCollider.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 namespace ClothSDK {
+
+    namespace {
+        void scatterInterleaved(const Real* interleaved, Real* x, Real* y, Real* z, int count) {
+            #pragma omp parallel for schedule(static) if(count > 16384)
+            for (int i = 0; i < count; ++i) {
+                x[i] = interleaved[3 * i];
+                y[i] = interleaved[3 * i + 1];
+                z[i] = interleaved[3 * i + 2];
+            }
+        }
+
+        // omp_set_num_threads() only affects the calling thread, so the budget is
+        // restored on exit without touching solvers stepped on other threads.
+        class ThreadBudget {
+        public:
+            explicit ThreadBudget(int count) : m_previous(count > 0 ? omp_get_max_threads() : 0) {
+                if (count > 0)
+                    omp_set_num_threads(count);
+            }
+            ~ThreadBudget() {
+                if (m_previous > 0)
+                    omp_set_num_threads(m_previous);
+            }
+
+        private:
+            int m_previous;
+        };
+    }
+
     Solver::Solver()
     : m_gravity(0.0, -9.81, 0.0), m_substeps(15), m_iterations(2), m_wind(2.0, 0.0, 1.0),
-    m_airDensity(0.1), m_time(0.0), m_collisionCompliance(1e-9), m_thickness(0.08), m_spatialHash(10007, 0.08) {}
+    m_airDensity(0.1), m_time(0.0), m_collisionCompliance(1e-9), m_thickness(0.08), m_spatialHash(0.08) {
+        m_spatialHash.setStoreSortedPositions(true);
+    }
 
-    void Solver::update(double deltaTime) {
-        m_spatialHash.setCellSize(m_thickness); 
-        m_spatialHash.build(m_particles);
+    void Solver::update(Real deltaTime) {
+        ThreadBudget threads(m_threadCount);
+#ifdef CLOTHSDK_ENABLE_PROFILING
+        const bool profiling = m_profilingEnabled;
+        const auto updateStart = std::chrono::steady_clock::now();
+        if (profiling)
+            std::fill(std::begin(m_stats.lastFrameMs), std::end(m_stats.lastFrameMs), 0.0);
+#endif
+        {
+            PhaseTimer timer(phaseTimes(), SolverPhase::HashBuild);
+            m_spatialHash.setCellSize(m_thickness); 
+            m_spatialHash.build(m_particles);
+        }
+        {
+            PhaseTimer timer(phaseTimes(), SolverPhase::Topology);
+            updateTopology();
+        }
         m_time += deltaTime;
-        double substepDt = deltaTime / m_substeps;
-        for (int i = 0; i < m_substeps; i++)
-            step(substepDt);
+        int substeps = m_substeps;
+        if (m_adaptive.enabled) {
+            substeps = runAdaptiveSubsteps(deltaTime);
+        } else {
+            Real substepDt = deltaTime / m_substeps;
+            for (int i = 0; i < m_substeps; i++)
+                step(substepDt);
+            m_lastSubstepDt = substepDt;
+            m_lastMetrics = SubstepMetrics{m_substeps, 0, 0};
+        }
+
+#ifdef CLOTHSDK_ENABLE_PROFILING
+        if (profiling) {
+            m_stats.lastUpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - updateStart).count();
+            m_stats.totalUpdateMs += m_stats.lastUpdateMs;
+            m_stats.lastSubsteps = substeps;
+            m_stats.substeps += substeps;
+            ++m_stats.frames;
+            for (int p = 0; p < SolverStats::kPhaseCount; ++p) {
+                m_stats.totalMs[p] += m_stats.lastFrameMs[p];
+                m_stats.maxFrameMs[p] = std::max(m_stats.maxFrameMs[p], m_stats.lastFrameMs[p]);
+            }
+        }
+#endif
+    }
+
+    int Solver::runAdaptiveSubsteps(Real deltaTime) {
+        const Real displacementLimit = m_adaptive.maxDisplacement * m_thickness;
+        int planned = m_adaptive.clamp(m_adaptiveSubsteps);
+        Real dt = deltaTime / planned;
+        if (m_lastSubstepDt > Real(0) && dt != m_lastSubstepDt)
+            rescaleVelocities(dt / m_lastSubstepDt);
+
+        SubstepMetrics metrics{0, 0, 0};
+        Real errorRatio = 0;        // Worst error at the current substep length.
+        while (metrics.substeps < planned) {
+            step(dt);
+            ++metrics.substeps;
+
+            const Real residual = m_substepResidual;
+            Real displacement;
+            {
+                PhaseTimer timer(phaseTimes(), SolverPhase::SubstepControl);
+                displacement = maxSubstepDisplacement();
+            }
+            metrics.maxDisplacement = std::max(metrics.maxDisplacement, displacement);
+            metrics.maxResidual = std::max(metrics.maxResidual, residual);
+            const Real ratio = std::max(displacementLimit > Real(0) ? displacement / displacementLimit : Real(0),
+                                        m_adaptive.maxResidual > Real(0) ? residual / m_adaptive.maxResidual : Real(0));
+            errorRatio = std::max(errorRatio, ratio);
+
+            // Refine the rest of the frame at once rather than waiting for the next one.
+            const int remaining = planned - metrics.substeps;
+            if (ratio > Real(1) && remaining > 0) {
+                const int refined = std::min(m_adaptive.maxSubsteps - metrics.substeps,
+                                             static_cast<int>(std::ceil(remaining * std::min(ratio, Real(2)))));
+                if (refined > remaining) {
+                    const Real refinedDt = dt * remaining / refined;
+                    rescaleVelocities(refinedDt / dt);
+                    dt = refinedDt;
+                    planned = metrics.substeps + refined;
+                    errorRatio = 0;
+                }
+            }
+        }
+
+        m_lastSubstepDt = dt;
+        m_lastMetrics = metrics;
+        // The next frame is sized for the substep length the error was measured at.
+        const int current = static_cast<int>(std::lround(deltaTime / dt));
+        m_adaptiveSubsteps = m_adaptive.nextSubsteps(current, errorRatio);
+        return metrics.substeps;
+    }
+
+    Real Solver::maxSubstepDisplacement() const {
+        const Real* px = m_particles.posX();
+        const Real* py = m_particles.posY();
+        const Real* pz = m_particles.posZ();
+        const Real* ox = m_particles.oldX();
+        const Real* oy = m_particles.oldY();
+        const Real* oz = m_particles.oldZ();
+        const int count = static_cast<int>(m_particles.size());
+        Real maxSq = 0.0;
+
+        #pragma omp parallel for schedule(static) reduction(max : maxSq) if(count > 4096)
+        for (int i = 0; i < count; ++i) {
+            const Real dx = px[i] - ox[i];
+            const Real dy = py[i] - oy[i];
+            const Real dz = pz[i] - oz[i];
+            maxSq = std::max(maxSq, dx * dx + dy * dy + dz * dz);
+        }
+        return std::sqrt(maxSq);
+    }
+
+    void Solver::rescaleVelocities(Real ratio) {
+        const Real* px = m_particles.posX();
+        const Real* py = m_particles.posY();
+        const Real* pz = m_particles.posZ();
+        Real* ox = m_particles.oldX();
+        Real* oy = m_particles.oldY();
+        Real* oz = m_particles.oldZ();
+        const int count = static_cast<int>(m_particles.size());
+
+        // Velocity is (position - old) / dt; keep it when dt changes.
+        #pragma omp parallel for schedule(static) if(count > 16384)
+        for (int i = 0; i < count; ++i) {
+            ox[i] = px[i] - (px[i] - ox[i]) * ratio;
+            oy[i] = py[i] - (py[i] - oy[i]) * ratio;
+            oz[i] = pz[i] - (pz[i] - oz[i]) * ratio;
+        }
     }
 
-    void Solver::step(double dt) {
-        applyForces(dt);
-        predictPositions(dt);
+    void Solver::setAdaptiveSubstepping(const AdaptiveSubstepping& settings) {
+        const bool starting = settings.enabled && !m_adaptive.enabled;
+        m_adaptive = settings;
+        m_adaptive.minSubsteps = std::max(1, m_adaptive.minSubsteps);
+        m_adaptive.maxSubsteps = std::max(m_adaptive.minSubsteps, m_adaptive.maxSubsteps);
+        if (starting || m_adaptiveSubsteps == 0)
+            m_adaptiveSubsteps = m_substeps;
+        m_adaptiveSubsteps = m_adaptive.clamp(m_adaptiveSubsteps);
+    }
+
+    void Solver::setProfilingEnabled(bool enabled) {
+        m_profilingEnabled = enabled && SolverStats::kCompiledIn;
+    }
+
+    void Solver::resetStats() {
+        m_stats = SolverStats();
+    }
 
-        for (auto& constraint : m_constraints) 
-            constraint->resetLambda();
+    void Solver::updateTopology() {
+        const int particleCount = static_cast<int>(m_particles.size());
+
+        if (m_adjacencyDirty || m_coloringDirty || m_aeroDirty)
+            m_islandsDirty = true;
+        if (m_distanceBatch.isColoringDirty())
+            m_distanceBatch.buildColoring(particleCount);
+        if (m_bendingBatch.isColoringDirty())
+            m_bendingBatch.buildColoring(particleCount);
+        if (m_coloringDirty)
+            buildConstraintColoring();
+        if (m_adjacencyDirty || m_adjacency.getParticleCount() != particleCount) {
+            m_adjacency.build(particleCount, m_adjacencyEdges);
+            m_adjacencyDirty = false;
+        }
+        if (m_aeroDirty || static_cast<int>(m_vertexFaceOffsets.size()) != particleCount + 1)
+            buildAeroTopology();
+        if (m_sleep.enabled && (m_islandsDirty || m_islands.getParticleCount() != particleCount))
+            buildIslands();
+        if (m_tetherSettings.enabled && m_tethersDirty) {
+            m_tetherBatch.build(m_particles, m_distanceBatch, m_tetherSettings.stretchLimit);
+            m_tethersDirty = false;
+        }
+    }
+
+    void Solver::buildIslands() {
+        const int particleCount = static_cast<int>(m_particles.size());
+        std::vector<std::pair<int, int>> edges(m_adjacencyEdges);
+        edges.reserve(edges.size() + 2 * m_aeroFaces.size());
+        for (const AeroFace& face : m_aeroFaces) {
+            edges.emplace_back(face.a, face.b);
+            edges.emplace_back(face.a, face.c);
+        }
+
+        // Custom constraints are always solved, so whatever they touch stays awake.
+        std::vector<int> restless;
+        if (!m_serialConstraints.empty()) {
+            restless.resize(particleCount);
+            std::iota(restless.begin(), restless.end(), 0);
+        } else {
+            for (int id : m_colorOrder)
+                m_constraints[id]->getParticleIds(restless);
+        }
+        for (const std::unique_ptr<Constraint>& constraint : m_constraints) {
+            std::vector<int> ids;
+            constraint->getParticleIds(ids);
+            for (size_t k = 1; k < ids.size(); ++k)
+                edges.emplace_back(ids[0], ids[k]);
+        }
+
+        m_islands.build(particleCount, edges, restless);
+        if (static_cast<int>(m_pendingSleepState.size()) == particleCount)
+            m_islands.setState(m_pendingSleepState.data());
+        m_pendingSleepState.clear();
+        m_islandsDirty = false;
+        refreshActiveParticles();
+    }
 
-        for (int i = 0; i < m_iterations; i++) {
-            for(auto& constraint : m_constraints)
-                constraint->solve(m_particles, dt);
+    void Solver::updateSleeping(Real dt) {
+        bool changed = false;
+        if (m_islands.hasSleepingIslands()) {
+            // A sleeping island wakes when an awake particle runs into it.
+            const Real* px = m_particles.posX();
+            const Real* py = m_particles.posY();
+            const Real* pz = m_particles.posZ();
+            const Real* ox = m_particles.oldX();
+            const Real* oy = m_particles.oldY();
+            const Real* oz = m_particles.oldZ();
+            const Real limit = m_sleep.velocityThreshold * dt;
+            for (int t = 0; t < m_contactBufferCount; ++t) {
+                for (const SelfContact& contact : m_contactBuffers[t]) {
+                    const int i = contact.i;
+                    if (m_islands.isAwake(contact.j))
+                        continue;
+                    const Real dx = px[i] - ox[i];
+                    const Real dy = py[i] - oy[i];
+                    const Real dz = pz[i] - oz[i];
+                    if (dx * dx + dy * dy + dz * dz > limit * limit)
+                        changed |= m_islands.wakeParticle(contact.j);
+                }
+            }
         }
+        changed |= m_islands.update(m_particles, dt, m_sleep);
+        if (changed)
+            refreshActiveParticles();
+    }
+
+    void Solver::refreshActiveParticles() {
+        const uint8_t* awake = awakeParticles();
+        m_distanceBatch.setActiveParticles(awake);
+        m_bendingBatch.setActiveParticles(awake);
+    }
+
+    void Solver::wakeAll() {
+        if (m_islands.wakeAll())
+            refreshActiveParticles();
+    }
 
-        for (auto& collider : m_colliders) {
-            collider->resolve(m_particles, dt);
+    void Solver::setTethers(const TetherSettings& settings) {
+        m_tetherSettings = settings;
+        m_tetherSettings.stretchLimit = std::max(Real(1), m_tetherSettings.stretchLimit);
+        m_tetherBatch.clear();
+        m_tethersDirty = true;
+    }
+
+    void Solver::setSleeping(const SleepSettings& settings) {
+        m_sleep = settings;
+        m_sleep.substeps = std::max(1, m_sleep.substeps);
+        if (!m_sleep.enabled) {
+            m_islands.clear();
+            m_pendingSleepState.clear();
+            refreshActiveParticles();
         }
+    }
 
-        solveSelfCollisions(m_thickness);
+    SleepStats Solver::getSleepStats() const {
+        if (!m_sleep.enabled || m_islands.getParticleCount() != static_cast<int>(m_particles.size())) {
+            SleepStats stats;
+            stats.activeParticles = static_cast<int>(m_particles.size());
+            return stats;
+        }
+        return m_islands.getStats();
     }
 
-    void Solver::applyForces(double dt) {
-        #pragma omp parallel for
-        for(auto& particle : m_particles) {
-            if(particle.getInverseMass() <= 0.0)
+    void Solver::step(Real dt) {
+        {
+            PhaseTimer timer(phaseTimes(), SolverPhase::Forces);
+            applyForces();
+        }
+        {
+            PhaseTimer timer(phaseTimes(), SolverPhase::Aerodynamics);
+            applyAerodynamics(dt);
+        }
+        {
+            PhaseTimer timer(phaseTimes(), SolverPhase::Predict);
+            predictPositions(dt);
+        }
+        {
+            PhaseTimer timer(phaseTimes(), SolverPhase::Constraints);
+            m_distanceBatch.resetLambda();
+            m_bendingBatch.resetLambda();
+            for (auto& constraint : m_constraints) 
+                constraint->resetLambda();
+
+            for (int i = 0; i < m_iterations; i++)
+                solveConstraints(dt);
+        }
+        if (m_adaptive.enabled) {
+            // Measured before collisions move particles, so it reflects convergence of the solve.
+            PhaseTimer timer(phaseTimes(), SolverPhase::SubstepControl);
+            m_substepResidual = m_distanceBatch.maxRelativeResidual(m_particles, dt);
+        }
+        {
+            PhaseTimer timer(phaseTimes(), SolverPhase::Colliders);
+            for (auto& collider : m_colliders) {
+                collider->resolve(m_particles, dt);
+            }
+        }
+        {
+            PhaseTimer timer(phaseTimes(), SolverPhase::SelfCollision);
+            solveSelfCollisions(m_thickness);
+        }
+        if (m_sleep.enabled) {
+            PhaseTimer timer(phaseTimes(), SolverPhase::Sleeping);
+            updateSleeping(dt);
+        }
+    }
+
+    void Solver::applyForces() {
+        Real* ax = m_particles.accX();
+        Real* ay = m_particles.accY();
+        Real* az = m_particles.accZ();
+        const Real* invMass = m_particles.invMass();
+        const uint8_t* awake = awakeParticles();
+        const Real gx = m_gravity.x(), gy = m_gravity.y(), gz = m_gravity.z();
+        const int count = static_cast<int>(m_particles.size());
+
+        #pragma omp parallel for simd
+        for (int i = 0; i < count; ++i) {
+            Real w = invMass[i];
+            if (w <= 0.0 || (awake && !awake[i]))
                 continue;
-            particle.addForce(m_gravity);
+            ax[i] += gx * w;
+            ay[i] += gy * w;
+            az[i] += gz * w;
         }
-        applyAerodynamics(dt);
     }
 
-    void Solver::predictPositions(double dt) {
-        #pragma omp parallel for
-        for (auto& particle : m_particles) {
-            particle.integrate(dt);
+    void Solver::predictPositions(Real dt) {
+        Real* px = m_particles.posX();
+        Real* py = m_particles.posY();
+        Real* pz = m_particles.posZ();
+        Real* ox = m_particles.oldX();
+        Real* oy = m_particles.oldY();
+        Real* oz = m_particles.oldZ();
+        Real* ax = m_particles.accX();
+        Real* ay = m_particles.accY();
+        Real* az = m_particles.accZ();
+        const Real* invMass = m_particles.invMass();
+        const uint8_t* awake = awakeParticles();
+        const Real dtSq = dt * dt;
+        const int count = static_cast<int>(m_particles.size());
+
+        // Sleeping particles already have old == position and no acceleration.
+        #pragma omp parallel for simd
+        for (int i = 0; i < count; ++i) {
+            if (awake && !awake[i])
+                continue;
+            Real x = px[i], y = py[i], z = pz[i];
+            if (invMass[i] > 0.0) {
+                px[i] = x + (x - ox[i]) * Real(0.988) + ax[i] * dtSq;
+                py[i] = y + (y - oy[i]) * Real(0.988) + ay[i] * dtSq;
+                pz[i] = z + (z - oz[i]) * Real(0.988) + az[i] * dtSq;
+            }
+            ox[i] = x;
+            oy[i] = y;
+            oz[i] = z;
+            ax[i] = 0.0;
+            ay[i] = 0.0;
+            az[i] = 0.0;
         }
     }
 
     int Solver::addParticle(const Particle& particle) {
-        m_particles.push_back(particle);
-        return static_cast<int>(m_particles.size() - 1);
+        m_tethersDirty = true;
+        return m_particles.add(particle);
     }
 
     void Solver::clear() {
         m_particles.clear();
+        m_distanceBatch.clear();
+        m_bendingBatch.clear();
         m_constraints.clear();
+        m_constraintColoring.clear();
+        m_colorOrder.clear();
+        m_serialConstraints.clear();
+        m_coloringDirty = false;
+        m_adjacencyEdges.clear();
+        m_adjacency.clear();
+        m_adjacencyDirty = false;
         m_colliders.clear();
+        m_aeroFaces.clear();
+        m_aeroForces.clear();
+        m_vertexFaceOffsets.clear();
+        m_vertexFaces.clear();
+        m_aeroDirty = false;
+        m_lastSubstepDt = 0;
+        m_lastMetrics = SubstepMetrics();
+        m_islands.clear();
+        m_islandsDirty = false;
+        m_pendingSleepState.clear();
+        m_contactBufferCount = 0;
+        m_tetherBatch.clear();
+        m_tethersDirty = true;
     }
 
-    const std::vector<Particle>& Solver::getParticles() const {
+    const ParticleBuffer& Solver::getParticles() const {
         return m_particles;
     }
 
-    void Solver::addDistanceConstraint(int idA, int idB, double compliance) {
-        Particle& pA = m_particles[idA];
-        Particle& pB = m_particles[idB];
-        double restLength = (pA.getPosition() - pB.getPosition()).norm();
-        m_constraints.push_back(std::make_unique<DistanceConstraint>(idA, idB, restLength, compliance));
-        m_adjacencies.insert(getAdjacencyKey(idA, idB));
+    void Solver::addDistanceConstraint(int idA, int idB, Real compliance) {
+        Real restLength = (m_particles.getPosition(idA) - m_particles.getPosition(idB)).norm();
+        m_distanceBatch.add(idA, idB, restLength, compliance);
+        m_adjacencyEdges.emplace_back(idA, idB);
+        m_adjacencyDirty = true;
+        m_tethersDirty = true;
+    }
+
+    void Solver::addBendingConstraint(int idA, int idB, int idC, int idD, Real restAngle, Real compliance) {
+        m_bendingBatch.add(idA, idB, idC, idD, restAngle, compliance);
+        m_adjacencyEdges.emplace_back(idA, idC);
+        m_adjacencyEdges.emplace_back(idB, idC);
+        m_adjacencyEdges.emplace_back(idA, idD);
+        m_adjacencyEdges.emplace_back(idB, idD);
+        m_adjacencyDirty = true;
+
+    }
+
+    int Solver::addParticles(const Real* positions, int count) {
+        m_tethersDirty = true;
+        return m_particles.append(positions, static_cast<std::size_t>(count), 1.0);
+    }
+
+    void Solver::addDistanceConstraints(const int* pairs, const Real* compliances, int count) {
+        appendDistanceConstraints(pairs, compliances, 1, count);
+    }
+
+    void Solver::addDistanceConstraints(const int* pairs, Real compliance, int count) {
+        appendDistanceConstraints(pairs, &compliance, 0, count);
+    }
+
+    void Solver::addBendingConstraints(const int* quads, const Real* restAngles, const Real* compliances, int count) {
+        appendBendingConstraints(quads, restAngles, compliances, 1, count);
     }
 
-    void Solver::addBendingConstraint(int idA, int idB, int idC, int idD, double restAngle, double compliance) {
-        m_constraints.push_back(std::make_unique<BendingConstraint>(idA, idB, idC, idD, restAngle, compliance));
-        m_adjacencies.insert(getAdjacencyKey(idA, idC));
-        m_adjacencies.insert(getAdjacencyKey(idB, idC));
-        m_adjacencies.insert(getAdjacencyKey(idA, idD));
-        m_adjacencies.insert(getAdjacencyKey(idB, idD));
+    void Solver::addBendingConstraints(const int* quads, const Real* restAngles, Real compliance, int count) {
+        appendBendingConstraints(quads, restAngles, &compliance, 0, count);
+    }
 
+    void Solver::appendDistanceConstraints(const int* pairs, const Real* compliance, int complianceStride, int count) {
+        if (count <= 0)
+            return;
+
+        m_distanceBatch.reserve(m_distanceBatch.size() + count);
+        m_adjacencyEdges.reserve(m_adjacencyEdges.size() + count);
+        for (int k = 0; k < count; ++k) {
+            const int idA = pairs[2 * k];
+            const int idB = pairs[2 * k + 1];
+            Real restLength = (m_particles.getPosition(idA) - m_particles.getPosition(idB)).norm();
+            m_distanceBatch.add(idA, idB, restLength, compliance[k * complianceStride]);
+            m_adjacencyEdges.emplace_back(idA, idB);
+        }
+        m_adjacencyDirty = true;
+        m_tethersDirty = true;
     }
 
-    void Solver::addPlaneCollider(const Eigen::Vector3d& origin, const Eigen::Vector3d& normal, double friction) {
+    void Solver::appendBendingConstraints(const int* quads, const Real* restAngles, const Real* compliance,
+                                          int complianceStride, int count) {
+        if (count <= 0)
+            return;
+
+        m_bendingBatch.reserve(m_bendingBatch.size() + count);
+        m_adjacencyEdges.reserve(m_adjacencyEdges.size() + 4 * static_cast<std::size_t>(count));
+        for (int k = 0; k < count; ++k) {
+            const int* q = quads + 4 * k;
+            m_bendingBatch.add(q[0], q[1], q[2], q[3], restAngles[k], compliance[k * complianceStride]);
+            m_adjacencyEdges.emplace_back(q[0], q[2]);
+            m_adjacencyEdges.emplace_back(q[1], q[2]);
+            m_adjacencyEdges.emplace_back(q[0], q[3]);
+            m_adjacencyEdges.emplace_back(q[1], q[3]);
+        }
+        m_adjacencyDirty = true;
+    }
+
+    void Solver::addConstraint(std::unique_ptr<Constraint> constraint) {
+        m_constraints.push_back(std::move(constraint));
+        m_coloringDirty = true;
+    }
+
+    void Solver::addPlaneCollider(const Vector3r& origin, const Vector3r& normal, Real friction) {
         m_colliders.push_back(std::make_unique<PlaneCollider>(origin, normal, friction));
+        wakeAll();
     }
 
-    void Solver::addSphereCollider(const Eigen::Vector3d& center, double radius, double friction) {
+    void Solver::addSphereCollider(const Vector3r& center, Real radius, Real friction) {
         m_colliders.push_back(std::make_unique<SphereCollider>(center, radius, friction));
+        wakeAll();
     }
 
-    void Solver::addMassToParticle(int id, double mass) {
-        Particle& pA = m_particles[id];
-        pA.addMass(mass);
+    void Solver::setPositions(const Real* positions) {
+        scatterInterleaved(positions, m_particles.posX(), m_particles.posY(), m_particles.posZ(),
+                           static_cast<int>(m_particles.size()));
+        wakeAll();
     }
 
-    void Solver::solveConstraints(double dt) {
-        for(auto& constraint : m_constraints)
-            constraint->solve(m_particles, dt);
+    void Solver::setOldPositions(const Real* positions) {
+        scatterInterleaved(positions, m_particles.oldX(), m_particles.oldY(), m_particles.oldZ(),
+                           static_cast<int>(m_particles.size()));
+        wakeAll();
     }
 
-    void Solver::applyAerodynamics(double dt) {
-        if (dt < 1e-6) return; // Seguridad
-
-        double gust = std::sin(m_time * 2.0) * 0.5 + 0.5;
-        Eigen::Vector3d currentWind = m_wind * gust;
+    void Solver::setInverseMasses(const Real* inverseMasses) {
+        std::copy_n(inverseMasses, m_particles.size(), m_particles.invMass());
+        m_tethersDirty = true;
+        wakeAll();
+    }
 
-        #pragma omp parallel for
-        for (int i = 0; i < (int)m_aeroFaces.size(); i++) {
-            auto& face = m_aeroFaces[i];
-            
-            Particle& pA = m_particles[face.a];
-            Particle& pB = m_particles[face.b];
-            Particle& pC = m_particles[face.c];
+    void Solver::addMassToParticle(int id, Real mass) {
+        m_particles.addMass(id, mass);
+    }
 
-            Eigen::Vector3d vA = (pA.getPosition() - pA.getOldPosition()) / dt;
-            Eigen::Vector3d vB = (pB.getPosition() - pB.getOldPosition()) / dt;
-            Eigen::Vector3d vC = (pC.getPosition() - pC.getOldPosition()) / dt;
+    void Solver::solveConstraints(Real dt) {
+        if (m_tetherSettings.enabled)
+            m_tetherBatch.solve(m_particles, awakeParticles());
+        m_distanceBatch.solve(m_particles, dt);
+        m_bendingBatch.solve(m_particles, dt);
 
-            Eigen::Vector3d vFace = (vA + vB + vC) / 3.0;
-            Eigen::Vector3d vRelative = vFace - currentWind;
+        const std::vector<int>& colorOffsets = m_constraintColoring.getColorOffsets();
 
-            Eigen::Vector3d edge1 = pB.getPosition() - pA.getPosition();
-            Eigen::Vector3d edge2 = pC.getPosition() - pA.getPosition();
-            Eigen::Vector3d n = edge1.cross(edge2);
+        for (int color = 0; color < m_constraintColoring.getColorCount(); ++color) {
+            const int begin = colorOffsets[color];
+            const int end = colorOffsets[color + 1];
 
-            double area = 0.5 * n.norm();
-            if (area < 1e-6) continue;
+            #pragma omp parallel for if(end - begin > 256)
+            for (int k = begin; k < end; ++k)
+                m_constraints[m_colorOrder[k]]->solve(m_particles, dt);
+        }
 
-            Eigen::Vector3d normal = n.normalized();
-            double pressure = vRelative.dot(normal);
-            Eigen::Vector3d force = -0.5 * m_airDensity * area * pressure * normal;
-            Eigen::Vector3d forcePerVtx = force / 3.0;
+        for (int id : m_serialConstraints)
+            m_constraints[id]->solve(m_particles, dt);
+    }
 
-            #pragma omp critical
-            {
-                pA.addForce(forcePerVtx);
-                pB.addForce(forcePerVtx);
-                pC.addForce(forcePerVtx);
+    void Solver::buildConstraintColoring() {
+        std::vector<int> colored;
+        std::vector<int> offsets = {0};
+        std::vector<int> particleIds;
+        m_serialConstraints.clear();
+
+        for (int i = 0; i < (int)m_constraints.size(); ++i) {
+            size_t before = particleIds.size();
+            m_constraints[i]->getParticleIds(particleIds);
+            if (particleIds.size() == before) {
+                m_serialConstraints.push_back(i);
+                continue;
             }
+            colored.push_back(i);
+            offsets.push_back(static_cast<int>(particleIds.size()));
         }
+
+        m_constraintColoring.build(offsets, particleIds, static_cast<int>(m_particles.size()));
+
+        // Coloring indexes the compacted list; map it back to m_constraints slots.
+        std::vector<int> order = m_constraintColoring.getOrder();
+        for (int& id : order)
+            id = colored[id];
+        m_colorOrder.swap(order);
+        m_coloringDirty = false;
     }
 
-    void Solver::solveSelfCollisions(double dt) {
-        double alphaHat = m_collisionCompliance / (dt * dt);
-        double thicknessSq = m_thickness * m_thickness;
+    void Solver::applyAerodynamics(Real dt) {
+        if (dt < 1e-6) return; // Seguridad
 
-        for (int i = 0; i < (int)m_particles.size(); ++i) {
-            Particle& pA = m_particles[i];
-            double wA = pA.getInverseMass();
-            if (wA == 0.0) continue;
+        Real gust = std::sin(m_time * 2.0) * 0.5 + 0.5;
+        Vector3r currentWind = m_wind * gust;
 
-            m_spatialHash.query(m_particles, pA.getPosition(), m_thickness, m_neighborsBuffer);
+        const int faceCount = static_cast<int>(m_aeroFaces.size());
+        const int particleCount = static_cast<int>(m_particles.size());
+        const uint8_t* awake = awakeParticles();
+        m_aeroForces.resize(3 * static_cast<size_t>(faceCount));
 
-            for (int j : m_neighborsBuffer) {
-                if (i >= j) continue; 
+        // Faces only write their own slot of the force buffer...
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < faceCount; i++) {
+            const AeroFace& face = m_aeroFaces[i];
+            Real* faceForce = &m_aeroForces[3 * static_cast<size_t>(i)];
+            faceForce[0] = faceForce[1] = faceForce[2] = 0.0;
+            if (awake && !awake[face.a]) continue;
 
-                if (m_adjacencies.count(getAdjacencyKey(i, j))) continue;
+            Vector3r pA = m_particles.getPosition(face.a);
+            Vector3r pB = m_particles.getPosition(face.b);
+            Vector3r pC = m_particles.getPosition(face.c);
 
-                Particle& pB = m_particles[j];
-                double wB = pB.getInverseMass();
-                double wSum = wA + wB;
+            Vector3r vA = (pA - m_particles.getOldPosition(face.a)) / dt;
+            Vector3r vB = (pB - m_particles.getOldPosition(face.b)) / dt;
+            Vector3r vC = (pC - m_particles.getOldPosition(face.c)) / dt;
 
-                if (wSum + alphaHat < 1e-12) continue;
+            Vector3r vFace = (vA + vB + vC) / 3.0;
+            Vector3r vRelative = vFace - currentWind;
 
-                Eigen::Vector3d dir = pA.getPosition() - pB.getPosition();
-                double distSq = dir.squaredNorm();
+            Vector3r edge1 = pB - pA;
+            Vector3r edge2 = pC - pA;
+            Vector3r n = edge1.cross(edge2);
 
-                if (distSq > 0.0 && distSq < thicknessSq) {
-                    double dist = std::sqrt(distSq);
-                    Eigen::Vector3d normal = dir / dist;
+            Real area = 0.5 * n.norm();
+            if (area < 1e-6) continue;
 
-                    double C = dist - m_thickness;
-                    
-                    double deltaLambda = -C / (wSum + alphaHat);
-                    Eigen::Vector3d corr = normal * deltaLambda;
+            Vector3r normal = n.normalized();
+            Real pressure = vRelative.dot(normal);
+            Vector3r force = -0.5 * m_airDensity * area * pressure * normal;
+            Vector3r forcePerVtx = force / 3.0;
 
-                    pA.setPosition(pA.getPosition() + corr * wA);
-                    pB.setPosition(pB.getPosition() - corr * wB);
-                }
+            faceForce[0] = forcePerVtx.x();
+            faceForce[1] = forcePerVtx.y();
+            faceForce[2] = forcePerVtx.z();
+        }
+
+        // ...and every particle gathers the faces around it, in face order.
+        Real* ax = m_particles.accX();
+        Real* ay = m_particles.accY();
+        Real* az = m_particles.accZ();
+        const Real* invMass = m_particles.invMass();
+
+        #pragma omp parallel for schedule(static)
+        for (int p = 0; p < particleCount; p++) {
+            const int begin = m_vertexFaceOffsets[p];
+            const int end = m_vertexFaceOffsets[p + 1];
+            if (begin == end || (awake && !awake[p])) continue;
+
+            Real fx = 0.0, fy = 0.0, fz = 0.0;
+            for (int k = begin; k < end; ++k) {
+                const Real* faceForce = &m_aeroForces[3 * static_cast<size_t>(m_vertexFaces[k])];
+                fx += faceForce[0];
+                fy += faceForce[1];
+                fz += faceForce[2];
             }
+
+            const Real w = invMass[p];
+            ax[p] += fx * w;
+            ay[p] += fy * w;
+            az[p] += fz * w;
         }
     }
 
-    uint64_t Solver::getAdjacencyKey(int idA, int idB) const{
-        uint64_t low = static_cast<uint32_t>(std::min(idA, idB));
-        uint64_t high = static_cast<uint32_t>(std::max(idA, idB));
+    void Solver::buildAeroTopology() {
+        const int particleCount = static_cast<int>(m_particles.size());
+        m_vertexFaceOffsets.assign(particleCount + 1, 0);
 
-        return (high << 32) | low;
+        for (const AeroFace& face : m_aeroFaces) {
+            m_vertexFaceOffsets[face.a + 1]++;
+            m_vertexFaceOffsets[face.b + 1]++;
+            m_vertexFaceOffsets[face.c + 1]++;
+        }
+        for (int p = 0; p < particleCount; ++p)
+            m_vertexFaceOffsets[p + 1] += m_vertexFaceOffsets[p];
+
+        std::vector<int> cursor(m_vertexFaceOffsets.begin(), m_vertexFaceOffsets.end() - 1);
+        m_vertexFaces.resize(m_vertexFaceOffsets[particleCount]);
+        for (int i = 0; i < static_cast<int>(m_aeroFaces.size()); ++i) {
+            const AeroFace& face = m_aeroFaces[i];
+            m_vertexFaces[cursor[face.a]++] = i;
+            m_vertexFaces[cursor[face.b]++] = i;
+            m_vertexFaces[cursor[face.c]++] = i;
+        }
+        m_aeroDirty = false;
+    }
+
+    void Solver::solveSelfCollisions(Real dt) {
+        const Real alphaHat = m_collisionCompliance / (dt * dt);
+        const Real thicknessSq = m_thickness * m_thickness;
+        const int count = static_cast<int>(m_particles.size());
+        const int threadCount = omp_get_max_threads();
+
+        if (static_cast<int>(m_contactBuffers.size()) < threadCount) {
+            m_contactBuffers.resize(threadCount);
+            m_threadNeighbors.resize(threadCount);
+            m_threadNeighborOffsets.resize(threadCount);
+        }
+        m_collisionDelta.assign(3 * static_cast<size_t>(count), 0.0);
+        m_collisionCount.assign(count, 0);
+
+        const Real* px = m_particles.posX();
+        const Real* py = m_particles.posY();
+        const Real* pz = m_particles.posZ();
+        const Real* invMass = m_particles.invMass();
+        const uint8_t* awake = awakeParticles();
+
+        // The cells were built at the start of the frame; refresh the cell-ordered
+        // positions so queries see this substep's positions.
+        m_spatialHash.refreshSortedPositions(m_particles);
+
+        const int chunkCount = (count + kCollisionChunk - 1) / kCollisionChunk;
+
+        #pragma omp parallel
+        {
+            const int thread = omp_get_thread_num();
+            std::vector<SelfContact>& contacts = m_contactBuffers[thread];
+            std::vector<int>& neighbors = m_threadNeighbors[thread];
+            std::vector<int>& neighborOffsets = m_threadNeighborOffsets[thread];
+            contacts.clear();
+            if (thread == 0)
+                m_contactBufferCount = omp_get_num_threads();
+
+            // Detection: every thread records the directed contacts (i, j) of the
+            // particles it owns. Positions are only read here.
+            #pragma omp for schedule(dynamic)
+            for (int chunk = 0; chunk < chunkCount; ++chunk) {
+                const int begin = chunk * kCollisionChunk;
+                const int end = std::min(begin + kCollisionChunk, count);
+                if (awake && std::find(awake + begin, awake + end, uint8_t(1)) == awake + end)
+                    continue;
+                m_spatialHash.queryRangeSorted(m_particles, begin, end, m_thickness, neighborOffsets, neighbors);
+
+                for (int i = begin; i < end; ++i) {
+                    const Real wA = invMass[i];
+                    if (wA == 0.0 || (awake && !awake[i])) continue;
+
+                    for (int k = neighborOffsets[i - begin]; k < neighborOffsets[i - begin + 1]; ++k) {
+                        const int j = neighbors[k];
+                        if (i == j) continue;
+                        if (m_adjacency.contains(i, j)) continue;
+                        if (wA + invMass[j] + alphaHat < 1e-12) continue;
+
+                        const Real dx = px[i] - px[j];
+                        const Real dy = py[i] - py[j];
+                        const Real dz = pz[i] - pz[j];
+                        const Real distSq = dx * dx + dy * dy + dz * dz;
+
+                        if (distSq > 0.0 && distSq < thicknessSq)
+                            contacts.push_back({i, j});
+                    }
+                }
+            }
+
+            // Resolution: a particle's contacts all live in the buffer of the thread
+            // that detected them, so each thread accumulates Jacobi deltas for its
+            // own particles without synchronization.
+            for (const SelfContact& contact : contacts) {
+                const int i = contact.i;
+                const int j = contact.j;
+                const Real wA = invMass[i];
+                const Real wSum = wA + invMass[j];
+
+                const Real dx = px[i] - px[j];
+                const Real dy = py[i] - py[j];
+                const Real dz = pz[i] - pz[j];
+                const Real dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+                const Real C = dist - m_thickness;
+                const Real deltaLambda = -C / (wSum + alphaHat);
+                const Real scale = deltaLambda * wA / dist;
+
+                m_collisionDelta[3 * i + 0] += dx * scale;
+                m_collisionDelta[3 * i + 1] += dy * scale;
+                m_collisionDelta[3 * i + 2] += dz * scale;
+                m_collisionCount[i]++;
+            }
+
+            #pragma omp barrier
+
+            Real* wx = m_particles.posX();
+            Real* wy = m_particles.posY();
+            Real* wz = m_particles.posZ();
+
+            #pragma omp for schedule(static)
+            for (int i = 0; i < count; ++i) {
+                const int contactsOnParticle = m_collisionCount[i];
+                if (contactsOnParticle == 0) continue;
+                const Real inv = Real(1) / contactsOnParticle;
+                wx[i] += m_collisionDelta[3 * i + 0] * inv;
+                wy[i] += m_collisionDelta[3 * i + 1] * inv;
+                wz[i] += m_collisionDelta[3 * i + 2] * inv;
+            }
+        }
     }
 
     void Solver::setIterations(int count) {
@@ -204,17 +826,23 @@ namespace ClothSDK {
 
     void Solver::setSubsteps(int count) {
         m_substeps = count;
+        m_adaptiveSubsteps = m_adaptive.clamp(count);
     }
 
-    void Solver::setGravity(const Eigen::Vector3d& gravity) {
+    void Solver::setGravity(const Vector3r& gravity) {
         m_gravity = gravity;
+        wakeAll();
     }
 
-    void Solver::setParticleInverseMass(int id, double invMass) {
-        m_particles[id].setInverseMass(invMass);
+    void Solver::setParticleInverseMass(int id, Real invMass) {
+        m_particles.setInverseMass(id, invMass);
+        m_tethersDirty = true;
+        if (id < m_islands.getParticleCount() && m_islands.wakeParticle(id))
+            refreshActiveParticles();
     }
 
     void Solver::addAeroFace(int idA, int idB, int idC) {
         m_aeroFaces.push_back({idA, idB, idC});
+        m_aeroDirty = true;
     }
 }
\ No newline at end of file
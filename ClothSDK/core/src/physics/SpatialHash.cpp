@@ -1,54 +1,282 @@
 #include "physics/SpatialHash.hpp"
-#include "physics/Particle.hpp"
+#include "physics/ParticleBuffer.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 
 namespace ClothSDK {
 
-SpatialHash::SpatialHash(int tableSize, double cellSize)
-: m_tableSize(tableSize), m_cellSize(cellSize) {}
-
-void SpatialHash::build(const std::vector<Particle>& particles) {
-    m_cellStart.assign(m_tableSize + 1, 0); 
-    m_particleHashes.resize(particles.size());
-    m_particleIndices.resize(particles.size());
-
-    for (size_t i = 0; i < particles.size(); ++i) {
-        const Eigen::Vector3d& pos = particles[i].getPosition();
-        
-        int gx = static_cast<int>(std::floor(pos.x() / m_cellSize));
-        int gy = static_cast<int>(std::floor(pos.y() / m_cellSize));
-        int gz = static_cast<int>(std::floor(pos.z() / m_cellSize));
-        
-        int h = hashCoords(gx, gy, gz);
-        
-        m_particleHashes[i] = h;
-        
-        m_cellStart[h]++;
+SpatialHash::SpatialHash(int tableSize, Real cellSize)
+: m_tableSize(tableSize), m_cellSize(cellSize) {
+    setTableSize(tableSize);
+}
+
+SpatialHash::SpatialHash(Real cellSize)
+: m_tableSize(kMinAdaptiveTableSize), m_cellSize(cellSize), m_adaptiveTableSize(true) {
+    setTableSize(kMinAdaptiveTableSize);
+}
+
+int SpatialHash::adaptiveTableSize(int particleCount) {
+    int size = kMinAdaptiveTableSize;
+    while (size < 2 * particleCount && size < (1 << 30))
+        size <<= 1;
+    return size;
+}
+
+void SpatialHash::setTableSize(int tableSize) {
+    m_tableSize = std::max(1, tableSize);
+    const bool powerOfTwo = (m_tableSize & (m_tableSize - 1)) == 0;
+    m_tableMask = powerOfTwo ? static_cast<uint32_t>(m_tableSize - 1) : 0u;
+}
+
+void SpatialHash::build(const ParticleBuffer& particles) {
+    const auto buildStart = std::chrono::steady_clock::now();
+    const int count = static_cast<int>(particles.size());
+    if (m_adaptiveTableSize && adaptiveTableSize(count) != m_tableSize)
+        setTableSize(adaptiveTableSize(count));
+
+    m_cellStart.resize(m_tableSize + 1);
+    m_particleIndices.resize(count);
+
+    const bool storeSorted = m_storeSortedPositions;
+    if (storeSorted) {
+        m_sortedX.resize(count);
+        m_sortedY.resize(count);
+        m_sortedZ.resize(count);
+    }
+
+    const Real* px = particles.posX();
+    const Real* py = particles.posY();
+    const Real* pz = particles.posZ();
+
+    int keyBits = 1;
+    while (keyBits < 31 && (m_tableSize - 1) >> keyBits != 0)
+        ++keyBits;
+    const int passes = (keyBits + kRadixBits - 1) / kRadixBits;
+
+    m_sortedHashes.resize(count);
+    m_scratchHashes.resize(count);
+    m_scratchIndices.resize(count);
+
+    // Only spread the work when each thread gets a meaningful slice of particles.
+    const int requestedThreads = std::max(1, std::min(omp_get_max_threads(), count / kMinParticlesPerThread));
+
+    #pragma omp parallel num_threads(requestedThreads)
+    {
+        const int threads = omp_get_num_threads();
+        const int thread = omp_get_thread_num();
+
+        #pragma omp single
+        m_threadHistograms.assign(static_cast<size_t>(threads) * kRadixBuckets, 0);
+
+        // 1. Hash every particle; the (hash, index) pairs start in index order.
+        const int begin = static_cast<int>(static_cast<long long>(count) * thread / threads);
+        const int end = static_cast<int>(static_cast<long long>(count) * (thread + 1) / threads);
+        int* keys = m_sortedHashes.data();
+        int* values = m_particleIndices.data();
+        int* keysOut = m_scratchHashes.data();
+        int* valuesOut = m_scratchIndices.data();
+
+        for (int i = begin; i < end; ++i) {
+            int gx = static_cast<int>(std::floor(px[i] / m_cellSize));
+            int gy = static_cast<int>(std::floor(py[i] / m_cellSize));
+            int gz = static_cast<int>(std::floor(pz[i] / m_cellSize));
+            keys[i] = hashCoords(gx, gy, gz);
+            values[i] = i;
+        }
+
+        // 2. Stable LSD radix sort of the pairs by hash. Histograms cover one digit,
+        //    not the table, so scratch memory does not grow with threads x particles.
+        //    Stability keeps every cell in ascending particle index order.
+        int* histogram = m_threadHistograms.data() + static_cast<size_t>(thread) * kRadixBuckets;
+        for (int pass = 0; pass < passes; ++pass) {
+            const int shift = pass * kRadixBits;
+            std::fill(histogram, histogram + kRadixBuckets, 0);
+
+            #pragma omp barrier
+
+            for (int m = begin; m < end; ++m)
+                histogram[(keys[m] >> shift) & (kRadixBuckets - 1)]++;
+
+            #pragma omp barrier
+
+            // Digit-major, thread-minor offsets preserve the order of the slices.
+            #pragma omp single
+            {
+                int offset = 0;
+                for (int digit = 0; digit < kRadixBuckets; ++digit) {
+                    for (int t = 0; t < threads; ++t) {
+                        int& slot = m_threadHistograms[static_cast<size_t>(t) * kRadixBuckets + digit];
+                        const int digitCount = slot;
+                        slot = offset;
+                        offset += digitCount;
+                    }
+                }
+            }
+
+            for (int m = begin; m < end; ++m) {
+                const int slot = histogram[(keys[m] >> shift) & (kRadixBuckets - 1)]++;
+                keysOut[slot] = keys[m];
+                valuesOut[slot] = values[m];
+            }
+            std::swap(keys, keysOut);
+            std::swap(values, valuesOut);
+
+            #pragma omp barrier
+        }
+
+        // 3. A cell starts where the sorted hash changes; every table entry is
+        //    written by exactly one particle slot, or by the tail loop.
+        #pragma omp for schedule(static)
+        for (int m = 0; m < count; ++m) {
+            const int previous = m > 0 ? keys[m - 1] : -1;
+            for (int h = previous + 1; h <= keys[m]; ++h)
+                m_cellStart[h] = m;
+        }
+
+        const int lastHash = count > 0 ? keys[count - 1] : -1;
+        #pragma omp for schedule(static)
+        for (int h = lastHash + 1; h <= m_tableSize; ++h)
+            m_cellStart[h] = count;
+
+        // 4. Gather the positions in cell order.
+        if (storeSorted) {
+            const int* indices = values;
+            #pragma omp for schedule(static)
+            for (int m = 0; m < count; ++m) {
+                const int i = indices[m];
+                m_sortedX[m] = px[i];
+                m_sortedY[m] = py[i];
+                m_sortedZ[m] = pz[i];
+            }
+        }
+    }
+
+    // An odd number of passes leaves the result in the scratch buffers.
+    if (passes % 2 != 0) {
+        m_sortedHashes.swap(m_scratchHashes);
+        m_particleIndices.swap(m_scratchIndices);
     }
 
-    int sum = 0;
-    for (int i = 0; i < m_tableSize; ++i) {
-        int count = m_cellStart[i];
-        m_cellStart[i] = sum;
-        sum += count;
+    m_sortedPositionsValid = storeSorted;
+
+    m_buildStats.tableSize = m_tableSize;
+    m_buildStats.particleCount = count;
+    if (m_collectStats)
+        updateBucketStats();
+    m_buildStats.buildTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+}
+
+void SpatialHash::updateBucketStats() {
+    int occupied = 0;
+    int maxLoad = 0;
+
+    #pragma omp parallel for reduction(+:occupied) reduction(max:maxLoad) if(m_tableSize > 65536)
+    for (int h = 0; h < m_tableSize; ++h) {
+        int load = m_cellStart[h + 1] - m_cellStart[h];
+        if (load > 0) {
+            occupied++;
+            maxLoad = std::max(maxLoad, load);
+        }
     }
-    m_cellStart[m_tableSize] = sum;
 
-    std::vector<int> cellOffset = m_cellStart;
+    m_buildStats.occupiedBuckets = occupied;
+    m_buildStats.maxBucketLoad = maxLoad;
+    m_buildStats.meanBucketLoad = occupied > 0 ? static_cast<double>(m_buildStats.particleCount) / occupied : 0.0;
+}
+
+SpatialHashStats SpatialHash::getStats() const {
+    SpatialHashStats stats = m_buildStats;
+    stats.queries = m_queryCount.load(std::memory_order_relaxed);
+    stats.candidates = m_candidateCount.load(std::memory_order_relaxed);
+    stats.hashCollisions = m_collisionCount.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SpatialHash::resetQueryStats() {
+    m_queryCount.store(0, std::memory_order_relaxed);
+    m_candidateCount.store(0, std::memory_order_relaxed);
+    m_collisionCount.store(0, std::memory_order_relaxed);
+}
+
+void SpatialHash::setStoreSortedPositions(bool enabled) {
+    m_storeSortedPositions = enabled;
+    if (!enabled) {
+        m_sortedPositionsValid = false;
+        m_sortedX.clear();
+        m_sortedY.clear();
+        m_sortedZ.clear();
+    }
+}
+
+void SpatialHash::refreshSortedPositions(const ParticleBuffer& particles) {
+    if (!m_storeSortedPositions)
+        return;
+
+    const int count = static_cast<int>(m_particleIndices.size());
+    if (static_cast<int>(particles.size()) != count) {
+        m_sortedPositionsValid = false;
+        return;
+    }
+
+    m_sortedX.resize(count);
+    m_sortedY.resize(count);
+    m_sortedZ.resize(count);
+
+    const Real* px = particles.posX();
+    const Real* py = particles.posY();
+    const Real* pz = particles.posZ();
 
-    for (size_t i = 0; i < particles.size(); ++i) {
-        int hash = m_particleHashes[i];
-        int index = cellOffset[hash]++;
-        m_particleIndices[index] = i;
+    #pragma omp parallel for schedule(static) if(count > kMinParticlesPerThread)
+    for (int m = 0; m < count; ++m) {
+        int pIndex = m_particleIndices[m];
+        m_sortedX[m] = px[pIndex];
+        m_sortedY[m] = py[pIndex];
+        m_sortedZ[m] = pz[pIndex];
     }
+
+    m_sortedPositionsValid = true;
+}
+
+void SpatialHash::query(const ParticleBuffer& particles, const Vector3r& pos, Real radius, std::vector<int>& outNeighbors) const {
+    outNeighbors.clear();
+    appendNeighbors(particles.posX(), particles.posY(), particles.posZ(), false, pos, radius, outNeighbors);
+}
+
+void SpatialHash::queryRange(const ParticleBuffer& particles, int begin, int end, Real radius,
+                             std::vector<int>& outOffsets, std::vector<int>& outNeighbors) const {
+    queryRange(particles, false, begin, end, radius, outOffsets, outNeighbors);
+}
+
+void SpatialHash::queryRangeSorted(const ParticleBuffer& particles, int begin, int end, Real radius,
+                                   std::vector<int>& outOffsets, std::vector<int>& outNeighbors) const {
+    const bool sorted = m_sortedPositionsValid && particles.size() == m_particleIndices.size();
+    queryRange(particles, sorted, begin, end, radius, outOffsets, outNeighbors);
 }
 
-void SpatialHash::query(const std::vector<Particle>& particles, const Eigen::Vector3d& pos, double radius, std::vector<int>& outNeighbors) const {
+void SpatialHash::queryRange(const ParticleBuffer& particles, bool sorted, int begin, int end, Real radius,
+                             std::vector<int>& outOffsets, std::vector<int>& outNeighbors) const {
     outNeighbors.clear();
-    Eigen::Vector3d sphereRadius(radius, radius, radius);
-    Eigen::Vector3d pMin = pos - sphereRadius;
-    Eigen::Vector3d pMax = pos + sphereRadius;
+    outOffsets.clear();
+    outOffsets.push_back(0);
+
+    const Real* px = particles.posX();
+    const Real* py = particles.posY();
+    const Real* pz = particles.posZ();
+
+    for (int i = begin; i < end; ++i) {
+        appendNeighbors(px, py, pz, sorted, Vector3r(px[i], py[i], pz[i]), radius, outNeighbors);
+        outOffsets.push_back(static_cast<int>(outNeighbors.size()));
+    }
+}
+
+void SpatialHash::appendNeighbors(const Real* px, const Real* py, const Real* pz, bool sorted, const Vector3r& pos,
+                                  Real radius, std::vector<int>& outNeighbors) const {
+    Vector3r sphereRadius(radius, radius, radius);
+    Vector3r pMin = pos - sphereRadius;
+    Vector3r pMax = pos + sphereRadius;
 
     int mingx, mingy, mingz;
     int maxgx, maxgy, maxgz;
@@ -56,21 +284,50 @@ void SpatialHash::query(const std::vector<Particle>& particles, const Eigen::Vec
     posToGrid(pMin, mingx, mingy, mingz);
     posToGrid(pMax, maxgx, maxgy, maxgz);
 
+    // With the cell-ordered copy the candidates of a cell are read contiguously.
+    const Real* cx = sorted ? m_sortedX.data() : px;
+    const Real* cy = sorted ? m_sortedY.data() : py;
+    const Real* cz = sorted ? m_sortedZ.data() : pz;
+
+    const bool collectStats = m_collectStats;
+    long long candidates = 0;
+    long long collisions = 0;
+
     for (int x = mingx; x <= maxgx; ++x){
         for (int y = mingy; y <= maxgy; ++y) {
             for (int z = mingz; z <= maxgz; ++z) {
                 int hash = hashCoords(x, y, z);
                 int start = m_cellStart[hash];
                 int end = m_cellStart[hash + 1];
+                if (collectStats) {
+                    candidates += end - start;
+                    for (int m = start; m < end; ++m) {
+                        int slot = sorted ? m : m_particleIndices[m];
+                        int cgx, cgy, cgz;
+                        posToGrid(Vector3r(cx[slot], cy[slot], cz[slot]), cgx, cgy, cgz);
+                        if (cgx != x || cgy != y || cgz != z)
+                            collisions++;
+                    }
+                }
                 for (int m = start; m < end; ++m) {
                     int pIndex = m_particleIndices[m];
-                    double distance = (particles[pIndex].getPosition() - pos).squaredNorm();
+                    int slot = sorted ? m : pIndex;
+                    Real dx = cx[slot] - pos.x();
+                    Real dy = cy[slot] - pos.y();
+                    Real dz = cz[slot] - pos.z();
+                    Real distance = dx * dx + dy * dy + dz * dz;
                     if (distance < radius * radius)
                         outNeighbors.push_back(pIndex);
                 }
             }
         }
     }
+
+    if (collectStats) {
+        m_queryCount.fetch_add(1, std::memory_order_relaxed);
+        m_candidateCount.fetch_add(candidates, std::memory_order_relaxed);
+        m_collisionCount.fetch_add(collisions, std::memory_order_relaxed);
+    }
 }
 
-}
\ No newline at end of file
+}
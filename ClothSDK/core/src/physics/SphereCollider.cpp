@@ -1,40 +1,62 @@
 #include "physics/SphereCollider.hpp"
-#include "physics/Particle.hpp"
+#include "physics/ParticleBuffer.hpp"
+#include <cmath>
 
 namespace ClothSDK {
 
-SphereCollider::SphereCollider(const Eigen::Vector3d& center, double radius, double friction)
+SphereCollider::SphereCollider(const Vector3r& center, Real radius, Real friction)
     : m_center(center), m_radius(radius) 
 {
     m_friction = friction;
 }
 
-void SphereCollider::resolve(std::vector<Particle>& particles, double dt) {
-    double thickness = 0.01;
-    for (auto& particle : particles) {
-        Eigen::Vector3d vec = particle.getPosition() - m_center;
-        double distance = vec.norm();
+void SphereCollider::resolve(ParticleBuffer& particles, Real dt) {
+    Real thickness = 0.01;
+    Real* px = particles.posX();
+    Real* py = particles.posY();
+    Real* pz = particles.posZ();
+    Real* ox = particles.oldX();
+    Real* oy = particles.oldY();
+    Real* oz = particles.oldZ();
+    const Real shell = m_radius + thickness;
+    const Real keep = 1.0 - m_friction;
+    const int count = static_cast<int>(particles.size());
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        Real vx = px[i] - m_center.x();
+        Real vy = py[i] - m_center.y();
+        Real vz = pz[i] - m_center.z();
+        Real distance = std::sqrt(vx * vx + vy * vy + vz * vz);
 
         if (distance < 1e-6) {
-            vec = Eigen::Vector3d::UnitY() * (m_radius + thickness);
-            distance = vec.norm();
+            vx = 0.0;
+            vy = shell;
+            vz = 0.0;
+            distance = shell;
         }
 
-
-        if (distance < (m_radius + thickness)) {
-            Eigen::Vector3d normal = vec.normalized();
-            Eigen::Vector3d newPosition = m_center + normal * (m_radius + thickness);
-            particle.setPosition(newPosition);
-
-            Eigen::Vector3d displacement = particle.getPosition() - particle.getOldPosition();
-            Eigen::Vector3d normalDisp = normal * displacement.dot(normal);
-            Eigen::Vector3d tangentialDisp = displacement - normalDisp;
-            Eigen::Vector3d newDisplacement = normalDisp + tangentialDisp * (1.0 - m_friction);
-
-            particle.setOldPosition(particle.getPosition() - newDisplacement);
-
+        if (distance < shell) {
+            Real nx = vx / distance;
+            Real ny = vy / distance;
+            Real nz = vz / distance;
+            px[i] = m_center.x() + nx * shell;
+            py[i] = m_center.y() + ny * shell;
+            pz[i] = m_center.z() + nz * shell;
+
+            Real dx = px[i] - ox[i];
+            Real dy = py[i] - oy[i];
+            Real dz = pz[i] - oz[i];
+            Real normalPart = dx * nx + dy * ny + dz * nz;
+            Real tx = dx - nx * normalPart;
+            Real ty = dy - ny * normalPart;
+            Real tz = dz - nz * normalPart;
+
+            ox[i] = px[i] - (nx * normalPart + tx * keep);
+            oy[i] = py[i] - (ny * normalPart + ty * keep);
+            oz[i] = pz[i] - (nz * normalPart + tz * keep);
         }
     }
 }
 
-}
\ No newline at end of file
+}
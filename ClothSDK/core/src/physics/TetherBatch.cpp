@@ -0,0 +1,109 @@
+#include "physics/TetherBatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace ClothSDK {
+
+void TetherBatch::build(const ParticleBuffer& particles, const DistanceBatch& distances, Real stretchLimit) {
+    clear();
+    const int particleCount = static_cast<int>(particles.size());
+    const int edgeCount = distances.size();
+    const int* idA = distances.idA();
+    const int* idB = distances.idB();
+    const Real* restLength = distances.restLength();
+    const Real* invMass = particles.invMass();
+
+    // Both directions of every distance constraint, grouped by particle.
+    std::vector<int> offsets(particleCount + 1, 0);
+    for (int k = 0; k < edgeCount; ++k) {
+        offsets[idA[k] + 1]++;
+        offsets[idB[k] + 1]++;
+    }
+    for (int p = 0; p < particleCount; ++p)
+        offsets[p + 1] += offsets[p];
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    std::vector<int> neighbor(offsets[particleCount]);
+    std::vector<Real> weight(offsets[particleCount]);
+    for (int k = 0; k < edgeCount; ++k) {
+        neighbor[cursor[idA[k]]] = idB[k];
+        weight[cursor[idA[k]]++] = restLength[k];
+        neighbor[cursor[idB[k]]] = idA[k];
+        weight[cursor[idB[k]]++] = restLength[k];
+    }
+
+    using Entry = std::pair<Real, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    std::vector<Real> distance(particleCount, std::numeric_limits<Real>::infinity());
+    std::vector<int> anchor(particleCount, -1);
+    for (int p = 0; p < particleCount; ++p) {
+        if (invMass[p] == Real(0)) {
+            distance[p] = 0;
+            anchor[p] = p;
+            queue.push({Real(0), p});
+        }
+    }
+
+    while (!queue.empty()) {
+        const auto [d, p] = queue.top();
+        queue.pop();
+        if (d > distance[p])
+            continue;
+        for (int k = offsets[p]; k < offsets[p + 1]; ++k) {
+            const int q = neighbor[k];
+            const Real candidate = d + weight[k];
+            if (candidate < distance[q]) {
+                distance[q] = candidate;
+                anchor[q] = anchor[p];
+                queue.push({candidate, q});
+            }
+        }
+    }
+
+    const Real scale = std::max(Real(1), stretchLimit);
+    for (int p = 0; p < particleCount; ++p) {
+        if (anchor[p] < 0 || invMass[p] == Real(0))
+            continue;
+        m_particle.push_back(p);
+        m_anchor.push_back(anchor[p]);
+        m_maxLength.push_back(distance[p] * scale);
+    }
+}
+
+void TetherBatch::clear() {
+    m_particle.clear();
+    m_anchor.clear();
+    m_maxLength.clear();
+}
+
+void TetherBatch::solve(ParticleBuffer& particles, const uint8_t* awake) const {
+    Real* px = particles.posX();
+    Real* py = particles.posY();
+    Real* pz = particles.posZ();
+    const int count = size();
+
+    #pragma omp parallel for schedule(static) if(count > 4096)
+    for (int k = 0; k < count; ++k) {
+        const int p = m_particle[k];
+        if (awake && !awake[p])
+            continue;
+        const int a = m_anchor[k];
+        const Real dx = px[p] - px[a];
+        const Real dy = py[p] - py[a];
+        const Real dz = pz[p] - pz[a];
+        const Real lengthSq = dx * dx + dy * dy + dz * dz;
+        const Real maxLength = m_maxLength[k];
+        if (lengthSq <= maxLength * maxLength)
+            continue;
+
+        const Real scale = maxLength / std::sqrt(lengthSq);
+        px[p] = px[a] + dx * scale;
+        py[p] = py[a] + dy * scale;
+        pz[p] = pz[a] + dz * scale;
+    }
+}
+
+}
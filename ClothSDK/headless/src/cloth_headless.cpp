@@ -0,0 +1,272 @@
+#include "engine/ClothMesh.hpp"
+#include "io/AsyncExporter.hpp"
+#include "io/ConfigLoader.hpp"
+#include "io/OBJLoader.hpp"
+#include "physics/Solver.hpp"
+#include "utils/Logger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+using namespace ClothSDK;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string configPath;
+    std::string meshPath;
+    std::string cachePath;
+    FrameEncoding encoding = FrameEncoding::Float32;
+    int frames = 100;
+    double dt = 1.0 / 60.0;
+    int threads = 0;                ///< 0 keeps the OpenMP default.
+    int queueDepth = 3;
+    int minSubsteps = 0;            ///< 0 keeps fixed substeps.
+    int maxSubsteps = 0;
+    double sleepSpeed = 0.0;        ///< 0 keeps sleeping disabled.
+    double tetherStretch = 0.0;     ///< 0 keeps tethers disabled.
+    double pinAbove = std::numeric_limits<double>::infinity();
+};
+
+void printUsage() {
+    std::printf(
+        "Usage: cloth_headless --mesh <file.obj> [options]\n"
+        "\n"
+        "  --mesh <path>         OBJ to simulate (required)\n"
+        "  --config <path>       ConfigLoader JSON applied before the mesh is built\n"
+        "  --frames <n>          Number of frames to simulate (default 100)\n"
+        "  --dt <seconds>        Fixed frame time step (default 1/60)\n"
+        "  --threads <n>         OpenMP thread count (default: OpenMP's choice)\n"
+        "  --cache <path>        Write every frame to a frame cache\n"
+        "  --encoding <name>     float32, float16 or delta16 (default float32)\n"
+        "  --queue-depth <n>     Frames buffered ahead of the cache writer (default 3)\n"
+        "  --pin-above <y>       Pin the vertices at or above height y\n"
+        "  --adaptive <min:max>  Adaptive substepping between min and max substeps per frame\n"
+        "  --sleep <speed>       Put islands resting below this speed to sleep\n"
+        "  --tethers <stretch>   Tether vertices to the pins, allowing this stretch (1 = none)\n");
+}
+
+bool parseEncoding(const std::string& name, FrameEncoding& encoding) {
+    if (name == "float32") encoding = FrameEncoding::Float32;
+    else if (name == "float16") encoding = FrameEncoding::Float16;
+    else if (name == "delta16") encoding = FrameEncoding::Delta16;
+    else return false;
+    return true;
+}
+
+bool parseRange(const std::string& text, int& low, int& high) {
+    char* end = nullptr;
+    low = static_cast<int>(std::strtol(text.c_str(), &end, 10));
+    if (*end != ':')
+        return false;
+    high = static_cast<int>(std::strtol(end + 1, &end, 10));
+    return *end == '\0' && low >= 1 && high >= low;
+}
+
+bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h")
+            return false;
+        if (i + 1 >= argc) {
+            Logger::error("Missing value for " + arg);
+            return false;
+        }
+
+        const std::string value = argv[++i];
+        char* end = nullptr;
+        if (arg == "--mesh") options.meshPath = value;
+        else if (arg == "--config") options.configPath = value;
+        else if (arg == "--cache") options.cachePath = value;
+        else if (arg == "--frames") options.frames = static_cast<int>(std::strtol(value.c_str(), &end, 10));
+        else if (arg == "--threads") options.threads = static_cast<int>(std::strtol(value.c_str(), &end, 10));
+        else if (arg == "--queue-depth") options.queueDepth = static_cast<int>(std::strtol(value.c_str(), &end, 10));
+        else if (arg == "--dt") options.dt = std::strtod(value.c_str(), &end);
+        else if (arg == "--pin-above") options.pinAbove = std::strtod(value.c_str(), &end);
+        else if (arg == "--sleep") options.sleepSpeed = std::strtod(value.c_str(), &end);
+        else if (arg == "--tethers") options.tetherStretch = std::strtod(value.c_str(), &end);
+        else if (arg == "--adaptive") {
+            if (!parseRange(value, options.minSubsteps, options.maxSubsteps)) {
+                Logger::error("Invalid substep range " + value + ", expected <min>:<max>");
+                return false;
+            }
+        } else if (arg == "--encoding") {
+            if (!parseEncoding(value, options.encoding)) {
+                Logger::error("Unknown encoding " + value);
+                return false;
+            }
+        } else {
+            Logger::error("Unknown option " + arg);
+            return false;
+        }
+
+        if (end && *end != '\0') {
+            Logger::error("Invalid value for " + arg + ": " + value);
+            return false;
+        }
+    }
+
+    if (options.meshPath.empty()) {
+        Logger::error("--mesh is required");
+        return false;
+    }
+    if (options.dt <= 0.0 || options.queueDepth < 1) {
+        Logger::error("--dt and --queue-depth must be positive");
+        return false;
+    }
+    // Zero is meaningful for these: no frames, the OpenMP default, sleeping or tethers disabled.
+    if (options.frames < 0 || options.threads < 0 || options.sleepSpeed < 0.0 || options.tetherStretch < 0.0) {
+        Logger::error("--frames, --threads, --sleep and --tethers must not be negative");
+        return false;
+    }
+    return true;
+}
+
+double secondsSince(Clock::time_point begin) {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+void printPhase(const char* name, double seconds, int frames) {
+    if (frames > 0)
+        std::printf("  %-10s %10.3f s %10.3f ms/frame\n", name, seconds, 1e3 * seconds / frames);
+    else
+        std::printf("  %-10s %10.3f s\n", name, seconds);
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    if (options.threads > 0)
+        omp_set_num_threads(options.threads);
+
+    Solver solver;
+    ClothMesh mesh;
+    solver.setProfilingEnabled(true);
+
+    const auto loadBegin = Clock::now();
+    if (!options.configPath.empty() && !ConfigLoader::load(options.configPath, solver, mesh)) {
+        Logger::error("Failed to load config: " + options.configPath);
+        return 1;
+    }
+    std::vector<Vector3r> positions;
+    std::vector<int> indices;
+    if (!OBJLoader::load(options.meshPath, positions, indices) || positions.empty()) {
+        Logger::error("Failed to load mesh: " + options.meshPath);
+        return 1;
+    }
+    const double loadSeconds = secondsSince(loadBegin);
+
+    const auto buildBegin = Clock::now();
+    mesh.buildFromMesh(positions, indices, solver);
+    int pinned = 0;
+    for (size_t v = 0; v < positions.size(); ++v) {
+        if (positions[v].y() >= options.pinAbove) {
+            solver.setParticleInverseMass(mesh.getParticleIndices()[v], 0.0);
+            ++pinned;
+        }
+    }
+    const double buildSeconds = secondsSince(buildBegin);
+
+    if (options.maxSubsteps > 0) {
+        AdaptiveSubstepping adaptive = solver.getAdaptiveSubstepping();
+        adaptive.enabled = true;
+        adaptive.minSubsteps = options.minSubsteps;
+        adaptive.maxSubsteps = options.maxSubsteps;
+        solver.setAdaptiveSubstepping(adaptive);
+    }
+    if (options.sleepSpeed > 0.0) {
+        SleepSettings sleeping = solver.getSleeping();
+        sleeping.enabled = true;
+        sleeping.velocityThreshold = static_cast<Real>(options.sleepSpeed);
+        solver.setSleeping(sleeping);
+    }
+    if (options.tetherStretch > 0.0) {
+        TetherSettings tethers;
+        tethers.enabled = true;
+        tethers.stretchLimit = static_cast<Real>(options.tetherStretch);
+        solver.setTethers(tethers);
+    }
+
+    AsyncExporter exporter;
+    if (!options.cachePath.empty() &&
+        !exporter.startFrameCache(options.cachePath, mesh, solver, options.encoding, options.queueDepth)) {
+        Logger::error("Failed to create cache: " + options.cachePath);
+        return 1;
+    }
+
+    Logger::info("Simulating " + std::to_string(options.frames) + " frames of " +
+                 std::to_string(positions.size()) + " vertices (" + std::to_string(pinned) + " pinned) on " +
+                 std::to_string(omp_get_max_threads()) + " threads");
+
+    double simulateSeconds = 0.0;
+    double publishSeconds = 0.0;
+    long long substeps = 0;
+    long long activeParticles = 0;
+    const auto runBegin = Clock::now();
+    for (int frame = 0; frame < options.frames; ++frame) {
+        const auto stepBegin = Clock::now();
+        solver.update(static_cast<Real>(options.dt));
+        simulateSeconds += secondsSince(stepBegin);
+        substeps += solver.getLastSubstepMetrics().substeps;
+        activeParticles += solver.getSleepStats().activeParticles;
+
+        if (exporter.isRunning()) {
+            const auto publishBegin = Clock::now();
+            if (!exporter.publish(solver, (frame + 1) * options.dt))
+                break;
+            publishSeconds += secondsSince(publishBegin);
+        }
+    }
+
+    const auto drainBegin = Clock::now();
+    const bool exported = exporter.finish();
+    const double drainSeconds = secondsSince(drainBegin);
+    const double runSeconds = secondsSince(runBegin);
+
+    std::printf("Phase timings (%d frames):\n", options.frames);
+    printPhase("load", loadSeconds, 0);
+    printPhase("build", buildSeconds, 0);
+    printPhase("simulate", simulateSeconds, options.frames);
+    if (options.frames > 0)
+        std::printf("    %-16s %10.2f per frame%s\n", "substeps", static_cast<double>(substeps) / options.frames,
+                    solver.getAdaptiveSubstepping().enabled ? " (adaptive)" : "");
+    if (options.frames > 0 && solver.getSleeping().enabled) {
+        const SleepStats sleep = solver.getSleepStats();
+        std::printf("    %-16s %10.1f per frame, %d active and %d sleeping at the end\n", "active particles",
+                    static_cast<double>(activeParticles) / options.frames, sleep.activeParticles,
+                    sleep.sleepingParticles);
+    }
+    const SolverStats& stats = solver.getStats();
+    for (int p = 0; p < SolverStats::kPhaseCount && stats.frames > 0; ++p) {
+        const SolverPhase phase = static_cast<SolverPhase>(p);
+        std::printf("    %-16s %10.3f s %10.3f ms/frame %10.4f ms/substep\n", SolverStats::phaseName(phase),
+                    1e-3 * stats.totalMs[p], stats.meanFrameMs(phase), stats.totalMs[p] / stats.substeps);
+    }
+    if (!options.cachePath.empty()) {
+        // publish() time is the copy into the export queue plus any wait for a free buffer.
+        printPhase("copy", publishSeconds - exporter.getStallSeconds(), options.frames);
+        printPhase("stall", exporter.getStallSeconds(), options.frames);
+        printPhase("drain", drainSeconds, 0);
+    }
+    printPhase("wall", loadSeconds + buildSeconds + runSeconds, 0);
+
+    if (!exported) {
+        Logger::error("Frame cache export failed after " + std::to_string(exporter.getWrittenCount()) + " frames");
+        return 2;
+    }
+    if (!options.cachePath.empty())
+        Logger::info("Wrote " + std::to_string(exporter.getWrittenCount()) + " frames to " + options.cachePath);
+    return 0;
+}
@@ -1,9 +1,15 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <tuple>
 
 #include "physics/Particle.hpp"
+#include "physics/ParticleBuffer.hpp"
 #include "physics/Constraint.hpp"
 #include "physics/DistanceConstraint.hpp"
 #include "physics/BendingConstraint.hpp"
@@ -11,9 +17,13 @@
 #include "physics/PlaneCollider.hpp"
 #include "physics/SphereCollider.hpp"
 #include "physics/Solver.hpp"
+#include "physics/BatchSolver.hpp"
 #include "engine/ClothMesh.hpp"
 #include "io/OBJLoader.hpp"
 #include "io/ConfigLoader.hpp"
+#include "io/SolverSnapshot.hpp"
+#include "io/FrameCache.hpp"
+#include "io/AsyncExporter.hpp"
 #include "utils/Logger.hpp"
 #include "math/Types.hpp"
 #include "Application.hpp"
@@ -22,6 +32,74 @@
 namespace py = pybind11;
 using namespace ClothSDK;
 
+namespace {
+
+// C-contiguous arrays of the right dtype are read in place; anything else is converted once.
+using RealArray = py::array_t<Real, py::array::c_style | py::array::forcecast>;
+using IndexArray = py::array_t<int, py::array::c_style | py::array::forcecast>;
+
+int rowsOf(const py::array& array, py::ssize_t columns, const char* name) {
+    if (array.ndim() != 2 || array.shape(1) != columns)
+        throw std::invalid_argument(std::string(name) + " must have shape (N, " + std::to_string(columns) + ")");
+    return static_cast<int>(array.shape(0));
+}
+
+void checkRows(const py::array& array, py::ssize_t columns, int count, const char* name) {
+    if (rowsOf(array, columns, name) != count)
+        throw std::invalid_argument(std::string(name) + " must have one row per particle (" + std::to_string(count) + ")");
+}
+
+void checkLength(const py::array& array, int count, const char* name) {
+    if (array.ndim() != 1 || array.shape(0) != count)
+        throw std::invalid_argument(std::string(name) + " must have shape (" + std::to_string(count) + ",)");
+}
+
+void checkParticleIds(const IndexArray& ids, const Solver& solver, const char* name) {
+    const int* data = ids.data();
+    const int count = static_cast<int>(solver.getParticles().size());
+    for (py::ssize_t i = 0; i < ids.size(); ++i) {
+        if (data[i] < 0 || data[i] >= count)
+            throw std::out_of_range(std::string(name) + " references particle " + std::to_string(data[i]) +
+                                    " but the solver holds " + std::to_string(count));
+    }
+}
+
+
+// Read-only view of solver memory: `columns` component arrays `stride` elements apart,
+// seen as an (N, columns) array, or (N,) when columns is 0. `owner` is kept alive by
+// the view, but the memory itself is only valid until the particle buffer is
+// reallocated, so only the explicit *_view methods hand these out.
+py::array particleView(const Real* data, int columns, const ParticleBuffer& particles, py::handle owner) {
+    const py::ssize_t count = static_cast<py::ssize_t>(particles.size());
+    const py::ssize_t item = static_cast<py::ssize_t>(sizeof(Real));
+    py::array_t<Real> view = columns == 0
+        ? py::array_t<Real>({count}, {item}, data, owner)
+        : py::array_t<Real>({count, py::ssize_t(columns)}, {item, static_cast<py::ssize_t>(particles.stride()) * item},
+                            data, owner);
+    view.attr("setflags")(py::arg("write") = false);
+    return view;
+}
+
+// Owning copy with the same layout as particleView().
+py::array particleCopy(const Real* data, int columns, const ParticleBuffer& particles) {
+    const py::ssize_t count = static_cast<py::ssize_t>(particles.size());
+    if (columns == 0) {
+        py::array_t<Real> copy(count);
+        std::copy_n(data, count, copy.mutable_data());
+        return copy;
+    }
+    py::array_t<Real> copy({count, py::ssize_t(columns)});
+    Real* out = copy.mutable_data();
+    for (int c = 0; c < columns; ++c) {
+        const Real* component = data + static_cast<size_t>(c) * particles.stride();
+        for (py::ssize_t i = 0; i < count; ++i)
+            out[i * columns + c] = component[i];
+    }
+    return copy;
+}
+
+}
+
 PYBIND11_MODULE(cloth_sdk, m) {
     m.doc() = "ClothSDK: Professional XPBD Simulation Engine";
 
@@ -32,7 +110,7 @@ PYBIND11_MODULE(cloth_sdk, m) {
         .def_readwrite("c", &Triangle::c);
 
     py::class_<Particle>(m, "Particle")
-        .def(py::init<const Eigen::Vector3d&>(), py::arg("initial_pos"))
+        .def(py::init<const Vector3r&>(), py::arg("initial_pos"))
         .def("get_position", &Particle::getPosition)
         .def("set_position", &Particle::setPosition)
         .def("get_inverse_mass", &Particle::getInverseMass)
@@ -40,43 +118,246 @@ PYBIND11_MODULE(cloth_sdk, m) {
         .def("add_force", &Particle::addForce)
         .def("integrate", &Particle::integrate);
 
+    py::class_<ParticleBuffer>(m, "ParticleBuffer")
+        .def(py::init<>())
+        .def(py::init<const std::vector<Particle>&>(), py::arg("particles"))
+        .def("add", &ParticleBuffer::add, py::arg("particle"))
+        .def("get_position", &ParticleBuffer::getPosition, py::arg("id"))
+        .def("set_position", &ParticleBuffer::setPosition, py::arg("id"), py::arg("position"))
+        .def("get_inverse_mass", &ParticleBuffer::getInverseMass, py::arg("id"))
+        .def("set_inverse_mass", &ParticleBuffer::setInverseMass, py::arg("id"), py::arg("inv_mass"))
+        .def("__len__", &ParticleBuffer::size)
+        .def("__getitem__", [](const ParticleBuffer& buffer, size_t i) {
+            if (i >= buffer.size()) throw py::index_error();
+            return buffer[i];
+        });
+
     py::class_<Constraint, std::unique_ptr<Constraint>>(m, "Constraint")
         .def("reset_lambda", &Constraint::resetLambda);
 
     py::class_<DistanceConstraint, Constraint, std::unique_ptr<DistanceConstraint>>(m, "DistanceConstraint")
-        .def(py::init<int, int, double, double>(), py::arg("idA"), py::arg("idB"), py::arg("restLength"), py::arg("compliance"));
+        .def(py::init<int, int, Real, Real>(), py::arg("idA"), py::arg("idB"), py::arg("restLength"), py::arg("compliance"));
 
     py::class_<BendingConstraint, Constraint, std::unique_ptr<BendingConstraint>>(m, "BendingConstraint")
-        .def(py::init<int, int, int, int, double, double>(), py::arg("idA"), py::arg("idB"), py::arg("idC"), py::arg("idD"), py::arg("restAngle"), py::arg("compliance"));
+        .def(py::init<int, int, int, int, Real, Real>(), py::arg("idA"), py::arg("idB"), py::arg("idC"), py::arg("idD"), py::arg("restAngle"), py::arg("compliance"));
 
     py::class_<Collider, std::unique_ptr<Collider>>(m, "Collider")
         .def("get_friction", &Collider::getFriction)
         .def("set_friction", &Collider::setFriction);
 
     py::class_<PlaneCollider, Collider, std::unique_ptr<PlaneCollider>>(m, "PlaneCollider")
-        .def(py::init<const Eigen::Vector3d&, const Eigen::Vector3d&, double>(), py::arg("origin"), py::arg("normal"), py::arg("friction"));
+        .def(py::init<const Vector3r&, const Vector3r&, Real>(), py::arg("origin"), py::arg("normal"), py::arg("friction"));
 
     py::class_<SphereCollider, Collider, std::unique_ptr<SphereCollider>>(m, "SphereCollider")
-        .def(py::init<const Eigen::Vector3d&, double, double>(), py::arg("center"), py::arg("radius"), py::arg("friction"));
+        .def(py::init<const Vector3r&, Real, Real>(), py::arg("center"), py::arg("radius"), py::arg("friction"));
+
+    py::class_<SpatialHashStats>(m, "SpatialHashStats")
+        .def_readonly("table_size", &SpatialHashStats::tableSize)
+        .def_readonly("particle_count", &SpatialHashStats::particleCount)
+        .def_readonly("occupied_buckets", &SpatialHashStats::occupiedBuckets)
+        .def_readonly("max_bucket_load", &SpatialHashStats::maxBucketLoad)
+        .def_readonly("mean_bucket_load", &SpatialHashStats::meanBucketLoad)
+        .def_readonly("build_time_ms", &SpatialHashStats::buildTimeMs)
+        .def_readonly("queries", &SpatialHashStats::queries)
+        .def_readonly("candidates", &SpatialHashStats::candidates)
+        .def_readonly("hash_collisions", &SpatialHashStats::hashCollisions)
+        .def_property_readonly("false_positive_rate", &SpatialHashStats::falsePositiveRate)
+        .def_property_readonly("false_positives_per_query", &SpatialHashStats::falsePositivesPerQuery);
 
     py::class_<SpatialHash>(m, "SpatialHash")
-    .def(py::init<int, double>(), py::arg("table_size"), py::arg("cell_size"))
+    .def(py::init<int, Real>(), py::arg("table_size"), py::arg("cell_size"))
+    .def(py::init<Real>(), py::arg("cell_size"))
     .def("build", &SpatialHash::build, py::arg("particles"))
     .def("query", &SpatialHash::query, 
-        py::arg("particles"), py::arg("pos"), py::arg("radius"), py::arg("out_neighbors"));
+        py::arg("particles"), py::arg("pos"), py::arg("radius"), py::arg("out_neighbors"))
+    .def("query_range", [](const SpatialHash& hash, const ParticleBuffer& particles, int begin, int end, Real radius) {
+            std::vector<int> offsets, neighbors;
+            hash.queryRange(particles, begin, end, radius, offsets, neighbors);
+            return py::make_tuple(offsets, neighbors);
+        }, py::arg("particles"), py::arg("begin"), py::arg("end"), py::arg("radius"))
+    .def("set_store_sorted_positions", &SpatialHash::setStoreSortedPositions, py::arg("enabled"))
+    .def("get_store_sorted_positions", &SpatialHash::getStoreSortedPositions)
+    .def("refresh_sorted_positions", &SpatialHash::refreshSortedPositions, py::arg("particles"))
+    .def("get_table_size", &SpatialHash::getTableSize)
+    .def("set_adaptive_table_size", &SpatialHash::setAdaptiveTableSize, py::arg("enabled"))
+    .def("set_collect_stats", &SpatialHash::setCollectStats, py::arg("enabled"))
+    .def("get_stats", &SpatialHash::getStats)
+    .def("reset_query_stats", &SpatialHash::resetQueryStats);
+
+    py::enum_<SolverPhase>(m, "SolverPhase")
+        .value("HASH_BUILD", SolverPhase::HashBuild)
+        .value("TOPOLOGY", SolverPhase::Topology)
+        .value("FORCES", SolverPhase::Forces)
+        .value("AERODYNAMICS", SolverPhase::Aerodynamics)
+        .value("PREDICT", SolverPhase::Predict)
+        .value("CONSTRAINTS", SolverPhase::Constraints)
+        .value("COLLIDERS", SolverPhase::Colliders)
+        .value("SELF_COLLISION", SolverPhase::SelfCollision)
+        .value("SUBSTEP_CONTROL", SolverPhase::SubstepControl)
+        .value("SLEEPING", SolverPhase::Sleeping);
+
+    py::class_<SolverStats>(m, "SolverStats")
+        .def_readonly_static("COMPILED_IN", &SolverStats::kCompiledIn)
+        .def_readonly("frames", &SolverStats::frames)
+        .def_readonly("substeps", &SolverStats::substeps)
+        .def_readonly("last_substeps", &SolverStats::lastSubsteps)
+        .def_readonly("last_update_ms", &SolverStats::lastUpdateMs)
+        .def_readonly("total_update_ms", &SolverStats::totalUpdateMs)
+        .def("frame_ms", &SolverStats::frameMs, py::arg("phase"))
+        .def("substep_ms", &SolverStats::substepMs, py::arg("phase"))
+        .def("mean_frame_ms", &SolverStats::meanFrameMs, py::arg("phase"))
+        .def("max_frame_ms", [](const SolverStats& self, SolverPhase phase) {
+            return self.maxFrameMs[static_cast<int>(phase)];
+        }, py::arg("phase"))
+        .def("as_dict", [](const SolverStats& self) {
+            py::dict phases;
+            for (int p = 0; p < SolverStats::kPhaseCount; ++p) {
+                const SolverPhase phase = static_cast<SolverPhase>(p);
+                py::dict entry;
+                entry["frame_ms"] = self.frameMs(phase);
+                entry["substep_ms"] = self.substepMs(phase);
+                entry["mean_frame_ms"] = self.meanFrameMs(phase);
+                entry["max_frame_ms"] = self.maxFrameMs[p];
+                phases[SolverStats::phaseName(phase)] = entry;
+            }
+            return phases;
+        }, "Per-phase timings keyed by phase name.");
+
+    py::class_<AdaptiveSubstepping>(m, "AdaptiveSubstepping")
+        .def(py::init<>())
+        .def_readwrite("enabled", &AdaptiveSubstepping::enabled)
+        .def_readwrite("min_substeps", &AdaptiveSubstepping::minSubsteps)
+        .def_readwrite("max_substeps", &AdaptiveSubstepping::maxSubsteps)
+        .def_readwrite("max_displacement", &AdaptiveSubstepping::maxDisplacement)
+        .def_readwrite("max_residual", &AdaptiveSubstepping::maxResidual)
+        .def_readwrite("relax_ratio", &AdaptiveSubstepping::relaxRatio);
+
+    py::class_<SubstepMetrics>(m, "SubstepMetrics")
+        .def_readonly("substeps", &SubstepMetrics::substeps)
+        .def_readonly("max_displacement", &SubstepMetrics::maxDisplacement)
+        .def_readonly("max_residual", &SubstepMetrics::maxResidual);
+
+    py::class_<TetherSettings>(m, "TetherSettings")
+        .def(py::init<>())
+        .def_readwrite("enabled", &TetherSettings::enabled)
+        .def_readwrite("stretch_limit", &TetherSettings::stretchLimit);
+
+    py::class_<SleepSettings>(m, "SleepSettings")
+        .def(py::init<>())
+        .def_readwrite("enabled", &SleepSettings::enabled)
+        .def_readwrite("velocity_threshold", &SleepSettings::velocityThreshold)
+        .def_readwrite("substeps", &SleepSettings::substeps);
+
+    py::class_<SleepStats>(m, "SleepStats")
+        .def_readonly("active_particles", &SleepStats::activeParticles)
+        .def_readonly("sleeping_particles", &SleepStats::sleepingParticles)
+        .def_readonly("islands", &SleepStats::islands)
+        .def_readonly("sleeping_islands", &SleepStats::sleepingIslands);
 
     py::class_<Solver, std::shared_ptr<ClothSDK::Solver>>(m, "Solver")
         .def(py::init<>())
-        .def("update", &Solver::update, py::arg("delta_time"))
+        // update() holds no Python state, so other threads (and other solvers) run meanwhile.
+        // The solver itself must not be used from another thread until it returns.
+        .def("update", &Solver::update, py::arg("delta_time"), py::call_guard<py::gil_scoped_release>())
+        .def("set_thread_count", &Solver::setThreadCount, py::arg("count"),
+             "Caps the OpenMP threads used by update(); 0 uses the default.")
+        .def("get_thread_count", &Solver::getThreadCount)
         .def("clear", &Solver::clear)
         .def("add_particle", &Solver::addParticle)
         .def("get_particles", &Solver::getParticles, py::return_value_policy::reference_internal)
+        .def("get_spatial_hash", &Solver::getSpatialHash, py::return_value_policy::reference_internal)
+        .def("set_collect_hash_stats", &Solver::setCollectHashStats, py::arg("enabled"))
+        .def("set_profiling_enabled", &Solver::setProfilingEnabled, py::arg("enabled"))
+        .def("is_profiling_enabled", &Solver::isProfilingEnabled)
+        .def("get_stats", &Solver::getStats, py::return_value_policy::copy)
+        .def("reset_stats", &Solver::resetStats)
         .def("set_gravity", &Solver::setGravity)
         .def("get_gravity", &Solver::getGravity)
         .def("set_substeps", &Solver::setSubsteps)
         .def("set_iterations", &Solver::setIterations)
+        .def("set_adaptive_substepping", &Solver::setAdaptiveSubstepping, py::arg("settings"))
+        .def("get_adaptive_substepping", &Solver::getAdaptiveSubstepping, py::return_value_policy::copy)
+        .def("get_last_substep_metrics", &Solver::getLastSubstepMetrics, py::return_value_policy::copy)
+        .def("get_current_substeps", &Solver::getCurrentSubsteps)
+        .def("set_tethers", &Solver::setTethers, py::arg("settings"))
+        .def("get_tethers", &Solver::getTethers, py::return_value_policy::copy)
+        .def("get_tether_count", [](const Solver& self) { return self.getTetherBatch().size(); })
+        .def("set_sleeping", &Solver::setSleeping, py::arg("settings"))
+        .def("get_sleeping", &Solver::getSleeping, py::return_value_policy::copy)
+        .def("get_sleep_stats", &Solver::getSleepStats)
         .def("add_distance_constraint", &Solver::addDistanceConstraint)
         .def("add_bending_constraint", &Solver::addBendingConstraint)
+        // pybind11 cannot move a unique_ptr out of a Python object, so the solver gets its own copy.
+        .def("add_constraint", [](Solver& self, const DistanceConstraint& constraint) {
+            self.addConstraint(std::make_unique<DistanceConstraint>(constraint));
+        }, py::arg("constraint"), "Adds a copy of the constraint; later changes to the Python object do not reach the solver.")
+        .def("add_constraint", [](Solver& self, const BendingConstraint& constraint) {
+            self.addConstraint(std::make_unique<BendingConstraint>(constraint));
+        }, py::arg("constraint"))
+        .def("add_particles", [](Solver& self, RealArray positions) {
+            const int count = rowsOf(positions, 3, "positions");
+            return self.addParticles(positions.data(), count);
+        }, py::arg("positions"), "Appends particles from an (N, 3) array and returns the id of the first one.")
+        .def("add_distance_constraints", [](Solver& self, IndexArray pairs, Real compliance) {
+            const int count = rowsOf(pairs, 2, "pairs");
+            checkParticleIds(pairs, self, "pairs");
+            self.addDistanceConstraints(pairs.data(), compliance, count);
+        }, py::arg("pairs"), py::arg("compliance"))
+        .def("add_distance_constraints", [](Solver& self, IndexArray pairs, RealArray compliances) {
+            const int count = rowsOf(pairs, 2, "pairs");
+            checkLength(compliances, count, "compliances");
+            checkParticleIds(pairs, self, "pairs");
+            self.addDistanceConstraints(pairs.data(), compliances.data(), count);
+        }, py::arg("pairs"), py::arg("compliances"))
+        .def("add_bending_constraints", [](Solver& self, IndexArray quads, RealArray restAngles, Real compliance) {
+            const int count = rowsOf(quads, 4, "quads");
+            checkLength(restAngles, count, "rest_angles");
+            checkParticleIds(quads, self, "quads");
+            self.addBendingConstraints(quads.data(), restAngles.data(), compliance, count);
+        }, py::arg("quads"), py::arg("rest_angles"), py::arg("compliance"))
+        .def("add_bending_constraints", [](Solver& self, IndexArray quads, RealArray restAngles, RealArray compliances) {
+            const int count = rowsOf(quads, 4, "quads");
+            checkLength(restAngles, count, "rest_angles");
+            checkLength(compliances, count, "compliances");
+            checkParticleIds(quads, self, "quads");
+            self.addBendingConstraints(quads.data(), restAngles.data(), compliances.data(), count);
+        }, py::arg("quads"), py::arg("rest_angles"), py::arg("compliances"))
+        .def("get_positions", [](const Solver& self) {
+            return particleCopy(self.getParticles().posX(), 3, self.getParticles());
+        }, "(N, 3) copy of the particle positions.")
+        .def("get_old_positions", [](const Solver& self) {
+            return particleCopy(self.getParticles().oldX(), 3, self.getParticles());
+        }, "(N, 3) copy of the previous positions.")
+        .def("get_inverse_masses", [](const Solver& self) {
+            return particleCopy(self.getParticles().invMass(), 0, self.getParticles());
+        }, "(N,) copy of the inverse masses.")
+        .def("get_positions_view", [](py::object self) {
+            const ParticleBuffer& particles = self.cast<const Solver&>().getParticles();
+            return particleView(particles.posX(), 3, particles, self);
+        }, "Read-only (N, 3) view of the particle positions, without copying.\n"
+           "The view tracks the simulation but points into solver storage: add_particles(), clear(),\n"
+           "build_from_mesh() and SolverSnapshot.load() reallocate it, after which reading the view is\n"
+           "undefined. Fetch a new view after any of them, or use get_positions().")
+        .def("get_old_positions_view", [](py::object self) {
+            const ParticleBuffer& particles = self.cast<const Solver&>().getParticles();
+            return particleView(particles.oldX(), 3, particles, self);
+        }, "Read-only (N, 3) view of the previous positions, without copying; same lifetime as get_positions_view().")
+        .def("get_inverse_masses_view", [](py::object self) {
+            const ParticleBuffer& particles = self.cast<const Solver&>().getParticles();
+            return particleView(particles.invMass(), 0, particles, self);
+        }, "Read-only (N,) view of the inverse masses, without copying; same lifetime as get_positions_view().")
+        .def("set_positions", [](Solver& self, RealArray positions) {
+            checkRows(positions, 3, static_cast<int>(self.getParticles().size()), "positions");
+            self.setPositions(positions.data());
+        }, py::arg("positions"), "Overwrites all positions from an (N, 3) array.")
+        .def("set_old_positions", [](Solver& self, RealArray positions) {
+            checkRows(positions, 3, static_cast<int>(self.getParticles().size()), "positions");
+            self.setOldPositions(positions.data());
+        }, py::arg("positions"), "Overwrites all previous positions from an (N, 3) array.")
+        .def("set_inverse_masses", [](Solver& self, RealArray inverseMasses) {
+            checkLength(inverseMasses, static_cast<int>(self.getParticles().size()), "inverse_masses");
+            self.setInverseMasses(inverseMasses.data());
+        }, py::arg("inverse_masses"), "Overwrites all inverse masses from an (N,) array.")
         .def("add_plane_collider", &Solver::addPlaneCollider)
         .def("add_sphere_collider", &Solver::addSphereCollider)
         .def("set_wind", &Solver::setWind)
@@ -85,17 +366,47 @@ PYBIND11_MODULE(cloth_sdk, m) {
         .def("set_collision_compliance", &Solver::setCollisionCompliance)
         .def("set_particle_inverse_mass", &Solver::setParticleInverseMass);
 
+    py::class_<BatchSolver>(m, "BatchSolver")
+        .def(py::init<int>(), py::arg("thread_count") = 0)
+        .def("add", &BatchSolver::add, py::arg("solver"), py::keep_alive<1, 2>())
+        .def("clear", &BatchSolver::clear)
+        .def("__len__", &BatchSolver::size)
+        .def("get_thread_count", &BatchSolver::getThreadCount)
+        .def("update", &BatchSolver::update, py::arg("delta_time"), py::arg("frames") = 1,
+             py::call_guard<py::gil_scoped_release>(),
+             "Steps every solver `frames` times, several scenes at once.");
+
+    m.def("simulate_many", [](const std::vector<std::shared_ptr<Solver>>& solvers, Real deltaTime, int frames,
+                              int threadCount) {
+        BatchSolver batch(threadCount);
+        for (const std::shared_ptr<Solver>& solver : solvers) {
+            if (!solver)
+                throw py::value_error("solvers must not contain None");
+            batch.add(*solver);
+        }
+        py::gil_scoped_release release;
+        batch.update(deltaTime, frames);
+    }, py::arg("solvers"), py::arg("delta_time"), py::arg("frames") = 1, py::arg("thread_count") = 0,
+       "Steps independent solvers concurrently on a pool of `thread_count` threads (0: OpenMP default).");
+
+    py::enum_<MeshOrdering>(m, "MeshOrdering")
+        .value("NONE", MeshOrdering::None)
+        .value("MORTON", MeshOrdering::Morton)
+        .value("REVERSE_CUTHILL_MCKEE", MeshOrdering::ReverseCuthillMcKee);
+
     py::class_<ClothMesh, std::shared_ptr<ClothSDK::ClothMesh>>(m, "ClothMesh")
         .def(py::init<>())
         .def("init_grid", &ClothMesh::initGrid)
         .def("build_from_mesh", &ClothMesh::buildFromMesh)
         .def("set_material", &ClothMesh::setMaterial)
+        .def("set_ordering", &ClothMesh::setOrdering, py::arg("ordering"))
+        .def("get_ordering", &ClothMesh::getOrdering)
         .def("export_to_obj", &ClothMesh::exportToOBJ)
         .def("get_particle_id", &ClothMesh::getParticleID, py::arg("row"), py::arg("col"));
 
     py::class_<OBJLoader>(m, "OBJLoader")
         .def_static("load", [](const std::string& path) {
-        std::vector<Eigen::Vector3d> pos;
+        std::vector<Vector3r> pos;
         std::vector<int> indices;
         bool success = ClothSDK::OBJLoader::load(path, pos, indices);
         
@@ -106,6 +417,64 @@ PYBIND11_MODULE(cloth_sdk, m) {
         .def_static("load", &ConfigLoader::load)
         .def_static("save", &ConfigLoader::save);
 
+    py::class_<SolverSnapshot>(m, "SolverSnapshot")
+        .def_static("save", &SolverSnapshot::save, py::arg("filepath"), py::arg("solver"))
+        .def_static("load", &SolverSnapshot::load, py::arg("filepath"), py::arg("solver"))
+        .def_readonly_static("VERSION", &SolverSnapshot::kVersion);
+
+    py::enum_<FrameEncoding>(m, "FrameEncoding")
+        .value("FLOAT32", FrameEncoding::Float32)
+        .value("FLOAT16", FrameEncoding::Float16)
+        .value("DELTA16", FrameEncoding::Delta16);
+
+    py::class_<FrameCacheWriter>(m, "FrameCacheWriter")
+        .def(py::init<>())
+        .def("open", &FrameCacheWriter::open, py::arg("filepath"), py::arg("mesh"), py::arg("solver"),
+             py::arg("encoding") = FrameEncoding::Float32)
+        .def("write_frame", &FrameCacheWriter::writeFrame, py::arg("solver"), py::arg("time"))
+        .def("close", &FrameCacheWriter::close)
+        .def("is_open", &FrameCacheWriter::isOpen)
+        .def("get_frame_count", &FrameCacheWriter::getFrameCount);
+
+    py::class_<FrameCacheReader>(m, "FrameCacheReader")
+        .def(py::init<>())
+        .def("open", &FrameCacheReader::open, py::arg("filepath"))
+        .def("close", &FrameCacheReader::close)
+        .def("is_open", &FrameCacheReader::isOpen)
+        .def("get_vertex_count", &FrameCacheReader::getVertexCount)
+        .def("get_frame_count", &FrameCacheReader::getFrameCount)
+        .def("get_encoding", &FrameCacheReader::getEncoding)
+        .def("get_frame_time", &FrameCacheReader::getFrameTime, py::arg("frame"))
+        .def("get_triangles", [](const FrameCacheReader& self) {
+            py::array_t<int32_t> triangles({static_cast<py::ssize_t>(self.getTriangleCount()), py::ssize_t(3)});
+            std::copy(self.getTriangles(), self.getTriangles() + 3 * self.getTriangleCount(), triangles.mutable_data());
+            return triangles;
+        })
+        .def("read_frame", [](const FrameCacheReader& self, int frame) {
+            std::vector<float> positions;
+            if (!self.readFrame(frame, positions))
+                throw py::index_error("frame " + std::to_string(frame) + " is out of range");
+            py::array_t<float> out({static_cast<py::ssize_t>(self.getVertexCount()), py::ssize_t(3)});
+            std::copy(positions.begin(), positions.end(), out.mutable_data());
+            return out;
+        }, py::arg("frame"), "Decodes a frame into a new (N, 3) float32 array.");
+
+    // publish() and finish() may wait on the writer thread; let other Python threads run meanwhile.
+    py::class_<AsyncExporter>(m, "AsyncExporter")
+        .def(py::init<>())
+        .def("start_frame_cache", &AsyncExporter::startFrameCache, py::arg("filepath"), py::arg("mesh"),
+             py::arg("solver"), py::arg("encoding") = FrameEncoding::Float32, py::arg("queue_depth") = 3)
+        .def("start_obj_sequence", &AsyncExporter::startObjSequence, py::arg("prefix"), py::arg("mesh"),
+             py::arg("queue_depth") = 3)
+        .def("publish", &AsyncExporter::publish, py::arg("solver"), py::arg("time"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("finish", &AsyncExporter::finish, py::call_guard<py::gil_scoped_release>())
+        .def("is_running", &AsyncExporter::isRunning)
+        .def("has_failed", &AsyncExporter::hasFailed)
+        .def("get_published_count", &AsyncExporter::getPublishedCount)
+        .def("get_written_count", &AsyncExporter::getWrittenCount)
+        .def("get_stall_seconds", &AsyncExporter::getStallSeconds);
+
     py::class_<Logger>(m, "Logger")
     .def_static("info", &Logger::info, py::arg("message"))
     .def_static("warn", &Logger::warn, py::arg("message"))
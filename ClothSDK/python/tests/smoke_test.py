@@ -0,0 +1,69 @@
+"""Smoke test of the cloth_sdk bindings, run by ctest as cloth_sdk.python_smoke.
+
+Exits with 77 (reported as skipped) when numpy is not installed.
+"""
+import sys
+
+try:
+    import numpy as np
+except ImportError:
+    print("numpy is not installed, skipping")
+    sys.exit(77)
+
+import cloth_sdk as sdk
+
+
+def make_solver():
+    solver = sdk.Solver()
+    solver.set_gravity([0.0, -9.81, 0.0])
+    positions = np.array([[0.0, 0.0, 0.0], [0.1, 0.0, 0.0], [0.2, 0.0, 0.0], [0.3, 0.0, 0.0]])
+    assert solver.add_particles(positions) == 0
+    solver.add_distance_constraints(np.array([[0, 1], [1, 2], [2, 3]]), 1e-9)
+    solver.add_constraint(sdk.DistanceConstraint(0, 3, 0.3, 1e-9))
+    solver.set_particle_inverse_mass(0, 0.0)
+    return solver, positions
+
+
+def test_positions():
+    solver, positions = make_solver()
+
+    copy = solver.get_positions()
+    assert copy.shape == (4, 3)
+    assert np.array_equal(copy, positions)
+
+    view = solver.get_positions_view()
+    assert view.shape == (4, 3)
+    assert not view.flags.writeable
+    assert np.array_equal(view, positions)
+
+    solver.set_positions(positions + 1.0)
+    assert np.array_equal(view, positions + 1.0)
+    assert np.array_equal(copy, positions)
+    assert np.array_equal(solver.get_positions(), positions + 1.0)
+
+    try:
+        solver.set_positions(np.zeros((3, 3)))
+    except ValueError:
+        pass
+    else:
+        raise AssertionError("set_positions accepted the wrong row count")
+
+
+def test_batch_update():
+    solvers = [make_solver()[0] for _ in range(3)]
+    batch = sdk.BatchSolver(2)
+    for solver in solvers:
+        batch.add(solver)
+    assert len(batch) == 3
+
+    batch.update(1.0 / 60.0, 2)
+    for solver in solvers:
+        positions = solver.get_positions()
+        assert positions[0, 1] == 0.0
+        assert positions[3, 1] < 0.0
+
+
+if __name__ == "__main__":
+    test_positions()
+    test_batch_update()
+    print("cloth_sdk smoke test passed")
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "engine/ClothMesh.hpp"
+#include "physics/Solver.hpp"
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+// Scenes and helpers shared by the unit tests.
+
+namespace ClothSDK {
+namespace Testing {
+
+/** @brief side x side grid, hanging vertically from its pinned top row. */
+inline void buildPinnedGrid(Solver& solver, ClothMesh& mesh, int side, Real spacing = 0.1) {
+    mesh.initGrid(side, side, spacing, solver);
+    for (int c = 0; c < side; ++c)
+        solver.setParticleInverseMass(mesh.getParticleID(side - 1, c), 0.0);
+}
+
+/**
+ * @brief Builds a scene with `setup`, steps it `frames` times at 60 Hz on `threads` OpenMP threads.
+ *
+ * The previous OpenMP thread count is restored before returning.
+ *
+ * @return Final particle positions.
+ */
+template <typename Setup>
+std::vector<Vector3r> simulateWithThreads(int threads, int frames, Setup setup) {
+    const int previousThreads = omp_get_max_threads();
+    omp_set_num_threads(threads);
+    Solver solver;
+    ClothMesh mesh;
+    setup(solver, mesh);
+    for (int frame = 0; frame < frames; ++frame)
+        solver.update(1.0 / 60.0);
+    omp_set_num_threads(previousThreads);
+
+    std::vector<Vector3r> positions;
+    for (const auto& p : solver.getParticles())
+        positions.push_back(p.getPosition());
+    return positions;
+}
+
+/** @return The whole file, empty if it cannot be opened. */
+inline std::vector<char> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+}
+}
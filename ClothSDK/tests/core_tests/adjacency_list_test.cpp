@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "physics/AdjacencyList.hpp"
+#include <vector>
+
+using namespace ClothSDK;
+
+TEST(AdjacencyListTest, SymmetricSortedAndDeduplicated) {
+    AdjacencyList adjacency;
+    adjacency.build(5, {{0, 3}, {3, 0}, {0, 1}, {2, 0}, {0, 1}, {4, 4}});
+
+    EXPECT_EQ(adjacency.degree(0), 3);
+    EXPECT_EQ(adjacency.degree(4), 0);
+    std::vector<int> row(adjacency.neighborsBegin(0), adjacency.neighborsEnd(0));
+    EXPECT_EQ(row, (std::vector<int>{1, 2, 3}));
+
+    EXPECT_TRUE(adjacency.contains(3, 0));
+    EXPECT_TRUE(adjacency.contains(0, 3));
+    EXPECT_TRUE(adjacency.contains(1, 0));
+    EXPECT_FALSE(adjacency.contains(1, 2));
+    EXPECT_FALSE(adjacency.contains(4, 4));
+}
+
+TEST(AdjacencyListTest, LongRowsUseBinarySearch) {
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 1; i < 100; i += 2)
+        edges.emplace_back(0, i);
+
+    AdjacencyList adjacency;
+    adjacency.build(100, edges);
+
+    EXPECT_EQ(adjacency.degree(0), 50);
+    for (int i = 1; i < 100; ++i)
+        EXPECT_EQ(adjacency.contains(0, i), i % 2 == 1);
+}
+
+TEST(AdjacencyListTest, OutOfRangeIsNotAdjacent) {
+    AdjacencyList adjacency;
+    EXPECT_FALSE(adjacency.contains(0, 1));
+
+    adjacency.build(2, {{0, 1}});
+    EXPECT_FALSE(adjacency.contains(7, 1));
+    adjacency.clear();
+    EXPECT_EQ(adjacency.getParticleCount(), 0);
+}
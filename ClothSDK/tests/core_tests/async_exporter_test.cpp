@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "TestScenes.hpp"
+#include "io/AsyncExporter.hpp"
+#include "io/FrameCache.hpp"
+#include "engine/ClothMesh.hpp"
+#include "physics/Solver.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+// Records what it receives and takes `delay` per frame, like a slow disk.
+class RecordingSink : public ExportSink {
+public:
+    RecordingSink(std::vector<int>& frames, std::chrono::milliseconds delay, int failAt = -1)
+        : m_frames(frames), m_delay(delay), m_failAt(failAt) {}
+
+    bool write(const float*, int frame, double) override {
+        std::this_thread::sleep_for(m_delay);
+        if (frame == m_failAt)
+            return false;
+        m_frames.push_back(frame);
+        return true;
+    }
+
+private:
+    std::vector<int>& m_frames;
+    std::chrono::milliseconds m_delay;
+    int m_failAt;
+};
+
+}
+
+TEST(AsyncExporterTest, FrameCacheMatchesSynchronousWriter) {
+    const std::string syncPath = ::testing::TempDir() + "sync.cache";
+    const std::string asyncPath = ::testing::TempDir() + "async.cache";
+
+    Solver solver;
+    ClothMesh mesh;
+    Testing::buildPinnedGrid(solver, mesh, 10);
+
+    FrameCacheWriter writer;
+    AsyncExporter exporter;
+    ASSERT_TRUE(writer.open(syncPath, mesh, solver, FrameEncoding::Delta16));
+    ASSERT_TRUE(exporter.startFrameCache(asyncPath, mesh, solver, FrameEncoding::Delta16, 2));
+
+    for (int frame = 0; frame < 15; ++frame) {
+        solver.update(1.0 / 60.0);
+        ASSERT_TRUE(writer.writeFrame(solver, (frame + 1) / 60.0));
+        ASSERT_TRUE(exporter.publish(solver, (frame + 1) / 60.0));
+    }
+    ASSERT_TRUE(writer.close());
+    ASSERT_TRUE(exporter.finish());
+    EXPECT_FALSE(exporter.isRunning());
+    EXPECT_EQ(exporter.getWrittenCount(), 15);
+
+    EXPECT_EQ(Testing::readFile(asyncPath), Testing::readFile(syncPath));
+    std::remove(syncPath.c_str());
+    std::remove(asyncPath.c_str());
+}
+
+TEST(AsyncExporterTest, SlowSinkAppliesBackpressureInOrder) {
+    Solver solver;
+    ClothMesh mesh;
+    Testing::buildPinnedGrid(solver, mesh, 10);
+
+    std::vector<int> frames;
+    AsyncExporter exporter;
+    ASSERT_TRUE(exporter.start(mesh, std::make_unique<RecordingSink>(frames, std::chrono::milliseconds(5)), 1));
+    for (int frame = 0; frame < 10; ++frame)
+        ASSERT_TRUE(exporter.publish(solver, frame));
+
+    // With a single buffer every publish after the first waits for the previous write.
+    EXPECT_GT(exporter.getStallSeconds(), 0.02);
+    ASSERT_TRUE(exporter.finish());
+
+    std::vector<int> expected(10);
+    for (int frame = 0; frame < 10; ++frame)
+        expected[frame] = frame;
+    EXPECT_EQ(frames, expected);
+    EXPECT_EQ(exporter.getPublishedCount(), 10);
+}
+
+TEST(AsyncExporterTest, FailedWriteStopsPublishing) {
+    Solver solver;
+    ClothMesh mesh;
+    Testing::buildPinnedGrid(solver, mesh, 10);
+
+    std::vector<int> frames;
+    AsyncExporter exporter;
+    ASSERT_TRUE(exporter.start(mesh, std::make_unique<RecordingSink>(frames, std::chrono::milliseconds(0), 2), 1));
+
+    bool accepted = true;
+    for (int frame = 0; frame < 50 && accepted; ++frame)
+        accepted = exporter.publish(solver, frame);
+
+    EXPECT_FALSE(accepted);
+    EXPECT_TRUE(exporter.hasFailed());
+    EXPECT_FALSE(exporter.finish());
+    EXPECT_EQ(frames, (std::vector<int>{0, 1}));
+}
+
+TEST(AsyncExporterTest, ObjSequenceWritesOneFilePerFrame) {
+    const std::string prefix = ::testing::TempDir() + "async_frame_";
+
+    Solver solver;
+    ClothMesh mesh;
+    Testing::buildPinnedGrid(solver, mesh, 10);
+
+    AsyncExporter exporter;
+    ASSERT_TRUE(exporter.startObjSequence(prefix, mesh));
+    for (int frame = 0; frame < 3; ++frame) {
+        solver.update(1.0 / 60.0);
+        ASSERT_TRUE(exporter.publish(solver, frame));
+    }
+    ASSERT_TRUE(exporter.finish());
+
+    for (int frame = 0; frame < 3; ++frame) {
+        const std::string path = prefix + "000" + std::to_string(frame) + ".obj";
+        std::ifstream file(path);
+        ASSERT_TRUE(file.is_open()) << path;
+
+        int vertices = 0, faces = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            vertices += line.rfind("v ", 0) == 0;
+            faces += line.rfind("f ", 0) == 0;
+        }
+        EXPECT_EQ(vertices, 100);
+        EXPECT_EQ(faces, 9 * 9 * 2);
+        file.close();
+        std::remove(path.c_str());
+    }
+}
+
+TEST(AsyncExporterTest, RejectsInvalidSetup) {
+    Solver solver;
+    ClothMesh mesh;
+    AsyncExporter exporter;
+    EXPECT_FALSE(exporter.startObjSequence("unused_", mesh));
+
+    Testing::buildPinnedGrid(solver, mesh, 10);
+    EXPECT_FALSE(exporter.start(mesh, nullptr));
+    EXPECT_FALSE(exporter.startObjSequence("unused_", mesh, 0));
+    EXPECT_FALSE(exporter.publish(solver, 0.0));
+}
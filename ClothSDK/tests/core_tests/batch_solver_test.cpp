@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "TestScenes.hpp"
+#include "physics/BatchSolver.hpp"
+#include "physics/Solver.hpp"
+#include "engine/ClothMesh.hpp"
+#include <memory>
+#include <omp.h>
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+// Grids of different sizes, so the batch reorders them by cost.
+void buildScene(Solver& solver, ClothMesh& mesh, int side) {
+    solver.setSubsteps(5);
+    Testing::buildPinnedGrid(solver, mesh, side);
+    solver.addSphereCollider(Vector3r(0.05 * side, -0.3, 0.05 * side), 0.2, 0.1);
+}
+
+}
+
+TEST(BatchSolverTest, MatchesSteppingEachSolverAlone) {
+    const int sides[] = {6, 12, 8, 10, 4};
+    const int sceneCount = 5;
+
+    std::vector<std::unique_ptr<Solver>> batched, reference;
+    std::vector<std::unique_ptr<ClothMesh>> meshes;
+    BatchSolver batch(3);
+    for (int s = 0; s < sceneCount; ++s) {
+        for (auto* solvers : {&batched, &reference}) {
+            solvers->push_back(std::make_unique<Solver>());
+            meshes.push_back(std::make_unique<ClothMesh>());
+            buildScene(*solvers->back(), *meshes.back(), sides[s]);
+        }
+        batch.add(*batched.back());
+        // With more scenes than threads every scene runs single-threaded.
+        reference.back()->setThreadCount(1);
+    }
+    ASSERT_EQ(batch.size(), 5u);
+
+    batch.update(1.0 / 60.0, 4);
+    batch.update(1.0 / 60.0);
+    for (auto& solver : reference) {
+        for (int frame = 0; frame < 5; ++frame)
+            solver->update(1.0 / 60.0);
+    }
+
+    for (int s = 0; s < sceneCount; ++s) {
+        const ParticleBuffer& a = batched[s]->getParticles();
+        const ParticleBuffer& b = reference[s]->getParticles();
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); ++i)
+            EXPECT_EQ(a.getPosition(static_cast<int>(i)), b.getPosition(static_cast<int>(i))) << "scene " << s;
+    }
+}
+
+TEST(BatchSolverTest, EmptyBatchAndZeroFramesAreNoOps) {
+    BatchSolver batch(2);
+    batch.update(1.0 / 60.0);
+
+    Solver solver;
+    ClothMesh mesh;
+    buildScene(solver, mesh, 4);
+    const Vector3r before = solver.getParticles().getPosition(0);
+    batch.add(solver);
+    batch.update(1.0 / 60.0, 0);
+    EXPECT_EQ(solver.getParticles().getPosition(0), before);
+
+    batch.clear();
+    EXPECT_EQ(batch.size(), 0u);
+}
+
+TEST(BatchSolverTest, ThreadBudgetsDoNotLeakIntoTheCaller) {
+    const int threads = omp_get_max_threads();
+
+    Solver solver;
+    ClothMesh mesh;
+    buildScene(solver, mesh, 4);
+    solver.setThreadCount(threads + 3);
+    solver.update(1.0 / 60.0);
+    EXPECT_EQ(omp_get_max_threads(), threads);
+    EXPECT_EQ(solver.getThreadCount(), threads + 3);
+
+    solver.setThreadCount(0);
+    BatchSolver batch(threads + 1);
+    batch.add(solver);
+    batch.update(1.0 / 60.0);
+    EXPECT_EQ(omp_get_max_threads(), threads);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "engine/ClothMesh.hpp"
+#include "engine/MeshReordering.hpp"
+#include "physics/Solver.hpp"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+// A side x side grid whose vertices are stored in shuffled order, like a scanned mesh.
+void shuffledGrid(int side, std::vector<Vector3r>& positions, std::vector<int>& indices) {
+    std::vector<int> slot(side * side);
+    for (int i = 0; i < side * side; ++i)
+        slot[i] = i;
+    std::shuffle(slot.begin(), slot.end(), std::mt19937(7));
+
+    positions.assign(side * side, Vector3r::Zero());
+    for (int r = 0; r < side; ++r)
+        for (int c = 0; c < side; ++c)
+            positions[slot[r * side + c]] = Vector3r(c * 0.1, r * 0.1, 0.0);
+
+    indices.clear();
+    for (int r = 0; r + 1 < side; ++r) {
+        for (int c = 0; c + 1 < side; ++c) {
+            int a = slot[r * side + c], b = slot[r * side + c + 1];
+            int d = slot[(r + 1) * side + c], e = slot[(r + 1) * side + c + 1];
+            indices.insert(indices.end(), {a, b, e, a, e, d});
+        }
+    }
+}
+
+std::vector<int> remap(const std::vector<int>& indices, const std::vector<int>& order) {
+    std::vector<int> rank(order.size());
+    for (size_t k = 0; k < order.size(); ++k)
+        rank[order[k]] = static_cast<int>(k);
+    std::vector<int> out(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        out[i] = rank[indices[i]];
+    return out;
+}
+
+bool isPermutation(std::vector<int> order, int count) {
+    std::sort(order.begin(), order.end());
+    for (int i = 0; i < count; ++i)
+        if (order[i] != i) return false;
+    return static_cast<int>(order.size()) == count;
+}
+
+}
+
+TEST(MeshReorderingTest, OrderingsAreReducingBandwidthPermutations) {
+    std::vector<Vector3r> positions;
+    std::vector<int> indices;
+    shuffledGrid(30, positions, indices);
+
+    const int original = MeshReordering::bandwidth(indices);
+    std::vector<int> rcm = MeshReordering::reverseCuthillMcKee(static_cast<int>(positions.size()), indices);
+    std::vector<int> morton = MeshReordering::morton(positions);
+
+    ASSERT_TRUE(isPermutation(rcm, 900));
+    ASSERT_TRUE(isPermutation(morton, 900));
+    EXPECT_LE(MeshReordering::bandwidth(remap(indices, rcm)), 40);
+    EXPECT_LT(MeshReordering::bandwidth(remap(indices, rcm)), original / 4);
+    EXPECT_LT(MeshReordering::bandwidth(remap(indices, morton)), original);
+}
+
+TEST(MeshReorderingTest, ReorderedMeshKeepsFileVertexMapping) {
+    std::vector<Vector3r> positions;
+    std::vector<int> indices;
+    shuffledGrid(12, positions, indices);
+
+    for (MeshOrdering ordering : {MeshOrdering::None, MeshOrdering::Morton, MeshOrdering::ReverseCuthillMcKee}) {
+        Solver solver;
+        ClothMesh mesh;
+        mesh.setOrdering(ordering);
+        mesh.buildFromMesh(positions, indices, solver);
+
+        const ParticleBuffer& particles = solver.getParticles();
+        ASSERT_EQ(particles.size(), positions.size());
+        for (size_t v = 0; v < positions.size(); ++v)
+            EXPECT_EQ(particles.getPosition(mesh.getParticleID(0, static_cast<int>(v))), positions[v]);
+
+        // 11x11 quads: 12*11*2 axis edges plus 121 diagonals; every non-boundary edge gets a bending pair.
+        const DistanceBatch& distances = solver.getDistanceBatch();
+        EXPECT_EQ(distances.size(), 12 * 11 * 2 + 121);
+        EXPECT_EQ(solver.getBendingBatch().size(), 12 * 11 * 2 + 121 - 4 * 11);
+
+        if (ordering != MeshOrdering::None) {
+            for (int k = 1; k < distances.size(); ++k)
+                EXPECT_LE(distances.idA()[k - 1], distances.idA()[k]);
+        }
+    }
+}
+
+TEST(MeshReorderingTest, ExportUsesFileVertexOrder) {
+    std::vector<Vector3r> positions;
+    std::vector<int> indices;
+    shuffledGrid(5, positions, indices);
+
+    Solver solver;
+    ClothMesh mesh;
+    mesh.setOrdering(MeshOrdering::ReverseCuthillMcKee);
+    mesh.buildFromMesh(positions, indices, solver);
+
+    const std::string path = ::testing::TempDir() + "reordered_export.obj";
+    mesh.exportToOBJ(path, solver);
+
+    std::ifstream file(path);
+    std::vector<Vector3r> exported;
+    std::vector<std::vector<int>> faces;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+        std::string tag;
+        in >> tag;
+        if (tag == "v") {
+            Real x, y, z;
+            in >> x >> y >> z;
+            exported.emplace_back(x, y, z);
+        } else if (tag == "f") {
+            int a, b, c;
+            in >> a >> b >> c;
+            faces.push_back({a - 1, b - 1, c - 1});
+        }
+    }
+
+    ASSERT_EQ(exported.size(), positions.size());
+    for (size_t v = 0; v < positions.size(); ++v)
+        EXPECT_TRUE(exported[v].isApprox(positions[v], Real(1e-5)) || positions[v].isZero());
+
+    // Every exported face must be one of the input triangles.
+    ASSERT_EQ(faces.size() * 3, indices.size());
+    for (const auto& face : faces) {
+        bool found = false;
+        for (size_t t = 0; t < indices.size() && !found; t += 3)
+            found = face[0] == indices[t] && face[1] == indices[t + 1] && face[2] == indices[t + 2];
+        EXPECT_TRUE(found);
+    }
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "physics/DistanceBatch.hpp"
+#include "physics/BendingBatch.hpp"
+#include "physics/DistanceConstraint.hpp"
+#include "physics/BendingConstraint.hpp"
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+ParticleBuffer makeWavyGrid(int n) {
+    ParticleBuffer particles;
+    for (int r = 0; r < n; ++r)
+        for (int c = 0; c < n; ++c)
+            particles.add(Particle(Vector3r(c * 0.1, r * 0.1, 0.02 * std::sin(r + 2.0 * c))));
+    return particles;
+}
+
+}
+
+TEST(ConstraintBatchTest, DistanceBatchMatchesPolymorphicConstraints) {
+    const int n = 8;
+    ParticleBuffer batched = makeWavyGrid(n);
+    ParticleBuffer reference = makeWavyGrid(n);
+
+    DistanceBatch batch;
+    std::vector<DistanceConstraint> constraints;
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c + 1 < n; ++c) {
+            int a = r * n + c;
+            batch.add(a, a + 1, 0.08, 1e-6);
+        }
+    }
+    batch.buildColoring(n * n);
+
+    for (int k = 0; k < batch.size(); ++k)
+        constraints.emplace_back(batch.idA()[k], batch.idB()[k], batch.restLength()[k], batch.compliance()[k]);
+
+    batch.solveRange(batched, 0.01, 0, batch.size());
+    for (auto& constraint : constraints)
+        constraint.solve(reference, 0.01);
+
+    for (int i = 0; i < n * n; ++i)
+        EXPECT_EQ(batched.getPosition(i), reference.getPosition(i));
+}
+
+TEST(ConstraintBatchTest, BendingBatchMatchesPolymorphicConstraints) {
+    const int n = 6;
+    ParticleBuffer batched = makeWavyGrid(n);
+    ParticleBuffer reference = makeWavyGrid(n);
+
+    BendingBatch batch;
+    for (int r = 0; r + 1 < n; ++r) {
+        for (int c = 0; c + 1 < n; ++c) {
+            int a = r * n + c;
+            batch.add(a, a + n + 1, a + 1, a + n, 0.0, 1e-4);
+        }
+    }
+    batch.buildColoring(n * n);
+
+    std::vector<BendingConstraint> constraints;
+    for (int k = 0; k < batch.size(); ++k)
+        constraints.emplace_back(batch.idA()[k], batch.idB()[k], batch.idC()[k], batch.idD()[k],
+                                 batch.restAngle()[k], batch.compliance()[k]);
+
+    batch.solveRange(batched, 0.01, 0, batch.size());
+    for (auto& constraint : constraints)
+        constraint.solve(reference, 0.01);
+
+    for (int i = 0; i < n * n; ++i)
+        EXPECT_EQ(batched.getPosition(i), reference.getPosition(i));
+}
+
+TEST(ConstraintBatchTest, ColoringKeepsConstraintsAndResetsLambda) {
+    ParticleBuffer particles = makeWavyGrid(4);
+    DistanceBatch batch;
+    for (int i = 0; i < 15; ++i)
+        batch.add(i, i + 1, 0.05, 0.0);
+
+    EXPECT_TRUE(batch.isColoringDirty());
+    batch.buildColoring(16);
+    EXPECT_FALSE(batch.isColoringDirty());
+    EXPECT_EQ(batch.getColorOffsets().back(), 15);
+
+    batch.solve(particles, 0.01);
+    bool anyLambda = false;
+    for (int k = 0; k < batch.size(); ++k)
+        anyLambda |= batch.lambda()[k] != 0.0;
+    EXPECT_TRUE(anyLambda);
+
+    batch.resetLambda();
+    for (int k = 0; k < batch.size(); ++k)
+        EXPECT_EQ(batch.lambda()[k], 0.0);
+}
+
+TEST(ConstraintBatchTest, SimdKernelsMatchScalarWithinTolerance) {
+    const int n = 40;
+    std::vector<SimdLevel> levels = {SimdLevel::AVX2, SimdLevel::AVX512};
+
+    for (SimdLevel level : levels) {
+        if (static_cast<int>(level) > static_cast<int>(detectSimdLevel()))
+            continue;
+
+        ParticleBuffer scalarParticles = makeWavyGrid(n);
+        ParticleBuffer simdParticles = makeWavyGrid(n);
+        scalarParticles.setInverseMass(0, 0.0);
+        simdParticles.setInverseMass(0, 0.0);
+        scalarParticles.setInverseMass(1, 0.0);
+        simdParticles.setInverseMass(1, 0.0);
+
+        DistanceBatch scalarBatch;
+        DistanceBatch simdBatch;
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                int a = r * n + c;
+                if (c + 1 < n) { scalarBatch.add(a, a + 1, 0.09, 1e-7); simdBatch.add(a, a + 1, 0.09, 1e-7); }
+                if (r + 1 < n) { scalarBatch.add(a, a + n, 0.11, 0.0); simdBatch.add(a, a + n, 0.11, 0.0); }
+            }
+        }
+        scalarBatch.buildColoring(n * n);
+        simdBatch.buildColoring(n * n);
+        scalarBatch.setSimdLevel(SimdLevel::Scalar);
+        simdBatch.setSimdLevel(level);
+        ASSERT_EQ(simdBatch.getSimdLevel(), level);
+
+        for (int iteration = 0; iteration < 4; ++iteration) {
+            scalarBatch.solve(scalarParticles, 1.0 / 600.0);
+            simdBatch.solve(simdParticles, 1.0 / 600.0);
+        }
+
+        for (int i = 0; i < n * n; ++i) {
+            EXPECT_NEAR(simdParticles.posX()[i], scalarParticles.posX()[i], 1e-12);
+            EXPECT_NEAR(simdParticles.posY()[i], scalarParticles.posY()[i], 1e-12);
+            EXPECT_NEAR(simdParticles.posZ()[i], scalarParticles.posZ()[i], 1e-12);
+        }
+        for (int k = 0; k < scalarBatch.size(); ++k)
+            EXPECT_NEAR(simdBatch.lambda()[k], scalarBatch.lambda()[k], 1e-12);
+    }
+}
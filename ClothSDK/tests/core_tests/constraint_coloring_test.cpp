@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "physics/ConstraintColoring.hpp"
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+void expectIndependentSets(const ConstraintColoring& coloring, const std::vector<int>& offsets,
+                           const std::vector<int>& ids, int particleCount) {
+    const auto& order = coloring.getOrder();
+    const auto& colorOffsets = coloring.getColorOffsets();
+
+    for (int color = 0; color < coloring.getColorCount(); ++color) {
+        std::vector<int> owner(particleCount, -1);
+        int previous = -1;
+        for (int k = colorOffsets[color]; k < colorOffsets[color + 1]; ++k) {
+            int c = order[k];
+            EXPECT_GT(c, previous);
+            previous = c;
+            for (int j = offsets[c]; j < offsets[c + 1]; ++j) {
+                EXPECT_EQ(owner[ids[j]], -1) << "particle " << ids[j] << " shared inside color " << color;
+                owner[ids[j]] = c;
+            }
+        }
+    }
+}
+
+}
+
+TEST(ConstraintColoringTest, ChainAlternatesTwoColors) {
+    std::vector<int> offsets = {0};
+    std::vector<int> ids;
+    for (int i = 0; i < 10; ++i) {
+        ids.push_back(i);
+        ids.push_back(i + 1);
+        offsets.push_back(static_cast<int>(ids.size()));
+    }
+
+    ConstraintColoring coloring;
+    coloring.build(offsets, ids, 11);
+
+    EXPECT_EQ(coloring.getColorCount(), 2);
+    EXPECT_EQ(coloring.getOrder().size(), 10);
+    expectIndependentSets(coloring, offsets, ids, 11);
+}
+
+TEST(ConstraintColoringTest, GridPartitionIsConflictFree) {
+    const int n = 12;
+    std::vector<int> offsets = {0};
+    std::vector<int> ids;
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c) {
+            int id = r * n + c;
+            if (c < n - 1) { ids.push_back(id); ids.push_back(id + 1); offsets.push_back(static_cast<int>(ids.size())); }
+            if (r < n - 1) { ids.push_back(id); ids.push_back(id + n); offsets.push_back(static_cast<int>(ids.size())); }
+            if (r < n - 1 && c < n - 1) {
+                ids.insert(ids.end(), {id, id + n + 1, id + 1, id + n});
+                offsets.push_back(static_cast<int>(ids.size()));
+            }
+        }
+    }
+
+    ConstraintColoring coloring;
+    coloring.build(offsets, ids, n * n);
+
+    EXPECT_EQ(coloring.getOrder().size(), offsets.size() - 1);
+    expectIndependentSets(coloring, offsets, ids, n * n);
+}
+
+TEST(ConstraintColoringTest, HubNeedsMoreThanSixtyFourColors) {
+    std::vector<int> offsets = {0};
+    std::vector<int> ids;
+    for (int i = 1; i <= 100; ++i) {
+        ids.push_back(0);
+        ids.push_back(i);
+        offsets.push_back(static_cast<int>(ids.size()));
+    }
+
+    ConstraintColoring coloring;
+    coloring.build(offsets, ids, 101);
+
+    EXPECT_EQ(coloring.getColorCount(), 100);
+    expectIndependentSets(coloring, offsets, ids, 101);
+}
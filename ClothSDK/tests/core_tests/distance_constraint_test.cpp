@@ -1,34 +1,33 @@
 #include <gtest/gtest.h>
 #include "physics/DistanceConstraint.hpp"
-#include "physics/Particle.hpp"
-#include <vector>
+#include "physics/ParticleBuffer.hpp"
 
 using namespace ClothSDK;
 
 TEST(DistanceConstraintTest, SolveBasicStiffness) {
-    std::vector<Particle> particles;
-    particles.emplace_back(Eigen::Vector3d(0.0, 0.0, 0.0));
-    particles.emplace_back(Eigen::Vector3d(2.0, 0.0, 0.0));
+    ParticleBuffer particles;
+    particles.add(Particle(Vector3r(0.0, 0.0, 0.0)));
+    particles.add(Particle(Vector3r(2.0, 0.0, 0.0)));
     
-    double restLength = 1.0;
-    double compliance = 0.0;
+    Real restLength = 1.0;
+    Real compliance = 0.0;
     DistanceConstraint constraint(0, 1, restLength, compliance);
     
-    double dt = 0.01;
+    Real dt = 0.01;
     
     constraint.solve(particles, dt);
     
-    double finalDist = (particles[0].getPosition() - particles[1].getPosition()).norm();
+    Real finalDist = (particles[0].getPosition() - particles[1].getPosition()).norm();
     
     EXPECT_NEAR(finalDist, 1.0, 1e-6);
 }
 
 TEST(DistanceConstraintTest, StaticParticleImmunity) {
-    std::vector<Particle> particles;
-    particles.emplace_back(Eigen::Vector3d(0.0, 0.0, 0.0));
-    particles.emplace_back(Eigen::Vector3d(2.0, 0.0, 0.0));
+    ParticleBuffer particles;
+    particles.add(Particle(Vector3r(0.0, 0.0, 0.0)));
+    particles.add(Particle(Vector3r(2.0, 0.0, 0.0)));
     
-    particles[0].setInverseMass(0.0); 
+    particles.setInverseMass(0, 0.0); 
     
     DistanceConstraint constraint(0, 1, 1.0, 0.0);
     constraint.solve(particles, 0.01);
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include "TestScenes.hpp"
+#include "io/FrameCache.hpp"
+#include "engine/ClothMesh.hpp"
+#include "physics/Solver.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+struct Recording {
+    std::vector<std::vector<float>> frames;
+    std::vector<float> rest;
+};
+
+// Simulates a pinned 10x10 cloth and caches every frame with `encoding`.
+Recording recordCloth(const std::string& path, FrameEncoding encoding, int frameCount) {
+    Solver solver;
+    ClothMesh mesh;
+    Testing::buildPinnedGrid(solver, mesh, 10);
+
+    Recording recording;
+    for (int id : mesh.getParticleIndices()) {
+        const Vector3r p = solver.getParticles().getPosition(id);
+        recording.rest.insert(recording.rest.end(), {float(p.x()), float(p.y()), float(p.z())});
+    }
+
+    FrameCacheWriter writer;
+    EXPECT_TRUE(writer.open(path, mesh, solver, encoding));
+    for (int frame = 0; frame < frameCount; ++frame) {
+        solver.update(1.0 / 60.0);
+        EXPECT_TRUE(writer.writeFrame(solver, (frame + 1) / 60.0));
+
+        std::vector<float> positions;
+        for (int id : mesh.getParticleIndices()) {
+            const Vector3r p = solver.getParticles().getPosition(id);
+            positions.insert(positions.end(), {float(p.x()), float(p.y()), float(p.z())});
+        }
+        recording.frames.push_back(positions);
+    }
+    EXPECT_TRUE(writer.close());
+    return recording;
+}
+
+float maxError(const std::vector<float>& a, const std::vector<float>& b) {
+    float error = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i)
+        error = std::max(error, std::abs(a[i] - b[i]));
+    return error;
+}
+
+}
+
+TEST(FrameCacheTest, Float32RoundTripsExactly) {
+    const std::string path = ::testing::TempDir() + "float32.cache";
+    Recording recording = recordCloth(path, FrameEncoding::Float32, 12);
+
+    FrameCacheReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.getVertexCount(), 100);
+    EXPECT_EQ(reader.getTriangleCount(), 9 * 9 * 2);
+    ASSERT_EQ(reader.getFrameCount(), 12);
+
+    std::vector<float> rest(reader.getRestPositions(), reader.getRestPositions() + 300);
+    EXPECT_EQ(rest, recording.rest);
+
+    // Random access, back to front.
+    std::vector<float> frame;
+    for (int f = 11; f >= 0; f -= 3) {
+        ASSERT_TRUE(reader.readFrame(f, frame));
+        EXPECT_EQ(frame, recording.frames[f]);
+        EXPECT_DOUBLE_EQ(reader.getFrameTime(f), (f + 1) / 60.0);
+    }
+    EXPECT_FALSE(reader.readFrame(12, frame));
+    reader.close();
+    std::remove(path.c_str());
+}
+
+TEST(FrameCacheTest, QuantizedEncodingsStayWithinTolerance) {
+    for (FrameEncoding encoding : {FrameEncoding::Float16, FrameEncoding::Delta16}) {
+        const std::string path = ::testing::TempDir() + "quantized.cache";
+        Recording recording = recordCloth(path, encoding, 20);
+
+        FrameCacheReader reader;
+        ASSERT_TRUE(reader.open(path));
+        ASSERT_EQ(reader.getFrameCount(), 20);
+        EXPECT_EQ(reader.getEncoding(), encoding);
+
+        std::vector<float> frame;
+        for (int f = 0; f < 20; ++f) {
+            ASSERT_TRUE(reader.readFrame(f, frame));
+            // The cloth spans about a meter: half floats keep ~1e-3, int16 steps ~1e-5 of the motion.
+            EXPECT_LT(maxError(frame, recording.frames[f]), encoding == FrameEncoding::Float16 ? 1e-3f : 1e-4f);
+        }
+        reader.close();
+        std::remove(path.c_str());
+    }
+}
+
+TEST(FrameCacheTest, FramesAreSmallerThanObjExport) {
+    const std::string cachePath = ::testing::TempDir() + "size.cache";
+    const std::string objPath = ::testing::TempDir() + "size.obj";
+
+    Solver solver;
+    ClothMesh mesh;
+    mesh.initGrid(10, 10, 0.1, solver);
+    solver.update(1.0 / 60.0);
+    mesh.exportToOBJ(objPath, solver);
+
+    FrameCacheWriter writer;
+    ASSERT_TRUE(writer.open(cachePath, mesh, solver, FrameEncoding::Delta16));
+    std::ifstream cacheFile(cachePath, std::ios::binary | std::ios::ate);
+    const auto topologyBytes = cacheFile.tellg();
+    cacheFile.close();
+
+    ASSERT_TRUE(writer.writeFrame(solver, 0.0));
+    ASSERT_TRUE(writer.close());
+    std::ifstream cacheAfter(cachePath, std::ios::binary | std::ios::ate);
+    std::ifstream objFile(objPath, std::ios::binary | std::ios::ate);
+    const auto frameBytes = cacheAfter.tellg() - topologyBytes;
+
+    EXPECT_LT(frameBytes, objFile.tellg() / 4);
+    std::remove(cachePath.c_str());
+    std::remove(objPath.c_str());
+}
+
+TEST(FrameCacheTest, UnclosedCacheRecoversFramesFromFileSize) {
+    const std::string path = ::testing::TempDir() + "unclosed.cache";
+    {
+        Solver solver;
+        ClothMesh mesh;
+        mesh.initGrid(4, 4, 0.1, solver);
+        FrameCacheWriter writer;
+        ASSERT_TRUE(writer.open(path, mesh, solver));
+        for (int f = 0; f < 5; ++f)
+            writer.writeFrame(solver, f);
+        // Flush the frames but leave the header count at zero, like a killed writer.
+        writer.close();
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offsetof(FrameCacheHeader, frameCount));
+        const uint64_t zero = 0;
+        file.write(reinterpret_cast<const char*>(&zero), sizeof(zero));
+    }
+
+    FrameCacheReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.getFrameCount(), 5);
+    EXPECT_DOUBLE_EQ(reader.getFrameTime(4), 4.0);
+    reader.close();
+    std::remove(path.c_str());
+}
+
+TEST(FrameCacheTest, RejectsForeignFiles) {
+    const std::string path = ::testing::TempDir() + "foreign.cache";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << std::string(200, 'x');
+    }
+
+    FrameCacheReader reader;
+    EXPECT_FALSE(reader.open(path));
+    EXPECT_FALSE(reader.isOpen());
+    EXPECT_FALSE(reader.open(path + ".missing"));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include "TestScenes.hpp"
+#include "physics/IslandSleeping.hpp"
+#include "physics/Solver.hpp"
+#include "engine/ClothMesh.hpp"
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+const Real kFrame = Real(1.0 / 60.0);
+
+// A straight chain of distance constraints along x at height y, at rest length.
+int addChain(Solver& solver, int count, Real y) {
+    std::vector<Real> positions;
+    std::vector<int> pairs;
+    const int first = static_cast<int>(solver.getParticles().size());
+    for (int i = 0; i < count; ++i) {
+        positions.insert(positions.end(), {Real(0.1) * i, y, Real(0)});
+        if (i > 0)
+            pairs.insert(pairs.end(), {first + i - 1, first + i});
+    }
+    solver.addParticles(positions.data(), count);
+    solver.addDistanceConstraints(pairs.data(), Real(1e-9), count - 1);
+    return first;
+}
+
+SleepSettings sleepAfter(int substeps) {
+    SleepSettings settings;
+    settings.enabled = true;
+    settings.substeps = substeps;
+    return settings;
+}
+
+}
+
+TEST(IslandSleepingTest, QuietIslandsSleepIndependently) {
+    ParticleBuffer particles;
+    const Real positions[18] = {0, 0, 0, 1, 0, 0, 2, 0, 0, 0, 1, 0, 1, 1, 0, 2, 1, 0};
+    particles.append(positions, 6, 1.0);
+    particles.posX()[4] += Real(1);     // The second island keeps a velocity.
+
+    IslandSleeping islands;
+    islands.build(6, {{0, 1}, {1, 2}, {3, 4}, {4, 5}}, {});
+    EXPECT_EQ(islands.getIslandCount(), 2);
+
+    const SleepSettings settings = sleepAfter(3);
+    EXPECT_FALSE(islands.update(particles, Real(0.01), settings));
+    EXPECT_FALSE(islands.update(particles, Real(0.01), settings));
+    EXPECT_TRUE(islands.update(particles, Real(0.01), settings));
+
+    const SleepStats stats = islands.getStats();
+    EXPECT_EQ(stats.sleepingIslands, 1);
+    EXPECT_EQ(stats.sleepingParticles, 3);
+    EXPECT_EQ(stats.activeParticles, 3);
+    EXPECT_FALSE(islands.isAwake(0));
+    EXPECT_TRUE(islands.isAwake(4));
+
+    std::vector<int32_t> state;
+    islands.getState(state);
+    IslandSleeping restored;
+    restored.build(6, {{0, 1}, {1, 2}, {3, 4}, {4, 5}}, {});
+    restored.setState(state.data());
+    EXPECT_EQ(restored.getStats().sleepingParticles, 3);
+    EXPECT_FALSE(restored.isAwake(2));
+
+    EXPECT_TRUE(islands.wakeParticle(2));
+    EXPECT_FALSE(islands.wakeParticle(2));
+    EXPECT_TRUE(islands.isAwake(0));
+    EXPECT_FALSE(islands.hasSleepingIslands());
+}
+
+TEST(IslandSleepingTest, RestlessIslandsNeverSleep) {
+    ParticleBuffer particles;
+    const Real positions[12] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0};
+    particles.append(positions, 4, 1.0);
+
+    IslandSleeping islands;
+    islands.build(4, {{0, 1}, {2, 3}}, {3});
+    for (int substep = 0; substep < 5; ++substep)
+        islands.update(particles, Real(0.01), sleepAfter(2));
+
+    EXPECT_FALSE(islands.isAwake(0));
+    EXPECT_TRUE(islands.isAwake(2));
+    EXPECT_TRUE(islands.isAwake(3));
+}
+
+TEST(IslandSleepingTest, RestingChainSleepsUntilAForceWakesIt) {
+    Solver solver;
+    addChain(solver, 16, 0);
+    solver.setGravity(Vector3r::Zero());
+    solver.setSubsteps(12);
+    solver.setSleeping(sleepAfter(10));
+
+    solver.update(kFrame);
+    SleepStats stats = solver.getSleepStats();
+    EXPECT_EQ(stats.islands, 1);
+    EXPECT_EQ(stats.sleepingParticles, 16);
+    EXPECT_EQ(stats.activeParticles, 0);
+    EXPECT_EQ(solver.getDistanceBatch().activeSize(), 0);
+
+    solver.setGravity(Vector3r(0, -9.81, 0));
+    EXPECT_EQ(solver.getSleepStats().activeParticles, 16);
+    EXPECT_EQ(solver.getDistanceBatch().activeSize(), 15);
+    solver.update(kFrame);
+    EXPECT_LT(solver.getParticles().getPosition(0).y(), 0.0);
+}
+
+TEST(IslandSleepingTest, SleepingIslandWakesWhenClothFallsOntoIt) {
+    Solver solver;
+    const int resting = addChain(solver, 8, 0);
+    const int falling = addChain(solver, 8, Real(0.2));
+    solver.setGravity(Vector3r::Zero());
+    solver.setWind(Vector3r::Zero());
+    solver.setSubsteps(12);
+
+    // The upper chain moves down at 3 m/s.
+    const Real substepDt = kFrame / 12;
+    std::vector<Real> old;
+    for (int i = 0; i < 16; ++i) {
+        const Vector3r p = solver.getParticles().getPosition(i);
+        old.insert(old.end(), {p.x(), i >= falling ? p.y() + 3 * substepDt : p.y(), p.z()});
+    }
+    solver.setOldPositions(old.data());
+    solver.setSleeping(sleepAfter(10));
+
+    solver.update(kFrame);
+    EXPECT_EQ(solver.getSleepStats().sleepingIslands, 1);
+    EXPECT_EQ(solver.getSleepStats().sleepingParticles, 8);
+
+    bool woke = false;
+    for (int frame = 0; frame < 10 && !woke; ++frame) {
+        solver.update(kFrame);
+        woke = solver.getSleepStats().sleepingParticles == 0;
+    }
+    EXPECT_TRUE(woke);
+
+    solver.update(kFrame);
+    EXPECT_LT(solver.getParticles().getPosition(resting + 3).y(), 0.0);
+}
+
+TEST(IslandSleepingTest, AwakeIslandsMatchDisabledSleeping) {
+    // A threshold of zero never lets the swinging grid sleep, so stepping must be unchanged.
+    Solver plain, sleeping;
+    ClothMesh plainMesh, sleepingMesh;
+    for (auto [solver, mesh] : {std::pair{&plain, &plainMesh}, std::pair{&sleeping, &sleepingMesh}}) {
+        Testing::buildPinnedGrid(*solver, *mesh, 8);
+        solver->setSubsteps(6);
+    }
+    SleepSettings settings = sleepAfter(1);
+    settings.velocityThreshold = 0;
+    sleeping.setSleeping(settings);
+
+    for (int frame = 0; frame < 20; ++frame) {
+        plain.update(kFrame);
+        sleeping.update(kFrame);
+    }
+    EXPECT_EQ(sleeping.getSleepStats().sleepingParticles, 0);
+    for (int i = 0; i < static_cast<int>(plain.getParticles().size()); ++i)
+        EXPECT_EQ(plain.getParticles().getPosition(i), sleeping.getParticles().getPosition(i));
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "engine/MeshTopology.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+// Grid of side x side vertices with shuffled labels, plus a fin triangle that makes
+// one edge non-manifold and a loose triangle whose edges are all on the boundary.
+std::vector<Triangle> testMesh(int side, int& vertexCount) {
+    std::vector<int> label(side * side);
+    for (int i = 0; i < side * side; ++i)
+        label[i] = i;
+    std::shuffle(label.begin(), label.end(), std::mt19937(3));
+
+    std::vector<Triangle> triangles;
+    for (int r = 0; r + 1 < side; ++r) {
+        for (int c = 0; c + 1 < side; ++c) {
+            int a = label[r * side + c], b = label[r * side + c + 1];
+            int d = label[(r + 1) * side + c], e = label[(r + 1) * side + c + 1];
+            triangles.emplace_back(a, b, e);
+            triangles.emplace_back(a, e, d);
+        }
+    }
+
+    const int fin = side * side;
+    const int loose = fin + 1;
+    triangles.emplace_back(label[0], label[side + 1], fin);
+    triangles.emplace_back(loose, loose + 1, loose + 2);
+    vertexCount = loose + 3;
+    return triangles;
+}
+
+}
+
+TEST(MeshTopologyTest, MatchesOrderedMapReference) {
+    int vertexCount = 0;
+    const std::vector<Triangle> triangles = testMesh(17, vertexCount);
+    const MeshTopology topology = MeshTopology::build(vertexCount, triangles);
+
+    std::map<std::pair<int, int>, std::vector<int>> reference;
+    std::vector<std::pair<int, int>> firstSeen;
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        const int v[3] = {triangles[t].a, triangles[t].b, triangles[t].c};
+        for (int e = 0; e < 3; ++e) {
+            std::pair<int, int> key(std::min(v[e], v[(e + 1) % 3]), std::max(v[e], v[(e + 1) % 3]));
+            if (reference.find(key) == reference.end())
+                firstSeen.push_back(key);
+            reference[key].push_back(static_cast<int>(t));
+        }
+    }
+
+    ASSERT_EQ(topology.edgeCount(), static_cast<int>(reference.size()));
+    ASSERT_EQ(topology.edgeTriangleOffsets.size(), reference.size() + 1);
+
+    int edge = 0;
+    int shared = 0;
+    for (const auto& [key, list] : reference) {
+        EXPECT_EQ(topology.edges[2 * edge], key.first);
+        EXPECT_EQ(topology.edges[2 * edge + 1], key.second);
+
+        std::vector<int> tris(topology.edgeTriangles.begin() + topology.edgeTriangleOffsets[edge],
+                              topology.edgeTriangles.begin() + topology.edgeTriangleOffsets[edge + 1]);
+        EXPECT_EQ(tris, list);
+
+        if (list.size() == 2) {
+            const int* d = &topology.dihedrals[4 * shared];
+            EXPECT_EQ(d[0], key.first);
+            EXPECT_EQ(d[1], key.second);
+            for (int k = 0; k < 2; ++k) {
+                const Triangle& t = triangles[list[k]];
+                const int opposite = d[2 + k];
+                EXPECT_TRUE(opposite == t.a || opposite == t.b || opposite == t.c);
+                EXPECT_NE(opposite, key.first);
+                EXPECT_NE(opposite, key.second);
+            }
+            ++shared;
+        }
+        ++edge;
+    }
+    EXPECT_EQ(topology.dihedralCount(), shared);
+
+    ASSERT_EQ(topology.discoveryOrder.size(), firstSeen.size());
+    for (size_t k = 0; k < firstSeen.size(); ++k) {
+        const int e = topology.discoveryOrder[k];
+        EXPECT_EQ(topology.edges[2 * e], firstSeen[k].first);
+        EXPECT_EQ(topology.edges[2 * e + 1], firstSeen[k].second);
+    }
+}
+
+TEST(MeshTopologyTest, NonManifoldEdgeHasNoDihedral) {
+    // Three triangles hinge on edge (0, 1); only the two-triangle edges bend.
+    std::vector<Triangle> triangles = {{0, 1, 2}, {1, 0, 3}, {0, 1, 4}, {1, 2, 5}};
+    const MeshTopology topology = MeshTopology::build(6, triangles);
+
+    ASSERT_EQ(topology.edges[0], 0);
+    ASSERT_EQ(topology.edges[1], 1);
+    EXPECT_EQ(topology.edgeTriangleOffsets[1] - topology.edgeTriangleOffsets[0], 3);
+
+    ASSERT_EQ(topology.dihedralCount(), 1);
+    EXPECT_EQ(topology.dihedrals, (std::vector<int>{1, 2, 0, 5}));
+}
+
+TEST(MeshTopologyTest, EmptyMesh) {
+    const MeshTopology topology = MeshTopology::build(4, {});
+    EXPECT_EQ(topology.edgeCount(), 0);
+    EXPECT_EQ(topology.dihedralCount(), 0);
+    ASSERT_EQ(topology.edgeTriangleOffsets.size(), 1u);
+    EXPECT_EQ(topology.edgeTriangleOffsets[0], 0);
+}
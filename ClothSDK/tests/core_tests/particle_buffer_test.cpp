@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "physics/ParticleBuffer.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace ClothSDK;
+
+TEST(ParticleBufferTest, AddStoresFullState) {
+    ParticleBuffer buffer;
+    Particle p(Vector3r(1.0, 2.0, 3.0));
+    p.setOldPosition(Vector3r(0.5, 1.5, 2.5));
+    p.setInverseMass(0.25);
+
+    int id = buffer.add(p);
+
+    EXPECT_EQ(id, 0);
+    EXPECT_EQ(buffer.size(), 1);
+    EXPECT_DOUBLE_EQ(buffer.posY()[id], 2.0);
+    EXPECT_DOUBLE_EQ(buffer.oldZ()[id], 2.5);
+    EXPECT_DOUBLE_EQ(buffer.getInverseMass(id), 0.25);
+
+    Particle snapshot = buffer[id];
+    EXPECT_DOUBLE_EQ(snapshot.getPosition().x(), 1.0);
+    EXPECT_DOUBLE_EQ(snapshot.getOldPosition().y(), 1.5);
+    EXPECT_DOUBLE_EQ(snapshot.getInverseMass(), 0.25);
+}
+
+TEST(ParticleBufferTest, GrowthPreservesComponents) {
+    ParticleBuffer buffer;
+    for (int i = 0; i < 100; ++i)
+        buffer.add(Particle(Vector3r(i, 2.0 * i, 3.0 * i)));
+
+    ASSERT_EQ(buffer.size(), 100);
+    EXPECT_GE(buffer.stride(), buffer.size());
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.posY()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.oldZ()) % 64, 0u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_DOUBLE_EQ(buffer.posX()[i], i);
+        EXPECT_DOUBLE_EQ(buffer.posY()[i], 2.0 * i);
+        EXPECT_DOUBLE_EQ(buffer.posZ()[i], 3.0 * i);
+        EXPECT_DOUBLE_EQ(buffer.oldZ()[i], 3.0 * i);
+    }
+}
+
+TEST(ParticleBufferTest, AppendAddsParticlesAtRest) {
+    ParticleBuffer buffer;
+    buffer.add(Particle(Vector3r(9.0, 9.0, 9.0)));
+
+    std::vector<Real> positions;
+    for (int i = 0; i < 20; ++i)
+        positions.insert(positions.end(), {Real(i), Real(2 * i), Real(3 * i)});
+
+    int first = buffer.append(positions.data(), 20, 0.5);
+
+    EXPECT_EQ(first, 1);
+    ASSERT_EQ(buffer.size(), 21);
+    EXPECT_DOUBLE_EQ(buffer.posX()[0], 9.0);
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_DOUBLE_EQ(buffer.posX()[first + i], i);
+        EXPECT_DOUBLE_EQ(buffer.posZ()[first + i], 3.0 * i);
+        EXPECT_DOUBLE_EQ(buffer.oldY()[first + i], 2.0 * i);
+        EXPECT_DOUBLE_EQ(buffer.accX()[first + i], 0.0);
+        EXPECT_DOUBLE_EQ(buffer.getInverseMass(first + i), 0.5);
+    }
+}
+
+TEST(ParticleBufferTest, ComponentArraysAreAligned) {
+    ParticleBuffer buffer;
+    buffer.reserve(13);
+
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.posX()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.posY()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.posZ()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.invMass()) % 64, 0u);
+}
+
+TEST(ParticleBufferTest, ForcesAndMassMatchParticle) {
+    Particle reference(Vector3r::Zero());
+    ParticleBuffer buffer;
+    int id = buffer.add(reference);
+
+    reference.addMass(1.0);
+    buffer.addMass(id, 1.0);
+    reference.addForce(Vector3r(4.0, 0.0, -2.0));
+    buffer.addForce(id, Vector3r(4.0, 0.0, -2.0));
+
+    EXPECT_DOUBLE_EQ(buffer.getInverseMass(id), reference.getInverseMass());
+    EXPECT_DOUBLE_EQ(buffer.getAcceleration(id).x(), reference.getAcceleration().x());
+    EXPECT_DOUBLE_EQ(buffer.getAcceleration(id).z(), reference.getAcceleration().z());
+}
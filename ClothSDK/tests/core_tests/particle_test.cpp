@@ -4,49 +4,52 @@
 
 using namespace ClothSDK;
 
+// Analytic results are exact in double; float builds round at ~1e-7 relative.
+static const Real kTolerance = sizeof(Real) == sizeof(float) ? 1e-6 : 1e-9;
+
 #define EXPECT_VECTOR3D_NEAR(v1, v2, tol) \
     EXPECT_NEAR(v1.x(), v2.x(), tol); \
     EXPECT_NEAR(v1.y(), v2.y(), tol); \
     EXPECT_NEAR(v1.z(), v2.z(), tol);
 
 TEST(ParticleTest, Initialization) {
-    Eigen::Vector3d pos(1.0, 2.0, 3.0);
+    Vector3r pos(1.0, 2.0, 3.0);
     Particle p(pos);
 
-    EXPECT_VECTOR3D_NEAR(p.getPosition(), pos, 1e-9);
-    EXPECT_VECTOR3D_NEAR(p.getOldPosition(), pos, 1e-9);
+    EXPECT_VECTOR3D_NEAR(p.getPosition(), pos, kTolerance);
+    EXPECT_VECTOR3D_NEAR(p.getOldPosition(), pos, kTolerance);
     EXPECT_DOUBLE_EQ(p.getInverseMass(), 1.0);
 }
 
 TEST(ParticleTest, AddForce) {
-    Particle p(Eigen::Vector3d::Zero());
+    Particle p(Vector3r::Zero());
     p.setInverseMass(0.5); 
     
-    p.addForce(Eigen::Vector3d(10.0, 0.0, 0.0));
-    EXPECT_VECTOR3D_NEAR(p.getAcceleration(), Eigen::Vector3d(5.0, 0.0, 0.0), 1e-9);
+    p.addForce(Vector3r(10.0, 0.0, 0.0));
+    EXPECT_VECTOR3D_NEAR(p.getAcceleration(), Vector3r(5.0, 0.0, 0.0), kTolerance);
     
     p.clearForces();
-    EXPECT_VECTOR3D_NEAR(p.getAcceleration(), Eigen::Vector3d::Zero(), 1e-9);
+    EXPECT_VECTOR3D_NEAR(p.getAcceleration(), Vector3r::Zero(), kTolerance);
 }
 
 TEST(ParticleTest, IntegrationMovement) {
-    Particle p(Eigen::Vector3d::Zero());
-    double dt = 0.1;
+    Particle p(Vector3r::Zero());
+    Real dt = 0.1;
     
-    p.addForce(Eigen::Vector3d(10.0, 0.0, 0.0));
+    p.addForce(Vector3r(10.0, 0.0, 0.0));
     
     p.integrate(dt);
     
-    EXPECT_NEAR(p.getPosition().x(), 0.1, 1e-9);
-    EXPECT_NEAR(p.getOldPosition().x(), 0.0, 1e-9); 
+    EXPECT_NEAR(p.getPosition().x(), 0.1, kTolerance);
+    EXPECT_NEAR(p.getOldPosition().x(), 0.0, kTolerance); 
 }
 
 TEST(ParticleTest, StaticParticle) {
-    Particle p(Eigen::Vector3d(1.0, 1.0, 1.0));
+    Particle p(Vector3r(1.0, 1.0, 1.0));
     p.setInverseMass(0.0); 
     
-    p.addForce(Eigen::Vector3d(0.0, -9.8, 0.0));
+    p.addForce(Vector3r(0.0, -9.8, 0.0));
     p.integrate(0.1);
     
-    EXPECT_VECTOR3D_NEAR(p.getPosition(), Eigen::Vector3d(1.0, 1.0, 1.0), 1e-9);
+    EXPECT_VECTOR3D_NEAR(p.getPosition(), Vector3r(1.0, 1.0, 1.0), kTolerance);
 }
\ No newline at end of file
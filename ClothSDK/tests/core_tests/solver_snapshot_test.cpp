@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include "TestScenes.hpp"
+#include "io/SolverSnapshot.hpp"
+#include "engine/ClothMesh.hpp"
+#include "physics/DistanceConstraint.hpp"
+#include "physics/Solver.hpp"
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ClothSDK;
+
+namespace {
+
+void buildScene(Solver& solver, ClothMesh& mesh) {
+    Testing::buildPinnedGrid(solver, mesh, 12);
+    solver.addPlaneCollider(Vector3r(0, -0.6, 0), Vector3r(0, 1, 0), 0.3);
+    solver.addSphereCollider(Vector3r(0.5, 0.3, 0.3), 0.25, 0.1);
+    solver.setWind(Vector3r(1.0, 0.0, 2.0));
+}
+
+SnapshotSectionEntry* findEntry(std::vector<uint64_t>& block, SnapshotSection id) {
+    char* raw = reinterpret_cast<char*>(block.data());
+    const auto* header = reinterpret_cast<const SnapshotHeader*>(raw);
+    auto* entries = reinterpret_cast<SnapshotSectionEntry*>(raw + sizeof(SnapshotHeader));
+    for (uint32_t i = 0; i < header->sectionCount; ++i) {
+        if (entries[i].id == static_cast<uint32_t>(id))
+            return &entries[i];
+    }
+    return nullptr;
+}
+
+void expectSameParticles(const ParticleBuffer& expected, const ParticleBuffer& actual) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual.posX()[i], expected.posX()[i]);
+        EXPECT_EQ(actual.posY()[i], expected.posY()[i]);
+        EXPECT_EQ(actual.posZ()[i], expected.posZ()[i]);
+        EXPECT_EQ(actual.oldY()[i], expected.oldY()[i]);
+        EXPECT_EQ(actual.getInverseMass(i), expected.getInverseMass(i));
+    }
+}
+
+}
+
+TEST(SolverSnapshotTest, ResumeMatchesUninterruptedRun) {
+    const std::string path = ::testing::TempDir() + "resume.snapshot";
+
+    Solver original;
+    ClothMesh mesh;
+    buildScene(original, mesh);
+    for (int frame = 0; frame < 10; ++frame)
+        original.update(1.0 / 60.0);
+
+    ASSERT_TRUE(SolverSnapshot::save(path, original));
+
+    Solver resumed;
+    resumed.addParticle(Particle(Vector3r(5, 5, 5)));
+    ASSERT_TRUE(SolverSnapshot::load(path, resumed));
+    EXPECT_EQ(resumed.getDistanceBatch().size(), original.getDistanceBatch().size());
+    EXPECT_EQ(resumed.getBendingBatch().getColorOffsets(), original.getBendingBatch().getColorOffsets());
+    expectSameParticles(original.getParticles(), resumed.getParticles());
+
+    for (int frame = 0; frame < 10; ++frame) {
+        original.update(1.0 / 60.0);
+        resumed.update(1.0 / 60.0);
+    }
+    expectSameParticles(original.getParticles(), resumed.getParticles());
+    std::remove(path.c_str());
+}
+
+TEST(SolverSnapshotTest, ResumesAdaptiveSubstepping) {
+    const std::string path = ::testing::TempDir() + "adaptive.snapshot";
+
+    Solver original;
+    ClothMesh mesh;
+    buildScene(original, mesh);
+    AdaptiveSubstepping settings;
+    settings.enabled = true;
+    settings.minSubsteps = 3;
+    settings.maxSubsteps = 40;
+    settings.maxResidual = 0.005;
+    original.setAdaptiveSubstepping(settings);
+    for (int frame = 0; frame < 10; ++frame)
+        original.update(1.0 / 60.0);
+
+    ASSERT_TRUE(SolverSnapshot::save(path, original));
+    Solver resumed;
+    ASSERT_TRUE(SolverSnapshot::load(path, resumed));
+    EXPECT_TRUE(resumed.getAdaptiveSubstepping().enabled);
+    EXPECT_EQ(resumed.getAdaptiveSubstepping().maxSubsteps, 40);
+    EXPECT_EQ(resumed.getAdaptiveSubstepping().maxResidual, settings.maxResidual);
+    EXPECT_EQ(resumed.getCurrentSubsteps(), original.getCurrentSubsteps());
+
+    for (int frame = 0; frame < 10; ++frame) {
+        original.update(1.0 / 60.0);
+        resumed.update(1.0 / 60.0);
+        EXPECT_EQ(resumed.getLastSubstepMetrics().substeps, original.getLastSubstepMetrics().substeps);
+    }
+    expectSameParticles(original.getParticles(), resumed.getParticles());
+    std::remove(path.c_str());
+}
+
+TEST(SolverSnapshotTest, ResumesSleepingIslands) {
+    const std::string path = ::testing::TempDir() + "sleeping.snapshot";
+
+    // Two chains: the lower one rests and sleeps, the upper one drifts sideways.
+    Solver original;
+    std::vector<Real> positions;
+    std::vector<int> pairs;
+    for (int i = 0; i < 16; ++i) {
+        positions.insert(positions.end(), {Real(0.1) * (i % 8), i < 8 ? Real(0) : Real(1), Real(0)});
+        if (i % 8 > 0)
+            pairs.insert(pairs.end(), {i - 1, i});
+    }
+    original.addParticles(positions.data(), 16);
+    original.addDistanceConstraints(pairs.data(), Real(1e-9), 14);
+    for (int i = 8; i < 16; ++i)
+        positions[3 * i] -= Real(0.01);
+    original.setOldPositions(positions.data());
+    original.setGravity(Vector3r::Zero());
+    original.setWind(Vector3r::Zero());
+    SleepSettings settings;
+    settings.enabled = true;
+    settings.substeps = 20;
+    settings.velocityThreshold = 0.1;
+    original.setSleeping(settings);
+    for (int frame = 0; frame < 3; ++frame)
+        original.update(1.0 / 60.0);
+    ASSERT_EQ(original.getSleepStats().sleepingParticles, 8);
+
+    ASSERT_TRUE(SolverSnapshot::save(path, original));
+    Solver resumed;
+    ASSERT_TRUE(SolverSnapshot::load(path, resumed));
+    EXPECT_TRUE(resumed.getSleeping().enabled);
+    EXPECT_EQ(resumed.getSleeping().substeps, 20);
+
+    for (int frame = 0; frame < 5; ++frame) {
+        original.update(1.0 / 60.0);
+        resumed.update(1.0 / 60.0);
+        EXPECT_EQ(resumed.getSleepStats().sleepingParticles, original.getSleepStats().sleepingParticles);
+    }
+    expectSameParticles(original.getParticles(), resumed.getParticles());
+    std::remove(path.c_str());
+}
+
+TEST(SolverSnapshotTest, RestoresFromMemoryBlock) {
+    const std::string path = ::testing::TempDir() + "memory.snapshot";
+
+    Solver original;
+    ClothMesh mesh;
+    buildScene(original, mesh);
+    original.update(1.0 / 60.0);
+    ASSERT_TRUE(SolverSnapshot::save(path, original));
+
+    // Stand-in for a mapped file: an 8-byte aligned copy of the bytes.
+    std::vector<char> bytes = Testing::readFile(path);
+    std::vector<uint64_t> block((bytes.size() + 7) / 8);
+    std::copy(bytes.begin(), bytes.end(), reinterpret_cast<char*>(block.data()));
+
+    Solver restored;
+    ASSERT_TRUE(SolverSnapshot::restore(block.data(), bytes.size(), restored));
+    expectSameParticles(original.getParticles(), restored.getParticles());
+    EXPECT_EQ(restored.getGravity(), original.getGravity());
+    EXPECT_EQ(restored.getWind(), original.getWind());
+    std::remove(path.c_str());
+}
+
+TEST(SolverSnapshotTest, RejectsDamagedSnapshotsWithoutTouchingSolver) {
+    const std::string path = ::testing::TempDir() + "damaged.snapshot";
+
+    Solver original;
+    ClothMesh mesh;
+    buildScene(original, mesh);
+    ASSERT_TRUE(SolverSnapshot::save(path, original));
+    std::vector<char> bytes = Testing::readFile(path);
+
+    Solver target;
+    target.addParticle(Particle(Vector3r(1, 2, 3)));
+
+    std::vector<uint64_t> block((bytes.size() + 7) / 8);
+    std::copy(bytes.begin(), bytes.end(), reinterpret_cast<char*>(block.data()));
+    EXPECT_FALSE(SolverSnapshot::restore(block.data(), bytes.size() / 2, target));
+
+    // A count whose byte size wraps around 64 bits.
+    SnapshotSectionEntry* colliders = findEntry(block, SnapshotSection::Colliders);
+    ASSERT_NE(colliders, nullptr);
+    const uint64_t colliderCount = colliders->count;
+    colliders->count += std::numeric_limits<uint64_t>::max() / colliders->elementSize + 1;
+    EXPECT_FALSE(SolverSnapshot::restore(block.data(), bytes.size(), target));
+    colliders->count = colliderCount;
+
+    char* raw = reinterpret_cast<char*>(block.data());
+    Real* colliderType = reinterpret_cast<Real*>(raw + colliders->offset);
+    *colliderType = Real(2);
+    EXPECT_FALSE(SolverSnapshot::restore(block.data(), bytes.size(), target));
+    *colliderType = Real(0);
+
+    raw[8] = 99;  // version
+    EXPECT_FALSE(SolverSnapshot::restore(block.data(), bytes.size(), target));
+
+    EXPECT_FALSE(SolverSnapshot::load(path + ".missing", target));
+
+    ASSERT_EQ(target.getParticles().size(), 1u);
+    EXPECT_EQ(target.getParticles().getPosition(0), Vector3r(1, 2, 3));
+    std::remove(path.c_str());
+}
+
+TEST(SolverSnapshotTest, RefusesCustomConstraints) {
+    const std::string path = ::testing::TempDir() + "custom.snapshot";
+
+    Solver solver;
+    int a = solver.addParticle(Particle(Vector3r(0, 0, 0)));
+    int b = solver.addParticle(Particle(Vector3r(1, 0, 0)));
+    solver.addConstraint(std::make_unique<DistanceConstraint>(a, b, 1.0, 0.0));
+
+    EXPECT_FALSE(SolverSnapshot::save(path, solver));
+}
@@ -1,15 +1,17 @@
 #include <gtest/gtest.h>
+#include "TestScenes.hpp"
 #include "physics/Solver.hpp"
+#include "engine/ClothMesh.hpp"
 #include <Eigen/Dense>
 
 using namespace ClothSDK;
 
 TEST(SolverTest, GravityAndSubsteps) {
     Solver solver;
-    solver.setGravity(Eigen::Vector3d(0, -10, 0));
+    solver.setGravity(Vector3r(0, -10, 0));
     solver.setSubsteps(5); 
     
-    int pId = solver.addParticle(Particle(Eigen::Vector3d(0, 10, 0)));
+    int pId = solver.addParticle(Particle(Vector3r(0, 10, 0)));
     
     solver.update(1.0);
     
@@ -19,10 +21,10 @@ TEST(SolverTest, GravityAndSubsteps) {
 
 TEST(SolverTest, PlaneCollision) {
     Solver solver;
-    solver.setGravity(Eigen::Vector3d(0, -10, 0));
-    solver.addPlaneCollider(Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(0, 1, 0), 0.0);
+    solver.setGravity(Vector3r(0, -10, 0));
+    solver.addPlaneCollider(Vector3r(0, 0, 0), Vector3r(0, 1, 0), 0.0);
     
-    int pId = solver.addParticle(Particle(Eigen::Vector3d(0, 0.5, 0)));
+    int pId = solver.addParticle(Particle(Vector3r(0, 0.5, 0)));
     
     for(int i = 0; i < 10; ++i) solver.update(0.1);
     
@@ -31,11 +33,11 @@ TEST(SolverTest, PlaneCollision) {
 
 TEST(SolverTest, AerodynamicsAppliesForce) {
     Solver solver;
-    solver.setGravity(Eigen::Vector3d::Zero()); 
+    solver.setGravity(Vector3r::Zero()); 
     
-    int a = solver.addParticle(Particle(Eigen::Vector3d(0, 0, 0)));
-    int b = solver.addParticle(Particle(Eigen::Vector3d(1, 0, 0)));
-    int c = solver.addParticle(Particle(Eigen::Vector3d(0, 1, 0)));
+    int a = solver.addParticle(Particle(Vector3r(0, 0, 0)));
+    int b = solver.addParticle(Particle(Vector3r(1, 0, 0)));
+    int c = solver.addParticle(Particle(Vector3r(0, 1, 0)));
     solver.addAeroFace(a, b, c);
     
     solver.update(0.01);
@@ -45,10 +47,282 @@ TEST(SolverTest, AerodynamicsAppliesForce) {
 
 TEST(SolverTest, ClearSystem) {
     Solver solver;
-    solver.addParticle(Particle(Eigen::Vector3d::Zero()));
-    solver.addPlaneCollider(Eigen::Vector3d::Zero(), Eigen::Vector3d::UnitY(), 0.0);
+    solver.addParticle(Particle(Vector3r::Zero()));
+    solver.addPlaneCollider(Vector3r::Zero(), Vector3r::UnitY(), 0.0);
     
     solver.clear();
     
     EXPECT_EQ(solver.getParticles().size(), 0);
-}
\ No newline at end of file
+}
+
+TEST(SolverTest, ColoredConstraintsAreThreadCountIndependent) {
+    auto scene = [](Solver& solver, ClothMesh& mesh) { Testing::buildPinnedGrid(solver, mesh, 24); };
+    auto serial = Testing::simulateWithThreads(1, 5, scene);
+    auto parallel = Testing::simulateWithThreads(4, 5, scene);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); ++i)
+        EXPECT_EQ(serial[i], parallel[i]);
+}
+
+TEST(SolverTest, SelfCollisionSeparatesLayersDeterministically) {
+    auto scene = [](Solver& solver, ClothMesh&) {
+        solver.setGravity(Vector3r::Zero());
+        solver.setAirDensity(0.0);
+        solver.setThickness(0.08);
+        for (int layer = 0; layer < 2; ++layer)
+            for (int r = 0; r < 10; ++r)
+                for (int c = 0; c < 10; ++c)
+                    solver.addParticle(Particle(Vector3r(c * 0.1, r * 0.1, layer * 0.03)));
+    };
+    auto serial = Testing::simulateWithThreads(1, 1, scene);
+    auto parallel = Testing::simulateWithThreads(3, 1, scene);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); ++i)
+        EXPECT_EQ(serial[i], parallel[i]);
+
+    Real gap = serial[100].z() - serial[0].z();
+    EXPECT_GT(gap, 0.03);
+}
+
+TEST(SolverTest, AerodynamicsIsThreadCountIndependent) {
+    auto scene = [](Solver& solver, ClothMesh& mesh) {
+        solver.setWind(Vector3r(0.0, 0.0, 15.0));
+        solver.setAirDensity(1.2);
+        Testing::buildPinnedGrid(solver, mesh, 32, 0.05);
+    };
+    auto serial = Testing::simulateWithThreads(1, 5, scene);
+    auto parallel = Testing::simulateWithThreads(3, 5, scene);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); ++i)
+        EXPECT_EQ(serial[i], parallel[i]);
+}
+
+TEST(SolverTest, ClearDropsAeroFaces) {
+    Solver solver;
+    solver.setGravity(Vector3r::Zero());
+    for (int i = 0; i < 3; ++i)
+        solver.addParticle(Particle(Vector3r(i, 0, 0)));
+    solver.addAeroFace(0, 1, 2);
+
+    solver.clear();
+    int a = solver.addParticle(Particle(Vector3r(0, 0, 0)));
+    solver.update(0.01);
+
+    EXPECT_EQ(solver.getParticles()[a].getPosition(), Vector3r(0, 0, 0));
+}
+
+TEST(SolverTest, BulkInsertionMatchesPerElementCalls) {
+    const int side = 6;
+    std::vector<Real> positions;
+    for (int r = 0; r < side; ++r)
+        for (int c = 0; c < side; ++c)
+            positions.insert(positions.end(), {Real(c * 0.1), Real(r * 0.1), Real(0.01 * ((r * c) % 3))});
+
+    std::vector<int> pairs;
+    std::vector<Real> compliances;
+    std::vector<int> quads;
+    std::vector<Real> restAngles;
+    for (int r = 0; r + 1 < side; ++r) {
+        for (int c = 0; c + 1 < side; ++c) {
+            int a = r * side + c, b = a + 1, d = a + side, e = d + 1;
+            pairs.insert(pairs.end(), {a, b, a, d, a, e});
+            compliances.insert(compliances.end(), {1e-6, 1e-6, 1e-4});
+            quads.insert(quads.end(), {a, e, b, d});
+            restAngles.push_back(0.1 * c);
+        }
+    }
+    const int pairCount = static_cast<int>(compliances.size());
+    const int quadCount = static_cast<int>(restAngles.size());
+
+    Solver single;
+    for (int i = 0; i < side * side; ++i)
+        single.addParticle(Particle(Vector3r(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2])));
+    for (int k = 0; k < pairCount; ++k)
+        single.addDistanceConstraint(pairs[2 * k], pairs[2 * k + 1], compliances[k]);
+    for (int k = 0; k < quadCount; ++k)
+        single.addBendingConstraint(quads[4 * k], quads[4 * k + 1], quads[4 * k + 2], quads[4 * k + 3], restAngles[k], 1e-3);
+
+    Solver bulk;
+    EXPECT_EQ(bulk.addParticles(positions.data(), side * side), 0);
+    bulk.addDistanceConstraints(pairs.data(), compliances.data(), pairCount);
+    bulk.addBendingConstraints(quads.data(), restAngles.data(), Real(1e-3), quadCount);
+
+    ASSERT_EQ(bulk.getDistanceBatch().size(), pairCount);
+    ASSERT_EQ(bulk.getBendingBatch().size(), quadCount);
+
+    for (int frame = 0; frame < 5; ++frame) {
+        single.update(1.0 / 60.0);
+        bulk.update(1.0 / 60.0);
+    }
+
+    const ParticleBuffer& expected = single.getParticles();
+    const ParticleBuffer& actual = bulk.getParticles();
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual.posX()[i], expected.posX()[i]);
+        EXPECT_EQ(actual.posY()[i], expected.posY()[i]);
+        EXPECT_EQ(actual.posZ()[i], expected.posZ()[i]);
+    }
+}
+
+TEST(SolverTest, ProfilingAggregatesPhasesPerFrameAndSubstep) {
+    Solver solver;
+    ClothMesh mesh;
+    mesh.initGrid(12, 12, 0.1, solver);
+    solver.setSubsteps(3);
+    solver.addPlaneCollider(Vector3r(0, -1, 0), Vector3r(0, 1, 0), 0.5);
+
+    solver.update(1.0 / 60.0);
+    EXPECT_EQ(solver.getStats().frames, 0);
+
+    solver.setProfilingEnabled(true);
+    if (!SolverStats::kCompiledIn) {
+        EXPECT_FALSE(solver.isProfilingEnabled());
+        GTEST_SKIP() << "built without CLOTHSDK_ENABLE_PROFILING";
+    }
+
+    for (int frame = 0; frame < 4; ++frame)
+        solver.update(1.0 / 60.0);
+
+    const SolverStats& stats = solver.getStats();
+    EXPECT_EQ(stats.frames, 4);
+    EXPECT_EQ(stats.substeps, 12);
+    EXPECT_EQ(stats.lastSubsteps, 3);
+    EXPECT_GT(stats.meanFrameMs(SolverPhase::Constraints), 0.0);
+    EXPECT_DOUBLE_EQ(stats.substepMs(SolverPhase::Constraints), stats.frameMs(SolverPhase::Constraints) / 3);
+
+    double phaseSum = 0.0;
+    for (int p = 0; p < SolverStats::kPhaseCount; ++p) {
+        EXPECT_GE(stats.maxFrameMs[p], stats.lastFrameMs[p]);
+        phaseSum += stats.totalMs[p];
+    }
+    EXPECT_LE(phaseSum, stats.totalUpdateMs);
+
+    solver.resetStats();
+    EXPECT_EQ(solver.getStats().frames, 0);
+    EXPECT_EQ(solver.getStats().totalMs[static_cast<int>(SolverPhase::Constraints)], 0.0);
+}
+
+TEST(SolverTest, BulkSettersOverwriteParticleState) {
+    Solver solver;
+    const Real initial[] = {0, 0, 0, 1, 0, 0, 2, 0, 0};
+    solver.addParticles(initial, 3);
+
+    const Real positions[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    const Real old[] = {1, 2, 2.5, 4, 5, 6, 7, 8, 9};
+    const Real inverseMasses[] = {0.5, 0.0, 2.0};
+    solver.setPositions(positions);
+    solver.setOldPositions(old);
+    solver.setInverseMasses(inverseMasses);
+
+    const ParticleBuffer& particles = solver.getParticles();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(particles.getPosition(i), Vector3r(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]));
+        EXPECT_EQ(particles.getOldPosition(i), Vector3r(old[3 * i], old[3 * i + 1], old[3 * i + 2]));
+        EXPECT_EQ(particles.getInverseMass(i), inverseMasses[i]);
+    }
+
+    // The component arrays the Python views expose are `stride` elements apart.
+    EXPECT_EQ(particles.posY(), particles.posX() + particles.stride());
+    EXPECT_EQ(particles.posZ(), particles.posX() + 2 * particles.stride());
+}
+
+TEST(SolverTest, AdaptiveSubstepControllerStaysWithinBounds) {
+    AdaptiveSubstepping settings;
+    settings.minSubsteps = 4;
+    settings.maxSubsteps = 20;
+
+    EXPECT_EQ(settings.nextSubsteps(10, 0.8), 10);
+    EXPECT_EQ(settings.nextSubsteps(10, 1.5), 15);
+    EXPECT_EQ(settings.nextSubsteps(10, 50.0), 20);
+    EXPECT_EQ(settings.nextSubsteps(8, 0.1), 6);
+    EXPECT_EQ(settings.nextSubsteps(5, 0.0), 4);
+    EXPECT_EQ(settings.nextSubsteps(4, 0.0), 4);
+}
+
+TEST(SolverTest, AdaptiveSubstepsRelaxWhenTheClothIsAtRest) {
+    // A chain of distance constraints at rest length with nothing acting on it.
+    Solver solver;
+    std::vector<Real> positions;
+    std::vector<int> pairs;
+    for (int i = 0; i < 16; ++i) {
+        positions.insert(positions.end(), {Real(0.1) * i, Real(0), Real(0)});
+        if (i > 0)
+            pairs.insert(pairs.end(), {i - 1, i});
+    }
+    solver.addParticles(positions.data(), 16);
+    solver.addDistanceConstraints(pairs.data(), Real(1e-9), 15);
+    solver.setGravity(Vector3r::Zero());
+    solver.setSubsteps(12);
+
+    AdaptiveSubstepping settings;
+    settings.enabled = true;
+    settings.minSubsteps = 3;
+    settings.maxSubsteps = 30;
+    solver.setAdaptiveSubstepping(settings);
+    EXPECT_EQ(solver.getCurrentSubsteps(), 12);
+
+    solver.update(1.0 / 60.0);
+    EXPECT_EQ(solver.getLastSubstepMetrics().substeps, 12);
+    EXPECT_LT(solver.getCurrentSubsteps(), 12);
+
+    for (int frame = 0; frame < 10; ++frame)
+        solver.update(1.0 / 60.0);
+    EXPECT_EQ(solver.getLastSubstepMetrics().substeps, 3);
+    EXPECT_LT(solver.getLastSubstepMetrics().maxDisplacement, 1e-9);
+}
+
+TEST(SolverTest, AdaptiveSubstepsRefineFastMotionWithinTheFrame) {
+    Solver solver;
+    ClothMesh mesh;
+    mesh.initGrid(8, 8, 0.1, solver);
+    solver.setGravity(Vector3r::Zero());
+    solver.setWind(Vector3r::Zero());
+    solver.setAirDensity(0.0);
+    solver.setSubsteps(4);
+
+    AdaptiveSubstepping settings;
+    settings.enabled = true;
+    settings.minSubsteps = 2;
+    settings.maxSubsteps = 16;
+    solver.setAdaptiveSubstepping(settings);
+    solver.update(1.0 / 60.0);
+
+    // 6 m/s sideways: 0.025 per quarter-frame substep, past the 0.02 allowed by the default thickness.
+    const ParticleBuffer& particles = solver.getParticles();
+    const Real substepDt = Real(1.0 / 60.0) / solver.getCurrentSubsteps();
+    std::vector<Real> old(3 * particles.size());
+    for (size_t i = 0; i < particles.size(); ++i) {
+        const Vector3r p = particles.getPosition(static_cast<int>(i));
+        old[3 * i] = p.x() - Real(6.0) * substepDt;
+        old[3 * i + 1] = p.y();
+        old[3 * i + 2] = p.z();
+    }
+    solver.setOldPositions(old.data());
+    solver.setSubsteps(4);
+    const Real startX = particles.getPosition(0).x();
+
+    solver.update(1.0 / 60.0);
+    const SubstepMetrics& metrics = solver.getLastSubstepMetrics();
+    EXPECT_GT(metrics.substeps, 4);
+    EXPECT_LE(metrics.substeps, 16);
+    EXPECT_GT(solver.getCurrentSubsteps(), 4);
+
+    // Rescaling the old positions keeps the velocity when the substep length changes.
+    EXPECT_NEAR(particles.getPosition(0).x() - startX, 0.1, 0.02);
+}
+
+TEST(SolverTest, FixedSubstepsReportTheirCount) {
+    Solver solver;
+    ClothMesh mesh;
+    mesh.initGrid(4, 4, 0.1, solver);
+    solver.setSubsteps(7);
+    solver.update(1.0 / 60.0);
+
+    EXPECT_EQ(solver.getLastSubstepMetrics().substeps, 7);
+    EXPECT_EQ(solver.getCurrentSubsteps(), 7);
+    EXPECT_EQ(solver.getLastSubstepMetrics().maxDisplacement, 0.0);
+}
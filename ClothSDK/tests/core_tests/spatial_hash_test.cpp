@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "physics/SpatialHash.hpp"
-#include "physics/Particle.hpp"
+#include "physics/ParticleBuffer.hpp"
+#include <omp.h>
+#include <cmath>
 #include <vector>
 
 using namespace ClothSDK;
@@ -8,12 +10,12 @@ using namespace ClothSDK;
 class SpatialHashTest : public ::testing::Test {
 protected:
     SpatialHash hash = SpatialHash(1000, 1.0);
-    std::vector<Particle> particles;
+    ParticleBuffer particles;
 };
 
 TEST_F(SpatialHashTest, FindsNeighborInSameCell) {
-    particles.push_back(Particle(Eigen::Vector3d(0.0, 0.0, 0.0)));
-    particles.push_back(Particle(Eigen::Vector3d(0.1, 0.0, 0.0)));
+    particles.add(Particle(Vector3r(0.0, 0.0, 0.0)));
+    particles.add(Particle(Vector3r(0.1, 0.0, 0.0)));
 
     hash.build(particles);
 
@@ -24,8 +26,8 @@ TEST_F(SpatialHashTest, FindsNeighborInSameCell) {
 }
 
 TEST_F(SpatialHashTest, FindsNeighborInAdjacentCell) {
-    particles.push_back(Particle(Eigen::Vector3d(0.9, 0.0, 0.0))); 
-    particles.push_back(Particle(Eigen::Vector3d(1.1, 0.0, 0.0))); 
+    particles.add(Particle(Vector3r(0.9, 0.0, 0.0))); 
+    particles.add(Particle(Vector3r(1.1, 0.0, 0.0))); 
 
     hash.build(particles);
 
@@ -36,8 +38,8 @@ TEST_F(SpatialHashTest, FindsNeighborInAdjacentCell) {
 }
 
 TEST_F(SpatialHashTest, FiltersOutParticlesBeyondRadius) {
-    particles.push_back(Particle(Eigen::Vector3d(0.0, 0.0, 0.0)));
-    particles.push_back(Particle(Eigen::Vector3d(0.9, 0.0, 0.0)));
+    particles.add(Particle(Vector3r(0.0, 0.0, 0.0)));
+    particles.add(Particle(Vector3r(0.9, 0.0, 0.0)));
 
     hash.build(particles);
 
@@ -50,7 +52,7 @@ TEST_F(SpatialHashTest, FiltersOutParticlesBeyondRadius) {
 
 TEST_F(SpatialHashTest, HandlesMultipleParticles) {
     for(int i = 0; i < 10; ++i) {
-        particles.push_back(Particle(Eigen::Vector3d(i * 0.1, 0.0, 0.0)));
+        particles.add(Particle(Vector3r(i * 0.1, 0.0, 0.0)));
     }
 
     hash.build(particles);
@@ -59,4 +61,174 @@ TEST_F(SpatialHashTest, HandlesMultipleParticles) {
     hash.query(particles, particles[5].getPosition(), 0.15, neighbors);
 
     EXPECT_EQ(neighbors.size(), 3);
-}
\ No newline at end of file
+}
+
+TEST_F(SpatialHashTest, ParallelBuildMatchesSerialLayout) {
+    for (int i = 0; i < 20000; ++i) {
+        double t = i * 0.37;
+        particles.add(Particle(Vector3r(std::sin(t) * 8.0, std::cos(t * 1.3) * 8.0, (i % 97) * 0.11)));
+    }
+
+    int previousThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    hash.build(particles);
+    std::vector<int> serialStart = hash.getCellStart();
+    std::vector<int> serialIndices = hash.getParticleIndices();
+
+    omp_set_num_threads(4);
+    hash.build(particles);
+    omp_set_num_threads(previousThreads);
+
+    EXPECT_EQ(hash.getCellStart(), serialStart);
+    EXPECT_EQ(hash.getParticleIndices(), serialIndices);
+
+    const std::vector<int>& start = hash.getCellStart();
+    const std::vector<int>& indices = hash.getParticleIndices();
+    ASSERT_EQ(start.back(), particles.size());
+    for (int h = 0; h < hash.getTableSize(); ++h) {
+        for (int k = start[h] + 1; k < start[h + 1]; ++k)
+            EXPECT_LT(indices[k - 1], indices[k]);
+    }
+}
+
+TEST_F(SpatialHashTest, RebuildAfterParticleCountChanges) {
+    for (int i = 0; i < 10; ++i)
+        particles.add(Particle(Vector3r(i * 0.1, 0.0, 0.0)));
+    hash.build(particles);
+
+    particles.clear();
+    particles.add(Particle(Vector3r(0.0, 0.0, 0.0)));
+    particles.add(Particle(Vector3r(0.05, 0.0, 0.0)));
+    hash.build(particles);
+
+    std::vector<int> neighbors;
+    hash.query(particles, particles[1].getPosition(), 0.1, neighbors);
+
+    EXPECT_EQ(neighbors.size(), 2);
+    EXPECT_EQ(hash.getCellStart().back(), 2);
+}
+
+TEST_F(SpatialHashTest, SortedPositionsMatchIndexedQuery) {
+    for (int i = 0; i < 500; ++i) {
+        double t = i * 0.91;
+        particles.add(Particle(Vector3r(std::sin(t) * 3.0, std::cos(t) * 3.0, (i % 13) * 0.2)));
+    }
+
+    SpatialHash sortedHash(1000, 1.0);
+    sortedHash.setStoreSortedPositions(true);
+    hash.build(particles);
+    sortedHash.build(particles);
+
+    std::vector<int> expected, actual, expectedOffsets, actualOffsets;
+    hash.queryRange(particles, 0, static_cast<int>(particles.size()), 0.7, expectedOffsets, expected);
+    sortedHash.queryRangeSorted(particles, 0, static_cast<int>(particles.size()), 0.7, actualOffsets, actual);
+    EXPECT_EQ(actualOffsets, expectedOffsets);
+    EXPECT_EQ(actual, expected);
+}
+
+TEST_F(SpatialHashTest, PublicQueriesIgnoreStaleSortedCopy) {
+    particles.add(Particle(Vector3r(0.0, 0.0, 0.0)));
+    particles.add(Particle(Vector3r(0.5, 0.0, 0.0)));
+    hash.setStoreSortedPositions(true);
+    hash.build(particles);
+
+    // Moved without a refresh: query() and queryRange() still see the buffer.
+    particles.setPosition(1, Vector3r(0.05, 0.0, 0.0));
+    std::vector<int> neighbors, offsets;
+    hash.query(particles, particles.getPosition(0), 0.1, neighbors);
+    EXPECT_EQ(neighbors.size(), 2u);
+    hash.queryRange(particles, 0, 1, 0.1, offsets, neighbors);
+    EXPECT_EQ(neighbors.size(), 2u);
+
+    // A buffer of another size invalidates the copy rather than gathering out of bounds.
+    particles.add(Particle(Vector3r(0.02, 0.0, 0.0)));
+    hash.refreshSortedPositions(particles);
+    hash.queryRangeSorted(particles, 0, 1, 0.1, offsets, neighbors);
+    EXPECT_EQ(neighbors.size(), 2u);
+}
+
+TEST_F(SpatialHashTest, RefreshSortedPositionsTracksMovedParticles) {
+    particles.add(Particle(Vector3r(0.0, 0.0, 0.0)));
+    particles.add(Particle(Vector3r(0.5, 0.0, 0.0)));
+    hash.setStoreSortedPositions(true);
+    hash.build(particles);
+
+    particles.setPosition(1, Vector3r(0.05, 0.0, 0.0));
+    hash.refreshSortedPositions(particles);
+
+    std::vector<int> neighbors, offsets;
+    hash.queryRangeSorted(particles, 0, 1, 0.1, offsets, neighbors);
+
+    EXPECT_EQ(neighbors.size(), 2);
+}
+
+TEST_F(SpatialHashTest, QueryRangeMatchesSingleQueries) {
+    for (int i = 0; i < 200; ++i)
+        particles.add(Particle(Vector3r((i % 20) * 0.1, (i / 20) * 0.1, 0.0)));
+
+    hash.setStoreSortedPositions(true);
+    hash.build(particles);
+
+    std::vector<int> offsets, batched, single;
+    hash.queryRange(particles, 50, 120, 0.15, offsets, batched);
+
+    ASSERT_EQ(offsets.size(), 71u);
+    for (int i = 50; i < 120; ++i) {
+        hash.query(particles, particles.getPosition(i), 0.15, single);
+        std::vector<int> slice(batched.begin() + offsets[i - 50], batched.begin() + offsets[i - 50 + 1]);
+        EXPECT_EQ(slice, single);
+    }
+}
+
+TEST(SpatialHashAdaptiveTest, TableGrowsWithParticleCount) {
+    SpatialHash adaptive(0.1);
+    ParticleBuffer particles;
+    for (int i = 0; i < 5000; ++i)
+        particles.add(Particle(Vector3r((i % 100) * 0.1, (i / 100) * 0.1, 0.0)));
+
+    adaptive.build(particles);
+
+    int size = adaptive.getTableSize();
+    EXPECT_EQ(size & (size - 1), 0);
+    EXPECT_GE(size, 2 * particles.size());
+    EXPECT_EQ(adaptive.getCellStart().back(), particles.size());
+
+    std::vector<int> neighbors;
+    adaptive.query(particles, particles.getPosition(150), 0.12, neighbors);
+    EXPECT_EQ(neighbors.size(), 5);
+}
+
+TEST(SpatialHashAdaptiveTest, StatsReportLoadsAndCollisions) {
+    SpatialHash adaptive(0.1);
+    SpatialHash undersized(256, 0.1);
+    adaptive.setCollectStats(true);
+    undersized.setCollectStats(true);
+    ParticleBuffer particles;
+    for (int i = 0; i < 4096; ++i)
+        particles.add(Particle(Vector3r((i % 64) * 0.1 + 0.05, (i / 64) * 0.1 + 0.05, 0.05)));
+
+    adaptive.build(particles);
+    undersized.build(particles);
+    std::vector<int> neighbors;
+    for (int i = 0; i < static_cast<int>(particles.size()); ++i) {
+        adaptive.query(particles, particles.getPosition(i), 0.1, neighbors);
+        undersized.query(particles, particles.getPosition(i), 0.1, neighbors);
+    }
+
+    SpatialHashStats stats = adaptive.getStats();
+    EXPECT_EQ(stats.particleCount, 4096);
+    EXPECT_EQ(stats.tableSize, adaptive.getTableSize());
+    EXPECT_GT(stats.occupiedBuckets, 0);
+    EXPECT_GE(stats.maxBucketLoad, 1);
+    EXPECT_NEAR(stats.meanBucketLoad, 4096.0 / stats.occupiedBuckets, 1e-12);
+    EXPECT_GE(stats.buildTimeMs, 0.0);
+    EXPECT_EQ(stats.queries, 4096);
+    EXPECT_GE(stats.candidates, stats.hashCollisions);
+
+    SpatialHashStats crowded = undersized.getStats();
+    EXPECT_GE(crowded.maxBucketLoad, stats.maxBucketLoad);
+    EXPECT_GT(crowded.falsePositivesPerQuery(), 4.0 * stats.falsePositivesPerQuery());
+
+    adaptive.resetQueryStats();
+    EXPECT_EQ(adaptive.getStats().queries, 0);
+}
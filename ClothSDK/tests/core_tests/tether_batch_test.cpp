@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "TestScenes.hpp"
+#include "physics/TetherBatch.hpp"
+#include "physics/Solver.hpp"
+#include "engine/ClothMesh.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace ClothSDK;
+
+static const Real kTolerance = sizeof(Real) == sizeof(float) ? 1e-6 : 1e-12;
+
+namespace {
+
+// A chain along x with spacing 0.1, free except for the given pins.
+void buildChain(ParticleBuffer& particles, DistanceBatch& distances, int count, const std::vector<int>& pins) {
+    std::vector<Real> positions;
+    for (int i = 0; i < count; ++i)
+        positions.insert(positions.end(), {Real(0.1) * i, Real(0), Real(0)});
+    particles.append(positions.data(), count, 1.0);
+    for (int pin : pins)
+        particles.setInverseMass(pin, 0.0);
+    for (int i = 1; i < count; ++i)
+        distances.add(i - 1, i, Real(0.1), Real(0));
+}
+
+// Lowest y of the bottom row of a 16 x 16 grid hanging from its top row.
+Real hangingGridBottom(bool tethers, int iterations) {
+    Solver solver;
+    ClothMesh mesh;
+    Testing::buildPinnedGrid(solver, mesh, 16);
+    solver.setWind(Vector3r::Zero());
+    solver.setIterations(iterations);
+    solver.setSubsteps(4);
+    TetherSettings settings;
+    settings.enabled = tethers;
+    solver.setTethers(settings);
+    for (int frame = 0; frame < 60; ++frame)
+        solver.update(1.0 / 60.0);
+
+    Real bottom = 0;
+    for (int c = 0; c < 16; ++c)
+        bottom = std::min(bottom, solver.getParticles().getPosition(mesh.getParticleID(0, c)).y());
+    return bottom;
+}
+
+}
+
+TEST(TetherBatchTest, AnchorsToTheGeodesicallyNearestPin) {
+    ParticleBuffer particles;
+    DistanceBatch distances;
+    buildChain(particles, distances, 6, {0, 5});
+
+    TetherBatch tethers;
+    tethers.build(particles, distances, 1.0);
+    ASSERT_EQ(tethers.size(), 4);
+    const int expectedAnchor[4] = {0, 0, 5, 5};
+    const Real expectedLength[4] = {0.1, 0.2, 0.2, 0.1};
+    for (int k = 0; k < 4; ++k) {
+        EXPECT_EQ(tethers.particle()[k], k + 1);
+        EXPECT_EQ(tethers.anchor()[k], expectedAnchor[k]);
+        EXPECT_NEAR(tethers.maxLength()[k], expectedLength[k], kTolerance);
+    }
+}
+
+TEST(TetherBatchTest, UnreachableParticlesStayFree) {
+    ParticleBuffer particles;
+    DistanceBatch distances;
+    buildChain(particles, distances, 3, {0});
+    const Real loose[3] = {5, 0, 0};
+    particles.append(loose, 1, 1.0);
+
+    TetherBatch tethers;
+    tethers.build(particles, distances, 1.5);
+    ASSERT_EQ(tethers.size(), 2);
+    EXPECT_NEAR(tethers.maxLength()[1], 0.3, kTolerance);
+}
+
+TEST(TetherBatchTest, OnlyPullsBackStretchedParticles) {
+    ParticleBuffer particles;
+    DistanceBatch distances;
+    buildChain(particles, distances, 3, {0});
+    TetherBatch tethers;
+    tethers.build(particles, distances, 1.0);
+
+    particles.posX()[1] = Real(0.05);
+    particles.posY()[2] = Real(-0.4);
+    tethers.solve(particles, nullptr);
+
+    EXPECT_EQ(particles.getPosition(1), Vector3r(0.05, 0, 0));
+    EXPECT_NEAR(particles.getPosition(2).norm(), 0.2, kTolerance);
+    EXPECT_NEAR(particles.getPosition(2).x() / particles.getPosition(2).y(), 0.2 / -0.4, kTolerance);
+
+    // Sleeping particles are left alone.
+    particles.posY()[2] = Real(-0.4);
+    const uint8_t awake[3] = {1, 1, 0};
+    tethers.solve(particles, awake);
+    EXPECT_EQ(particles.getPosition(2).y(), Real(-0.4));
+}
+
+TEST(TetherBatchTest, HangingClothStopsSaggingWithFewIterations) {
+    // The bottom row rests at y = 0, 1.5 below the pins; two iterations alone let the grid stretch well past it.
+    const Real loose = hangingGridBottom(false, 2);
+    const Real tethered = hangingGridBottom(true, 2);
+    EXPECT_LT(loose, -0.5);
+    EXPECT_GT(tethered, -0.01);
+}
+
+TEST(TetherBatchTest, RegeneratedWhenPinsChange) {
+    Solver solver;
+    ClothMesh mesh;
+    mesh.initGrid(4, 4, 0.1, solver);
+    TetherSettings settings;
+    settings.enabled = true;
+    solver.setTethers(settings);
+    solver.update(1.0 / 60.0);
+    EXPECT_EQ(solver.getTetherBatch().size(), 0);
+
+    solver.setParticleInverseMass(mesh.getParticleID(3, 0), 0.0);
+    solver.update(1.0 / 60.0);
+    EXPECT_EQ(solver.getTetherBatch().size(), 15);
+}
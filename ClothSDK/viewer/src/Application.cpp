@@ -237,6 +237,34 @@ void Application::drawUI() {
     if (ImGui::CollapsingHeader("Statistics", ImGuiTreeNodeFlags_DefaultOpen)) {
         ImGui::Text("Application FPS: %.1f", ImGui::GetIO().Framerate);
         ImGui::Text("Particles: %d", (int)m_solver->getParticles().size());
+
+        if (SolverStats::kCompiledIn) {
+            bool profiling = m_solver->isProfilingEnabled();
+            if (ImGui::Checkbox("Profile Solver Phases", &profiling)) {
+                m_solver->setProfilingEnabled(profiling);
+                m_solver->resetStats();
+            }
+
+            const SolverStats& stats = m_solver->getStats();
+            if (profiling && stats.frames > 0 &&
+                ImGui::BeginTable("SolverPhases", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                ImGui::TableSetupColumn("Phase");
+                ImGui::TableSetupColumn("ms/frame");
+                ImGui::TableSetupColumn("ms/substep");
+                ImGui::TableSetupColumn("mean ms/frame");
+                ImGui::TableHeadersRow();
+                for (int p = 0; p < SolverStats::kPhaseCount; ++p) {
+                    const SolverPhase phase = static_cast<SolverPhase>(p);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(SolverStats::phaseName(phase));
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.frameMs(phase));
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.substepMs(phase));
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.meanFrameMs(phase));
+                }
+                ImGui::EndTable();
+                ImGui::Text("Update: %.3f ms (%d substeps)", stats.lastUpdateMs, stats.lastSubsteps);
+            }
+        }
     }
 
     ImGui::SeparatorText("Playback");
@@ -249,7 +277,7 @@ void Application::drawUI() {
     if (ImGui::CollapsingHeader("Global Physics")) {
         static float gY = -9.81f;
         if (ImGui::SliderFloat("Gravity Y", &gY, -20.0f, 2.0f)) {
-            m_solver->setGravity(Eigen::Vector3d(0, gY, 0));
+            m_solver->setGravity(Vector3r(0, gY, 0));
         }
 
         static int subs = m_solver->getSubsteps();
@@ -257,6 +285,38 @@ void Application::drawUI() {
             if (subs < 1) subs = 1;
             m_solver->setSubsteps(subs);
         }
+
+        AdaptiveSubstepping adaptive = m_solver->getAdaptiveSubstepping();
+        bool adaptiveChanged = ImGui::Checkbox("Adaptive Substeps", &adaptive.enabled);
+        if (adaptive.enabled) {
+            adaptiveChanged |= ImGui::DragIntRange2("Substep Range", &adaptive.minSubsteps, &adaptive.maxSubsteps, 1.0f, 1, 200);
+            const SubstepMetrics& metrics = m_solver->getLastSubstepMetrics();
+            ImGui::Text("%d substeps, max move %.4f, residual %.4f",
+                        metrics.substeps, metrics.maxDisplacement, metrics.maxResidual);
+        }
+        if (adaptiveChanged)
+            m_solver->setAdaptiveSubstepping(adaptive);
+
+        TetherSettings tethers = m_solver->getTethers();
+        if (ImGui::Checkbox("Tethers", &tethers.enabled))
+            m_solver->setTethers(tethers);
+        if (tethers.enabled)
+            ImGui::Text("%d tethers", m_solver->getTetherBatch().size());
+
+        SleepSettings sleeping = m_solver->getSleeping();
+        bool sleepingChanged = ImGui::Checkbox("Sleeping", &sleeping.enabled);
+        if (sleeping.enabled) {
+            float threshold = static_cast<float>(sleeping.velocityThreshold);
+            if (ImGui::SliderFloat("Sleep Speed", &threshold, 0.001f, 0.5f, "%.3f")) {
+                sleeping.velocityThreshold = threshold;
+                sleepingChanged = true;
+            }
+            const SleepStats stats = m_solver->getSleepStats();
+            ImGui::Text("%d active, %d sleeping (%d/%d islands)", stats.activeParticles,
+                        stats.sleepingParticles, stats.sleepingIslands, stats.islands);
+        }
+        if (sleepingChanged)
+            m_solver->setSleeping(sleeping);
     }
 
     ImGui::End();
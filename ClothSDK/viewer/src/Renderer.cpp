@@ -46,13 +46,15 @@ void Renderer::render(const ClothSDK::Solver& solver, const Camera& camera) {
     const auto& particles = solver.getParticles();
     if (particles.empty()) return;
 
-    m_vertexBuffer.clear();
-    m_vertexBuffer.reserve(particles.size() * 3);
-    for (const auto& p : particles) {
-        Eigen::Vector3d pos = p.getPosition();
-        m_vertexBuffer.push_back(static_cast<float>(pos.x()));
-        m_vertexBuffer.push_back(static_cast<float>(pos.y()));
-        m_vertexBuffer.push_back(static_cast<float>(pos.z()));
+    const Real* px = particles.posX();
+    const Real* py = particles.posY();
+    const Real* pz = particles.posZ();
+
+    m_vertexBuffer.resize(particles.size() * 3);
+    for (size_t i = 0; i < particles.size(); ++i) {
+        m_vertexBuffer[3 * i + 0] = static_cast<float>(px[i]);
+        m_vertexBuffer[3 * i + 1] = static_cast<float>(py[i]);
+        m_vertexBuffer[3 * i + 2] = static_cast<float>(pz[i]);
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);